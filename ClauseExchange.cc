@@ -0,0 +1,97 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "ClauseExchange.h"
+
+using namespace openwbo;
+
+ClauseExchange::ClauseExchange(int threads, unsigned capacity)
+    : elems(capacity), head(0), tail(0), readers(threads, 0),
+      n_threads(threads), nb_pushed(0), nb_dropped(0) {}
+
+void ClauseExchange::removeOldest() {
+  assert(tail < head);
+  if (at(tail + 1) != 0)
+    nb_dropped++;
+  tail += at(tail) + header_size;
+}
+
+bool ClauseExchange::push(int thread, const vec<Lit> &clause) {
+  uint64_t need = clause.size() + header_size;
+  if (n_threads < 2 || need > elems.size())
+    return false;
+
+  std::lock_guard<std::mutex> guard(lock);
+  while (head + need - tail > elems.size())
+    removeOldest();
+
+  at(head) = clause.size();
+  at(head + 1) = n_threads - 1;
+  at(head + 2) = thread;
+  for (int i = 0; i < clause.size(); i++)
+    at(head + header_size + i) = toInt(clause[i]);
+  head += need;
+  nb_pushed++;
+  return true;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  pop : (thread : int) (clause : vec<Lit>&)  ->  [bool]
+  |
+  |  Description:
+  |
+  |    Skips the clauses of 'thread' and copies the next clause of another
+  |    thread into 'clause'. The clauses at the tail of the buffer that every
+  |    other thread has read are removed.
+  |
+  |________________________________________________________________________________________________@*/
+bool ClauseExchange::pop(int thread, vec<Lit> &clause) {
+  std::lock_guard<std::mutex> guard(lock);
+
+  uint64_t pos = readers[thread] < tail ? tail : readers[thread];
+  while (pos < head && at(pos + 2) == (uint32_t)thread)
+    pos += at(pos) + header_size;
+
+  if (pos == head) {
+    readers[thread] = pos;
+    return false;
+  }
+
+  int size = at(pos);
+  at(pos + 1)--;
+  clause.clear();
+  for (int i = 0; i < size; i++)
+    clause.push(NSPACE::toLit(at(pos + header_size + i)));
+  readers[thread] = pos + size + header_size;
+
+  while (tail < head && at(tail + 1) == 0)
+    removeOldest();
+  return true;
+}
@@ -0,0 +1,92 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ClauseExchange_h
+#define ClauseExchange_h
+
+#ifdef SIMP
+#include "simp/SimpSolver.h"
+#else
+#include "core/Solver.h"
+#endif
+
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+using NSPACE::vec;
+using NSPACE::Lit;
+
+namespace openwbo {
+
+/*! Lock-protected FIFO of clauses exchanged between threads.
+ *
+ * The design follows the 'ClausesBuffer' of glucose-syrup. Clauses are
+ * stored in a ring buffer of integers as [size, nbSeen, thread, lits...].
+ * Each thread reads the clauses of the other threads from its own position
+ * in the buffer. A clause is removed once every other thread has read it.
+ * When the buffer is full, the oldest clauses are dropped.
+ *
+ * Positions are absolute (they never wrap), so a thread whose position
+ * falls behind the oldest clause simply restarts from it. */
+class ClauseExchange {
+
+public:
+  // Buffer of 'capacity' integers shared by 'threads' threads.
+  ClauseExchange(int threads, unsigned capacity);
+
+  // Adds a clause of 'thread'. Returns false if it does not fit.
+  bool push(int thread, const vec<Lit> &clause);
+  // Gets the next clause of another thread. Returns false if there is none.
+  bool pop(int thread, vec<Lit> &clause);
+
+  uint64_t nPushed() { return nb_pushed; }
+  uint64_t nDropped() { return nb_dropped; }
+
+protected:
+  static const int header_size = 3;
+
+  uint32_t &at(uint64_t pos) { return elems[pos % elems.size()]; }
+  void removeOldest();
+
+  std::mutex lock;
+  std::vector<uint32_t> elems;
+  uint64_t head;                 // Position of the next clause.
+  uint64_t tail;                 // Position of the oldest clause.
+  std::vector<uint64_t> readers; // Position of each thread.
+  int n_threads;
+
+  // Statistics
+  uint64_t nb_pushed;  // Clauses added.
+  uint64_t nb_dropped; // Clauses removed before every thread read them.
+};
+
+} // namespace openwbo
+
+#endif
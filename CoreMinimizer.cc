@@ -0,0 +1,165 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "CoreMinimizer.h"
+#include "utils/System.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+using NSPACE::cpuTime;
+using namespace openwbo;
+
+// Solves with 'assumptions' and a conflict budget ('conflicts' < 0 means no
+// budget). The failed assumptions replace 'assumptions'.
+lbool CoreMinimizer::solve(SATBackend &S, vec<Lit> &assumptions,
+                           int64_t conflicts) {
+  nb_calls++;
+  for (int i = 0; i < assumptions.size(); i++)
+    S.assume(assumptions[i]);
+  if (conflicts >= 0)
+    S.limit(conflicts);
+
+  lbool res = S.solve();
+  if (res == l_False) {
+    int k = 0;
+    for (int i = 0; i < assumptions.size(); i++)
+      if (S.failed(assumptions[i]))
+        assumptions[k++] = assumptions[i];
+    assumptions.shrink(assumptions.size() - k);
+  }
+  return res;
+}
+
+// Solves again with the core as assumptions while the core shrinks.
+void CoreMinimizer::trim(SATBackend &S, vec<Lit> &core) {
+  vec<Lit> assumptions;
+  for (int r = 0; r < trim_rounds && core.size() > 1; r++) {
+    core.copyTo(assumptions);
+    if (solve(S, assumptions, -1) != l_False ||
+        assumptions.size() >= core.size())
+      return;
+    assumptions.copyTo(core);
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  minimize : (S : SATBackend &) (core : vec<Lit>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Destructive core minimization. Each literal of 'core' is removed in
+  |    turn and the remaining literals are solved as assumptions. If the call
+  |    is unsatisfiable the core becomes the new conflict, which also drops
+  |    the other literals that were not needed. Otherwise (satisfiable or out
+  |    of budget) the literal is kept.
+  |
+  |  Pre-conditions:
+  |    * 'core' are the assumptions of an unsatisfiable call of 'S'.
+  |
+  |________________________________________________________________________________________________@*/
+void CoreMinimizer::minimize(SATBackend &S, vec<Lit> &core) {
+  vec<Lit> assumptions;
+  int i = 0;
+  while (i < core.size() && core.size() > 1) {
+    assumptions.clear();
+    for (int j = 0; j < core.size(); j++)
+      if (j != i)
+        assumptions.push(core[j]);
+
+    if (solve(S, assumptions, budget) != l_False) {
+      i++;
+      continue;
+    }
+
+    // The failed assumptions keep the order of the core, so that the
+    // literals before 'i' are not tried again.
+    int next = 0;
+    for (int j = 0, k = 0; j < i; j++) {
+      if (k < assumptions.size() && assumptions[k] == core[j]) {
+        next++;
+        k++;
+      }
+    }
+    assumptions.copyTo(core);
+    i = next;
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  reduce : (S : SATBackend *)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Trims and minimizes the core in 'S->conflict()'.
+  |
+  |  Pre-conditions:
+  |    * The last call of 'S' was unsatisfiable.
+  |
+  |  Post-conditions:
+  |    * 'S->conflict()' is a subset of its previous value and the negation of
+  |      its literals is still unsatisfiable with the formula of 'S'.
+  |
+  |________________________________________________________________________________________________@*/
+void CoreMinimizer::reduce(SATBackend *S) {
+  if (!enabled() || S->conflict().size() <= 1)
+    return;
+
+  double start = cpuTime();
+  nb_cores++;
+  lits_before += S->conflict().size();
+
+  vec<Lit> core;
+  for (int i = 0; i < S->conflict().size(); i++)
+    core.push(~S->conflict()[i]);
+
+  trim(*S, core);
+  if (budget > 0)
+    minimize(*S, core);
+
+  S->conflict().clear();
+  for (int i = 0; i < core.size(); i++)
+    S->conflict().push(~core[i]);
+
+  lits_after += core.size();
+  time += cpuTime() - start;
+}
+
+void CoreMinimizer::printStats() {
+  if (!enabled())
+    return;
+
+  printf("c  Nb reduced cores:       %12d\n", nb_cores);
+  printf("c  Nb reduction SAT calls: %12d\n", nb_calls);
+  printf("c  Core literals removed:  %12" PRIu64 " / %" PRIu64 "\n",
+         lits_before - lits_after, lits_before);
+  printf("c  Core reduction time:    %12.2f s\n", time);
+}
@@ -0,0 +1,86 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef CoreMinimizer_h
+#define CoreMinimizer_h
+
+#include "SATBackend.h"
+
+#include <stdint.h>
+
+namespace openwbo {
+
+/*! Reduces the cores found by the SAT solver before they are relaxed.
+ *
+ * Trimming solves the formula again with the core as the only assumptions
+ * while the new core is smaller. Minimization then tries to drop each
+ * literal of the core: if the core without the literal is proven
+ * unsatisfiable within a conflict budget, the core is replaced by the new
+ * conflict. The reduced core is a subset of the original one, so the
+ * algorithms use it in place of 'SATBackend::conflict' without other
+ * changes.
+ *
+ * Both steps are disabled by default. */
+class CoreMinimizer {
+
+public:
+  CoreMinimizer()
+      : trim_rounds(0), budget(0), nb_cores(0), nb_calls(0), lits_before(0),
+        lits_after(0), time(0) {}
+
+  // Maximum number of trimming rounds for each core (0=off).
+  void setTrimRounds(int rounds) { trim_rounds = rounds; }
+  // Conflict budget of each SAT call of the minimization (0=off).
+  void setBudget(int conflicts) { budget = conflicts; }
+  bool enabled() { return trim_rounds > 0 || budget > 0; }
+
+  // Replaces 'S->conflict()' by a subset of it that is also a core.
+  void reduce(SATBackend *S);
+
+  void printStats();
+
+protected:
+  lbool solve(SATBackend &S, vec<Lit> &assumptions, int64_t conflicts);
+  void trim(SATBackend &S, vec<Lit> &core);
+  void minimize(SATBackend &S, vec<Lit> &core);
+
+  int trim_rounds;
+  int64_t budget;
+
+  // Statistics
+  int nb_cores;         // Number of reduced cores.
+  int nb_calls;         // Number of SAT calls.
+  uint64_t lits_before; // Sum of the sizes of the cores before reduction.
+  uint64_t lits_after;  // Sum of the sizes of the cores after reduction.
+  double time;          // Time spent reducing cores.
+};
+
+} // namespace openwbo
+
+#endif
@@ -0,0 +1,170 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "CostEvaluator.h"
+#include "mtl/Sort.h"
+
+using NSPACE::sort;
+
+using namespace openwbo;
+
+void CostEvaluator::reset() {
+  formula = NULL;
+  n_indexed = 0;
+  has_model = false;
+  occurrences.clear(true);
+  soft_vars.clear(true);
+  values.clear(true);
+  nb_true.clear(true);
+  unsat.clear(true);
+  unsat_pos.clear(true);
+  kernel.clear();
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  indexSoftClauses : [void] ->  [void]
+  |
+  |  Description:
+  |
+  |    Adds the occurrences of the soft clauses that were added to the formula
+  |    since the last call. If a model was already evaluated, the new soft
+  |    clauses are evaluated against it so that 'updateModel' can proceed
+  |    incrementally.
+  |
+  |________________________________________________________________________________________________@*/
+void CostEvaluator::indexSoftClauses() {
+  int n_soft = formula->nSoft();
+  if (n_indexed == n_soft)
+    return;
+
+  nb_true.growTo(n_soft, 0);
+  unsat_pos.growTo(n_soft, -1);
+
+  for (int i = n_indexed; i < n_soft; i++) {
+    ClauseView clause = formula->getSoftClause(i).clause;
+    for (int j = 0; j < clause.size(); j++) {
+      Var v = var(clause[j]);
+      if (v >= occurrences.size()) {
+        occurrences.growTo(v + 1);
+        values.growTo(v + 1, l_Undef);
+      }
+      if (occurrences[v].size() == 0)
+        soft_vars.push(v);
+      occurrences[v].push(mkLit(i, sign(clause[j])));
+
+      if (has_model && isTrue(clause[j], values[v]))
+        nb_true[i]++;
+    }
+
+    if (has_model && nb_true[i] == 0)
+      markUnsatisfied(i);
+  }
+
+  n_indexed = n_soft;
+}
+
+void CostEvaluator::fullScan(vec<lbool> &model) {
+  for (int i = 0; i < soft_vars.size(); i++) {
+    assert(soft_vars[i] < model.size());
+    values[soft_vars[i]] = model[soft_vars[i]];
+  }
+
+  kernel.update(formula);
+  packed.load(model);
+  kernel.evaluate(packed, unsat, &nb_true);
+  for (int i = 0; i < unsat.size(); i++)
+    unsat_pos[unsat[i]] = i;
+
+  has_model = true;
+}
+
+void CostEvaluator::updateModel(vec<lbool> &model) {
+  for (int i = 0; i < soft_vars.size(); i++) {
+    Var v = soft_vars[i];
+    assert(v < model.size());
+    lbool old_value = values[v];
+    lbool new_value = model[v];
+    if (new_value == old_value)
+      continue;
+
+    vec<Lit> &occs = occurrences[v];
+    for (int j = 0; j < occs.size(); j++) {
+      int soft = var(occs[j]);
+      Lit l = mkLit(v, sign(occs[j]));
+      bool was_true = isTrue(l, old_value);
+      bool is_true = isTrue(l, new_value);
+
+      if (was_true && !is_true) {
+        if (--nb_true[soft] == 0)
+          markUnsatisfied(soft);
+      } else if (!was_true && is_true) {
+        if (nb_true[soft]++ == 0)
+          markSatisfied(soft);
+      }
+    }
+    values[v] = new_value;
+  }
+}
+
+uint64_t CostEvaluator::cost(MaxSATFormula *maxsat_formula, vec<lbool> &model,
+                             uint64_t weight) {
+  assert(model.size() != 0);
+
+  if (formula != maxsat_formula) {
+    reset();
+    formula = maxsat_formula;
+  }
+
+  indexSoftClauses();
+
+  if (!has_model)
+    fullScan(model);
+  else
+    updateModel(model);
+
+  uint64_t currentCost = 0;
+  for (int i = 0; i < unsat.size(); i++) {
+    uint64_t w = formula->getSoftClause(unsat[i]).weight;
+    if (weight == UINT64_MAX || w == weight)
+      currentCost += w;
+  }
+
+  return currentCost;
+}
+
+void CostEvaluator::falsified(MaxSATFormula *maxsat_formula, vec<lbool> &model,
+                              vec<int> &falsified) {
+  assert(model.size() != 0);
+  falsified.clear();
+  kernel.update(maxsat_formula);
+  packed.load(model);
+  kernel.evaluate(packed, falsified);
+  sort(falsified);
+}
@@ -0,0 +1,122 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef CostEvaluator_h
+#define CostEvaluator_h
+
+#include "MaxSATFormula.h"
+#include "SoftKernel.h"
+
+using NSPACE::vec;
+using NSPACE::Lit;
+using NSPACE::lbool;
+using NSPACE::Var;
+
+namespace openwbo {
+
+/*! Incremental evaluation of the cost of models.
+ *
+ * The evaluator keeps, for each variable, the list of soft clauses where it
+ * occurs and, for each soft clause, the number of its literals satisfied by
+ * the last evaluated model. Evaluating a new model only visits the soft
+ * clauses of the variables whose value changed. The first model is evaluated
+ * with a full scan of the soft clauses by 'SoftKernel'.
+ *
+ * Soft clauses added to the formula after the first evaluation are indexed
+ * on the next call. Weights are read from the formula at each call, so they
+ * may be changed by the algorithms. */
+class CostEvaluator {
+
+public:
+  CostEvaluator() : formula(NULL), n_indexed(0), has_model(false) {}
+
+  // Returns the cost of 'model' for the soft clauses of 'maxsat_formula'. If
+  // 'weight' is different from UINT64_MAX then only soft clauses with that
+  // weight are considered.
+  uint64_t cost(MaxSATFormula *maxsat_formula, vec<lbool> &model,
+                uint64_t weight = UINT64_MAX);
+
+  // Soft clauses unsatisfied by the last evaluated model.
+  const vec<int> &unsatisfied() { return unsat; }
+
+  // Stores in 'falsified' the soft clauses of 'maxsat_formula' unsatisfied by
+  // 'model', in increasing order. Does not change the incremental state.
+  void falsified(MaxSATFormula *maxsat_formula, vec<lbool> &model,
+                 vec<int> &falsified);
+
+  // Clears all data structures.
+  void reset();
+
+protected:
+  // Indexes the soft clauses that were added since the last call.
+  void indexSoftClauses();
+
+  // Evaluates the first model by scanning all soft clauses.
+  void fullScan(vec<lbool> &model);
+
+  // Updates the satisfied counters with the variables that changed value.
+  void updateModel(vec<lbool> &model);
+
+  static inline bool isTrue(Lit l, lbool v) {
+    return (sign(l) && v == l_False) || (!sign(l) && v == l_True);
+  }
+
+  void markUnsatisfied(int soft) {
+    unsat_pos[soft] = unsat.size();
+    unsat.push(soft);
+  }
+
+  void markSatisfied(int soft) {
+    int pos = unsat_pos[soft];
+    unsat[pos] = unsat.last();
+    unsat_pos[unsat[pos]] = pos;
+    unsat.pop();
+    unsat_pos[soft] = -1;
+  }
+
+  MaxSATFormula *formula; // Formula of the indexed soft clauses.
+  int n_indexed;          // Number of indexed soft clauses.
+  bool has_model;         // True if a model was already evaluated.
+
+  vec<vec<Lit>> occurrences; // For each variable, the occurrences in soft
+                             // clauses. The literal 'mkLit(i, s)' represents
+                             // an occurrence in soft clause 'i' with sign 's'.
+  vec<Var> soft_vars;        // Variables that occur in soft clauses.
+  vec<lbool> values;         // Value of each variable in the last model.
+  vec<int> nb_true;          // Number of satisfied literals of each soft.
+  vec<int> unsat;            // Unsatisfied soft clauses.
+  vec<int> unsat_pos;        // Position in 'unsat' (-1 if satisfied).
+
+  SoftKernel kernel;  // Bulk evaluation of the soft clauses.
+  ModelBitset packed; // Last model given to 'kernel'.
+};
+
+} // namespace openwbo
+
+#endif
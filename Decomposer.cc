@@ -0,0 +1,401 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "Decomposer.h"
+#include "graph/Graph.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using NSPACE::OutOfMemoryException;
+using namespace openwbo;
+
+Decomposer::Decomposer(AlgorithmFactory factory, int threads, int verb)
+    : newAlgorithm(factory), n_threads(threads), next(0), unsat(false) {
+  verbosity = verb;
+}
+
+// Links consecutive variables of 'lits', which is enough to place all the
+// variables of a constraint in the same connected component.
+template <class Lits> static void linkVariables(GraphBuilder &g, const Lits &lits) {
+  for (int i = 1; i < lits.size(); i++) {
+    g.addEdge(var(lits[i - 1]), var(lits[i]));
+    g.addEdge(var(lits[i]), var(lits[i - 1]));
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  decompose : [void] ->  [int]
+  |
+  |  Description:
+  |
+  |    Splits the variables of the formula into connected components and
+  |    packs the components into groups. Components with at least
+  |    'MIN_COMPONENT_SIZE' literals form a group of their own, while smaller
+  |    ones are packed together so that each algorithm has enough work.
+  |    Groups without soft clauses are merged into the first group with soft
+  |    clauses. Returns the number of connected components with constraints.
+  |
+  |  Post-conditions:
+  |    * 'var_group', 'local_var', 'group_vars', 'group_hard', 'group_soft',
+  |      'group_card', 'group_pb' and 'group_order' are filled.
+  |
+  |________________________________________________________________________________________________@*/
+int Decomposer::decompose() {
+  int n_vars = maxsat_formula->nVars();
+
+  // The first pass counts the links of each variable and the second one
+  // stores them.
+  GraphBuilder builder(n_vars);
+  for (int pass = 0; pass < 2; pass++) {
+    if (pass == 1)
+      builder.allocate();
+    for (int i = 0; i < maxsat_formula->nHard(); i++)
+      linkVariables(builder, maxsat_formula->getHardClause(i).clause);
+    for (int i = 0; i < maxsat_formula->nSoft(); i++)
+      linkVariables(builder, maxsat_formula->getSoftClause(i).clause);
+    for (int i = 0; i < maxsat_formula->nCard(); i++)
+      linkVariables(builder,
+                    maxsat_formula->getCardinalityConstraint(i)->_lits);
+    for (int i = 0; i < maxsat_formula->nPB(); i++)
+      linkVariables(builder, maxsat_formula->getPBConstraint(i)->_lits);
+  }
+
+  Graph *graph = builder.build();
+  vec<int> component;
+  int n_components = graph->connectedComponents(component);
+  delete graph;
+
+  // Size (in literals) and number of soft clauses of each component.
+  vec<uint64_t> size(n_components, 0);
+  vec<int> n_soft(n_components, 0);
+  for (int i = 0; i < maxsat_formula->nHard(); i++) {
+    ClauseView c = maxsat_formula->getHardClause(i).clause;
+    if (c.size() > 0)
+      size[component[var(c[0])]] += c.size();
+  }
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    ClauseView c = maxsat_formula->getSoftClause(i).clause;
+    if (c.size() > 0) {
+      size[component[var(c[0])]] += c.size();
+      n_soft[component[var(c[0])]]++;
+    }
+  }
+  for (int i = 0; i < maxsat_formula->nCard(); i++) {
+    vec<Lit> &lits = maxsat_formula->getCardinalityConstraint(i)->_lits;
+    if (lits.size() > 0)
+      size[component[var(lits[0])]] += lits.size();
+  }
+  for (int i = 0; i < maxsat_formula->nPB(); i++) {
+    vec<Lit> &lits = maxsat_formula->getPBConstraint(i)->_lits;
+    if (lits.size() > 0)
+      size[component[var(lits[0])]] += lits.size();
+  }
+
+  // Components without constraints only contain unused variables.
+  std::vector<int> order;
+  for (int c = 0; c < n_components; c++)
+    if (size[c] > 0)
+      order.push_back(c);
+  std::sort(order.begin(), order.end(),
+            [&](int a, int b) { return size[a] > size[b]; });
+
+  vec<int> component_group(n_components, -1);
+  vec<uint64_t> packed_size;
+  vec<int> packed_soft;
+  int open = -1; // Group that is receiving small components.
+  for (size_t i = 0; i < order.size(); i++) {
+    int c = order[i];
+    int g = open;
+    if (size[c] >= MIN_COMPONENT_SIZE || g == -1) {
+      g = packed_size.size();
+      packed_size.push(0);
+      packed_soft.push(0);
+    }
+    component_group[c] = g;
+    packed_size[g] += size[c];
+    packed_soft[g] += n_soft[c];
+    if (size[c] < MIN_COMPONENT_SIZE)
+      open = packed_size[g] < MIN_COMPONENT_SIZE ? g : -1;
+  }
+
+  // Groups without soft clauses would be solved as plain SAT problems by the
+  // algorithms, so they are merged into the first group with soft clauses.
+  int target = 0;
+  for (int g = 0; g < packed_size.size(); g++)
+    if (packed_soft[g] > 0) {
+      target = g;
+      break;
+    }
+
+  vec<int> group_id(packed_size.size(), -1);
+  int n_groups = 0;
+  for (int g = 0; g < packed_size.size(); g++)
+    if (packed_soft[g] > 0 || g == target)
+      group_id[g] = n_groups++;
+  for (int g = 0; g < packed_size.size(); g++)
+    if (group_id[g] == -1)
+      group_id[g] = group_id[target];
+  // Empty clauses (and empty formulas) go to the first group.
+  int first = packed_size.size() > 0 ? group_id[target] : 0;
+  if (n_groups == 0)
+    n_groups = 1;
+
+  group_vars.resize(n_groups);
+  group_hard.resize(n_groups);
+  group_soft.resize(n_groups);
+  group_card.resize(n_groups);
+  group_pb.resize(n_groups);
+
+  vec<uint64_t> group_size(n_groups, 0);
+  for (int g = 0; g < packed_size.size(); g++)
+    group_size[group_id[g]] += packed_size[g];
+
+  var_group.growTo(n_vars, -1);
+  local_var.growTo(n_vars, -1);
+  for (int v = 0; v < n_vars; v++) {
+    int g = component_group[component[v]];
+    if (g == -1)
+      continue;
+    var_group[v] = group_id[g];
+    local_var[v] = (int)group_vars[var_group[v]].size();
+    group_vars[var_group[v]].push_back(v);
+  }
+
+  for (int i = 0; i < maxsat_formula->nHard(); i++) {
+    ClauseView c = maxsat_formula->getHardClause(i).clause;
+    group_hard[c.size() > 0 ? var_group[var(c[0])] : first].push_back(i);
+  }
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    ClauseView c = maxsat_formula->getSoftClause(i).clause;
+    group_soft[c.size() > 0 ? var_group[var(c[0])] : first].push_back(i);
+  }
+  for (int i = 0; i < maxsat_formula->nCard(); i++) {
+    vec<Lit> &lits = maxsat_formula->getCardinalityConstraint(i)->_lits;
+    group_card[lits.size() > 0 ? var_group[var(lits[0])] : first].push_back(i);
+  }
+  for (int i = 0; i < maxsat_formula->nPB(); i++) {
+    vec<Lit> &lits = maxsat_formula->getPBConstraint(i)->_lits;
+    group_pb[lits.size() > 0 ? var_group[var(lits[0])] : first].push_back(i);
+  }
+
+  // The largest groups are solved first to balance the threads.
+  std::vector<int> groups;
+  for (int g = 0; g < n_groups; g++)
+    groups.push_back(g);
+  std::sort(groups.begin(), groups.end(),
+            [&](int a, int b) { return group_size[a] > group_size[b]; });
+  for (size_t i = 0; i < groups.size(); i++)
+    group_order.push(groups[i]);
+
+  return order.size();
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  buildGroupFormula : (g : int) ->  [MaxSATFormula *]
+  |
+  |  Description:
+  |
+  |    Builds the formula of group 'g' over the local variables of the group.
+  |    The objective function of PB formulas was already converted into soft
+  |    clauses by 'loadFormula'.
+  |
+  |________________________________________________________________________________________________@*/
+MaxSATFormula *Decomposer::buildGroupFormula(int g) {
+  MaxSATFormula *f = new MaxSATFormula();
+  f->setFormat(maxsat_formula->getFormat());
+  f->setHardWeight(maxsat_formula->getHardWeight());
+  for (int i = 0; i < (int)group_vars[g].size(); i++)
+    f->newVar();
+
+  vec<Lit> lits;
+  auto localize = [&](vec<Lit> &ls) {
+    for (int i = 0; i < ls.size(); i++)
+      ls[i] = mkLit(local_var[var(ls[i])], sign(ls[i]));
+  };
+
+  for (int i = 0; i < (int)group_hard[g].size(); i++) {
+    maxsat_formula->getHardClause(group_hard[g][i]).clause.copyTo(lits);
+    localize(lits);
+    f->addHardClause(lits);
+  }
+
+  for (int i = 0; i < (int)group_soft[g].size(); i++) {
+    Soft soft = maxsat_formula->getSoftClause(group_soft[g][i]);
+    soft.clause.copyTo(lits);
+    localize(lits);
+    f->setMaximumWeight(soft.weight);
+    f->updateSumWeights(soft.weight);
+    f->addSoftClause(soft.weight, lits);
+  }
+
+  for (int i = 0; i < (int)group_card[g].size(); i++) {
+    Card *card = maxsat_formula->getCardinalityConstraint(group_card[g][i]);
+    card->_lits.copyTo(lits);
+    localize(lits);
+    f->addCardinalityConstraint(new Card(lits, card->_rhs));
+  }
+
+  for (int i = 0; i < (int)group_pb[g].size(); i++) {
+    PB *pb = maxsat_formula->getPBConstraint(group_pb[g][i]);
+    pb->_lits.copyTo(lits);
+    localize(lits);
+    PB local(lits, pb->_coeffs, pb->_rhs, pb->_sign);
+    f->addPBConstraint(&local);
+  }
+
+  if (f->getMaximumWeight() == 1)
+    f->setProblemType(_UNWEIGHTED_);
+  else
+    f->setProblemType(_WEIGHTED_);
+
+  return f;
+}
+
+void Decomposer::solveGroup(int g) {
+  MaxSAT *S = newAlgorithm(buildGroupFormula(g));
+  S->setInitialTime(initialTime);
+  S->setPrint(false);
+
+  StatusCode status;
+  try {
+    status = S->search();
+  } catch (MaxSATException &) {
+    status = _ERROR_;
+  } catch (OutOfMemoryException &) {
+    status = _ERROR_;
+  }
+
+  if (status == _OPTIMUM_ || status == _SATISFIABLE_) {
+    group_model[g].resize(group_vars[g].size());
+    for (int i = 0; i < (int)group_vars[g].size(); i++)
+      group_model[g][i] = S->getValue(i) > 0 ? l_True : l_False;
+  } else if (status == _UNSATISFIABLE_)
+    unsat = true;
+
+  group_status[g] = status;
+  delete S;
+}
+
+// Thread entry point. Solves groups until all of them are taken or one of
+// them is unsatisfiable.
+void Decomposer::worker() {
+  while (!unsat) {
+    int pos = next++;
+    if (pos >= group_order.size())
+      break;
+    solveGroup(group_order[pos]);
+  }
+}
+
+void Decomposer::printConfiguration(int components) {
+  if (!print)
+    return;
+
+  printf("c ==========================================[ Solver Settings "
+         "]============================================\n");
+  printf("c |                                                                "
+         "                                       |\n");
+  printf("c |  Algorithm: %23s                                             "
+         "                      |\n",
+         "Decomposition");
+  printf("c |  Components: %22d                                             "
+         "                      |\n",
+         components);
+  printf("c |  Groups: %26d                                             "
+         "                      |\n",
+         group_order.size());
+  printf("c |  Threads: %25d                                             "
+         "                      |\n",
+         std::min(n_threads, group_order.size()));
+  printf("c |                                                                "
+         "                                       |\n");
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  search : [void] ->  [StatusCode]
+  |
+  |  Description:
+  |
+  |    Solves the groups of the formula on a pool of 'n_threads' threads and
+  |    stitches their models. The formula is optimal when every group is
+  |    optimal, and unsatisfiable as soon as one group is unsatisfiable.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode Decomposer::search() {
+  int components = decompose();
+  printConfiguration(components);
+
+  group_status.growTo(group_order.size(), _UNKNOWN_);
+  group_model.resize(group_order.size());
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < std::min(n_threads, group_order.size()); i++)
+    threads.push_back(std::thread(&Decomposer::worker, this));
+  worker();
+  for (size_t i = 0; i < threads.size(); i++)
+    threads[i].join();
+
+  if (unsat) {
+    printAnswer(_UNSATISFIABLE_);
+    return _UNSATISFIABLE_;
+  }
+
+  bool optimum = true;
+  for (int g = 0; g < group_status.size(); g++) {
+    if (group_status[g] != _OPTIMUM_ && group_status[g] != _SATISFIABLE_) {
+      // A group without a model leaves the formula without a model.
+      printAnswer(_UNKNOWN_);
+      return _UNKNOWN_;
+    }
+    if (group_status[g] != _OPTIMUM_)
+      optimum = false;
+  }
+
+  // Variables that do not occur in the formula are assigned to false.
+  model.growTo(maxsat_formula->nInitialVars(), l_False);
+  for (int v = 0; v < var_group.size(); v++)
+    if (var_group[v] != -1)
+      model[v] = group_model[var_group[v]][local_var[v]];
+
+  ubCost = computeCostModel(model);
+  lbCost = optimum ? ubCost : 0;
+  printBound(ubCost + off_set);
+
+  if (optimum) {
+    printAnswer(_OPTIMUM_);
+    return _OPTIMUM_;
+  }
+  printAnswer(_SATISFIABLE_);
+  return _SATISFIABLE_;
+}
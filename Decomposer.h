@@ -0,0 +1,98 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef Decomposer_h
+#define Decomposer_h
+
+#include "MaxSAT.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+// Components with fewer literals than this are packed together and solved by
+// the same algorithm.
+#define MIN_COMPONENT_SIZE 1000
+
+namespace openwbo {
+
+/*! Solves a formula that is the union of independent subproblems.
+ *
+ * The variables are split into the connected components of the graph that
+ * links the variables of each clause (hard, soft, cardinality and PB
+ * constraints). Every group of components becomes a 'MaxSATFormula' of its
+ * own that is solved by the algorithm returned by the factory, using a pool
+ * of threads. The cost of the formula is the sum of the costs of the groups
+ * and the model is stitched from the models of the groups. */
+class Decomposer : public MaxSAT {
+
+public:
+  // 'factory' returns an algorithm with the given formula already loaded.
+  typedef std::function<MaxSAT *(MaxSATFormula *)> AlgorithmFactory;
+
+  Decomposer(AlgorithmFactory factory, int threads = 1,
+             int verb = _VERBOSITY_MINIMAL_);
+  ~Decomposer() {}
+
+  StatusCode search();
+
+protected:
+  int decompose(); // Builds the groups. Returns the number of components.
+  MaxSATFormula *buildGroupFormula(int g);
+  void solveGroup(int g);
+  void worker();
+
+  void printConfiguration(int components);
+
+  AlgorithmFactory newAlgorithm;
+  int n_threads;
+
+  // Variables are renumbered inside their group. The per-group lists are
+  // std::vector since 'vec' moves its elements with realloc.
+  vec<int> var_group; // Group of each variable.
+  vec<int> local_var; // Index of each variable inside its group.
+  std::vector<std::vector<int>> group_vars; // Variables of each group.
+
+  std::vector<std::vector<int>> group_hard; // Hard clauses of each group.
+  std::vector<std::vector<int>> group_soft; // Soft clauses of each group.
+  std::vector<std::vector<int>> group_card; // Cardinality constraints.
+  std::vector<std::vector<int>> group_pb;   // PB constraints of each group.
+
+  vec<int> group_order;    // Groups sorted by decreasing size.
+  std::atomic<int> next;   // Next position of 'group_order' to be solved.
+  std::atomic<bool> unsat; // True once a group is unsatisfiable.
+
+  // Result of each group. A group model is indexed by the local variables.
+  vec<StatusCode> group_status;
+  std::vector<std::vector<lbool>> group_model;
+};
+
+} // namespace openwbo
+
+#endif
@@ -34,7 +34,7 @@ using namespace openwbo;
  // Encoding of exactly-one constraints
  //
  ************************************************************************************************/
-void Encoder::encodeAMO(Solver *S, vec<Lit> &lits) {
+void Encoder::encodeAMO(SATBackend *S, vec<Lit> &lits) {
   vec<Lit> lits_copy;
   lits.copyTo(lits_copy);
 
@@ -58,7 +58,7 @@ void Encoder::encodeAMO(Solver *S, vec<Lit> &lits) {
  ************************************************************************************************/
 //
 // Manages the encoding of cardinality encodings.
-void Encoder::encodeCardinality(Solver *S, vec<Lit> &lits, int64_t rhs) {
+void Encoder::encodeCardinality(SATBackend *S, vec<Lit> &lits, int64_t rhs) {
 
   vec<Lit> lits_copy;
   lits.copyTo(lits_copy);
@@ -78,6 +78,13 @@ void Encoder::encodeCardinality(Solver *S, vec<Lit> &lits, int64_t rhs) {
     cnetworks.encode(S, lits_copy, rhs);
     break;
 
+  case _CARD_NATIVE_:
+    checkNativeCardinality(S);
+#ifdef NATIVE_CARDINALITY
+    native_card = S->native()->addAtMost(lits_copy, rhs);
+#endif
+    break;
+
   default:
     printf("c Error: Invalid cardinality encoding.\n");
     printf("s UNKNOWN\n");
@@ -85,10 +92,19 @@ void Encoder::encodeCardinality(Solver *S, vec<Lit> &lits, int64_t rhs) {
   }
 }
 
-void Encoder::addCardinality(Solver *S, Encoder &enc, int64_t rhs) {
+void Encoder::addCardinality(SATBackend *S, Encoder &enc, int64_t rhs) {
   if (cardinality_encoding == _CARD_TOTALIZER_ &&
       enc.cardinality_encoding == _CARD_TOTALIZER_) {
     totalizer.add(S, enc.totalizer, rhs);
+  } else if (cardinality_encoding == _CARD_NATIVE_ &&
+             enc.cardinality_encoding == _CARD_NATIVE_) {
+    // The literals of 'enc' are added to this constraint by the next call to
+    // 'incUpdateCardinality', so the constraint of 'enc' is removed.
+#ifdef NATIVE_CARDINALITY
+    if (enc.native_card != -1)
+      S->native()->removeAtMost(enc.native_card);
+    enc.native_card = -1;
+#endif
   } else {
     printf("c Error: Cardinality encoding does not support incrementality.\n");
     printf("s UNKNOWN\n");
@@ -97,7 +113,7 @@ void Encoder::addCardinality(Solver *S, Encoder &enc, int64_t rhs) {
 }
 
 // Manages the update of cardinality constraints.
-void Encoder::updateCardinality(Solver *S, int64_t rhs) {
+void Encoder::updateCardinality(SATBackend *S, int64_t rhs) {
 
   switch (cardinality_encoding) {
   case _CARD_TOTALIZER_:
@@ -112,6 +128,14 @@ void Encoder::updateCardinality(Solver *S, int64_t rhs) {
     cnetworks.update(S, rhs);
     break;
 
+  case _CARD_NATIVE_:
+#ifdef NATIVE_CARDINALITY
+    // If the constraint was not created, the solver is already unsatisfiable.
+    if (native_card != -1)
+      S->native()->tightenAtMost(native_card, rhs);
+#endif
+    break;
+
   default:
     printf("c Error: Invalid cardinality encoding.\n");
     printf("s UNKNOWN\n");
@@ -123,7 +147,7 @@ void Encoder::updateCardinality(Solver *S, int64_t rhs) {
 //
 // Manages the building of cardinality encodings.
 // Currently is only used for incremental solving.
-void Encoder::buildCardinality(Solver *S, vec<Lit> &lits, int64_t rhs) {
+void Encoder::buildCardinality(SATBackend *S, vec<Lit> &lits, int64_t rhs) {
   assert(incremental_strategy != _INCREMENTAL_NONE_);
 
   vec<Lit> lits_copy;
@@ -134,6 +158,11 @@ void Encoder::buildCardinality(Solver *S, vec<Lit> &lits, int64_t rhs) {
     totalizer.build(S, lits_copy, rhs);
     break;
 
+  case _CARD_NATIVE_:
+    // The constraint is created by 'incUpdateCardinality'.
+    checkNativeCardinality(S);
+    break;
+
   default:
     printf("c Error: Cardinality encoding does not support incrementality.\n");
     printf("s UNKNOWN\n");
@@ -142,8 +171,9 @@ void Encoder::buildCardinality(Solver *S, vec<Lit> &lits, int64_t rhs) {
 }
 
 // Manages the incremental update of cardinality constraints.
-void Encoder::incUpdateCardinality(Solver *S, vec<Lit> &join, vec<Lit> &lits,
-                                   int64_t rhs, vec<Lit> &assumptions) {
+void Encoder::incUpdateCardinality(SATBackend *S, vec<Lit> &join,
+                                   vec<Lit> &lits, int64_t rhs,
+                                   vec<Lit> &assumptions) {
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_ ||
          incremental_strategy == _INCREMENTAL_WEAKENING_);
 
@@ -162,6 +192,29 @@ void Encoder::incUpdateCardinality(Solver *S, vec<Lit> &join, vec<Lit> &lits,
     totalizer.update(S, rhs, lits_copy, assumptions);
     break;
 
+  case _CARD_NATIVE_: {
+    // The bound is enforced by a constraint over all the literals guarded by a
+    // variable, which is assumed. The constraint is updated in place and keeps
+    // its guard. A new guard is only needed if the solver fixed the old one.
+    assert(lits.size() > 0);
+    checkNativeCardinality(S);
+#ifdef NATIVE_CARDINALITY
+    if (native_card == -1 ||
+        !S->native()->updateAtMost(native_card, lits_copy, rhs)) {
+      if (native_card != -1)
+        S->native()->removeAtMost(native_card);
+
+      native_guard = mkLit(S->nVars(), false);
+      S->newVar();
+      native_card = S->native()->addAtMost(lits_copy, rhs, native_guard);
+    }
+
+    assumptions.clear();
+    assumptions.push(native_guard);
+#endif
+    break;
+  }
+
   default:
     printf("c Error: Cardinality encoding does not support incrementality.\n");
     printf("s UNKNOWN\n");
@@ -169,13 +222,17 @@ void Encoder::incUpdateCardinality(Solver *S, vec<Lit> &join, vec<Lit> &lits,
   }
 }
 
-void Encoder::joinEncoding(Solver *S, vec<Lit> &lits, int64_t rhs) {
+void Encoder::joinEncoding(SATBackend *S, vec<Lit> &lits, int64_t rhs) {
 
   switch (cardinality_encoding) {
   case _CARD_TOTALIZER_:
     totalizer.join(S, lits, rhs);
     break;
 
+  case _CARD_NATIVE_:
+    // The literals are joined by 'incUpdateCardinality'.
+    break;
+
   default:
     printf("c Error: Cardinality encoding does not support incrementality.\n");
     printf("s UNKNOWN\n");
@@ -183,6 +240,18 @@ void Encoder::joinEncoding(Solver *S, vec<Lit> &lits, int64_t rhs) {
   }
 }
 
+// Native constraints are only supported by glucose 4.1.
+void Encoder::checkNativeCardinality(SATBackend *S) {
+#ifdef NATIVE_CARDINALITY
+  if (S->native() != NULL)
+    return;
+#endif
+  printf("c Error: The SAT solver does not support native cardinality "
+         "constraints.\n");
+  printf("s UNKNOWN\n");
+  exit(_ERROR_);
+}
+
 /************************************************************************************************
  //
  // Encoding of pseudo-Boolean constraints
@@ -190,7 +259,7 @@ void Encoder::joinEncoding(Solver *S, vec<Lit> &lits, int64_t rhs) {
  ************************************************************************************************/
 //
 // Manages the encoding of PB encodings.
-void Encoder::encodePB(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+void Encoder::encodePB(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
                        uint64_t rhs) {
 
   vec<Lit> lits_copy;
@@ -218,7 +287,7 @@ void Encoder::encodePB(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
   }
 }
 
-int Encoder::predictPB(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+int Encoder::predictPB(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
                        uint64_t rhs) {
 
   vec<Lit> lits_copy;
@@ -246,9 +315,36 @@ int Encoder::predictPB(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
   }
 }
 
+// Manages the encoding of the outputs of PB sums.
+// Currently only used for core-guided binary search with GTE.
+void Encoder::encodePBOutputs(SATBackend *S, vec<Lit> &lits,
+                              vec<uint64_t> &coeffs, uint64_t max) {
+
+  vec<Lit> lits_copy;
+  lits.copyTo(lits_copy);
+  vec<uint64_t> coeffs_copy;
+  coeffs.copyTo(coeffs_copy);
+
+  switch (pb_encoding) {
+  case _PB_GTE_:
+    gte.encodeOutputs(S, lits_copy, coeffs_copy, max);
+    break;
+
+  default:
+    printf("Error: PB encoding does not support outputs.\n");
+    printf("s UNKNOWN\n");
+    exit(_ERROR_);
+  }
+}
+
+Lit Encoder::pbOutputAbove(uint64_t k) {
+  assert(pb_encoding == _PB_GTE_);
+
+  return gte.outputAbove(k);
+}
 
 // Manages the update of PB encodings.
-void Encoder::updatePB(Solver *S, uint64_t rhs) {
+void Encoder::updatePB(SATBackend *S, uint64_t rhs) {
 
   switch (pb_encoding) {
   case _PB_SWC_:
@@ -273,7 +369,7 @@ void Encoder::updatePB(Solver *S, uint64_t rhs) {
 // Incremental methods for PB encodings:
 //
 // Manages the incremental encode of PB encodings.
-void Encoder::incEncodePB(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+void Encoder::incEncodePB(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
                           int64_t rhs, vec<Lit> &assumptions, int size) {
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_);
 
@@ -296,7 +392,7 @@ void Encoder::incEncodePB(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
 }
 
 // Manages the incremental update of PB encodings.
-void Encoder::incUpdatePB(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+void Encoder::incUpdatePB(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
                           int64_t rhs, vec<Lit> &assumptions) {
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_);
 
@@ -321,7 +417,7 @@ void Encoder::incUpdatePB(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
 
 // Manages the incremental update of assumptions.
 // Currently only used for the iterative encoding with SWC.
-void Encoder::incUpdatePBAssumptions(Solver *S, vec<Lit> &assumptions) {
+void Encoder::incUpdatePBAssumptions(SATBackend *S, vec<Lit> &assumptions) {
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_);
 
   switch (pb_encoding) {
@@ -364,6 +460,8 @@ bool Encoder::hasCardEncoding() {
     return mtotalizer.hasCreatedEncoding();
   else if (cardinality_encoding == _CARD_CNETWORKS_)
     return cnetworks.hasCreatedEncoding();
+  else if (cardinality_encoding == _CARD_NATIVE_)
+    return native_card != -1;
 
   return false;
 }
@@ -65,6 +65,8 @@ public:
     incremental_strategy = incremental;
     cardinality_encoding = cardinality;
     totalizer.setIncremental(incremental);
+    native_card = -1;
+    native_guard = lit_Undef;
   }
 
   ~Encoder() {}
@@ -76,15 +78,15 @@ public:
   // At-most-one encodings:
   //
   // Encode exactly-one constraint into CNF.
-  void encodeAMO(Solver *S, vec<Lit> &lits);
+  void encodeAMO(SATBackend *S, vec<Lit> &lits);
 
   // Cardinality encodings:
   //
   // Encode cardinality constraint into CNF.
-  void encodeCardinality(Solver *S, vec<Lit> &lits, int64_t rhs);
+  void encodeCardinality(SATBackend *S, vec<Lit> &lits, int64_t rhs);
 
   // Update the rhs of an already existent cardinality constraint
-  void updateCardinality(Solver *S, int64_t rhs);
+  void updateCardinality(SATBackend *S, int64_t rhs);
 
   // Incremental cardinality encodings:
   //
@@ -92,12 +94,12 @@ public:
   // No restriction is made on the value of 'rhs'.
   // buildCardinality + updateCardinality is equivalent to encodeCardinality.
   // Useful for incremental encodings.
-  void buildCardinality(Solver *S, vec<Lit> &lits, int64_t rhs);
+  void buildCardinality(SATBackend *S, vec<Lit> &lits, int64_t rhs);
 
   // Incremental update for cardinality constraints;
-  void incUpdateCardinality(Solver *S, vec<Lit> &join, vec<Lit> &lits,
+  void incUpdateCardinality(SATBackend *S, vec<Lit> &join, vec<Lit> &lits,
                             int64_t rhs, vec<Lit> &assumptions);
-  void incUpdateCardinality(Solver *S, vec<Lit> &lits, int64_t rhs,
+  void incUpdateCardinality(SATBackend *S, vec<Lit> &lits, int64_t rhs,
                             vec<Lit> &assumptions) {
 
     vec<Lit> empty;
@@ -105,35 +107,43 @@ public:
   }
 
   // Add two disjoint cardinality constraints
-  void addCardinality(Solver *S, Encoder &enc, int64_t rhs);
+  void addCardinality(SATBackend *S, Encoder &enc, int64_t rhs);
 
   // PB encodings:
   //
   // Encode pseudo-Boolean constraint into CNF.
-  void encodePB(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs);
+  void encodePB(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+                uint64_t rhs);
   // Update the rhs of an already existent pseudo-Boolean constraint.
-  void updatePB(Solver *S, uint64_t rhs);
+  void updatePB(SATBackend *S, uint64_t rhs);
   // Predicts the number of clauses needed for the encoding
-  int predictPB(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs);
+  int predictPB(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+                uint64_t rhs);
+  // Encode the outputs of a pseudo-Boolean sum without bounding it. The sums
+  // larger than 'max' share one output.
+  void encodePBOutputs(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+                       uint64_t max);
+  // Output that is true if the sum is larger than 'k' (lit_Undef if none).
+  Lit pbOutputAbove(uint64_t k);
 
   // Incremental PB encodings:
   //
   // Incremental PB encoding.
-  void incEncodePB(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+  void incEncodePB(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
                    int64_t rhs, vec<Lit> &assumptions, int size);
 
   // Incremental update of PB encodings.
-  void incUpdatePB(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+  void incUpdatePB(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
                    int64_t rhs, vec<Lit> &assumptions);
 
   // Incremental update of assumptions.
-  void incUpdatePBAssumptions(Solver *S, vec<Lit> &assumptions);
+  void incUpdatePBAssumptions(SATBackend *S, vec<Lit> &assumptions);
 
   // Incremental construction of the totalizer encoding.
   // Joins a set of new literals, x_1 + ... + x_i, to an existing encoding of
   // the type
   // y_1 + ... + y_j <= k. It also updates 'k' to 'rhs'.
-  void joinEncoding(Solver *S, vec<Lit> &lits, int64_t rhs);
+  void joinEncoding(SATBackend *S, vec<Lit> &lits, int64_t rhs);
 
   // Other:
   //
@@ -178,6 +188,12 @@ protected:
   MTotalizer mtotalizer;
   Totalizer totalizer;
   Adder adder;
+  int native_card; // Native cardinality constraint of the SAT solver (-1 if
+                   // none).
+  Lit native_guard; // Guard of the incremental native cardinality constraint.
+
+  // Exits if the SAT solver has no native cardinality constraints.
+  void checkNativeCardinality(SATBackend *S);
 
   // PB encodings
   SWC swc;
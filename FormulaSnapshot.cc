@@ -0,0 +1,398 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "FormulaSnapshot.h"
+
+using NSPACE::toInt;
+using NSPACE::toLit;
+using namespace openwbo;
+
+static const char snapshot_magic[8] = {'O', 'W', 'B', 'O', 'S', 'N', 'A', 'P'};
+static const uint32_t snapshot_endianness = 0x01020304;
+
+static void snapshotError(const char *msg, const char *fileName) {
+  printf("c Error: %s %s\n", msg, fileName);
+  printf("s UNKNOWN\n");
+  exit(_ERROR_);
+}
+
+//=================================================================================================
+// Writer:
+
+class SnapshotWriter {
+public:
+  SnapshotWriter(FILE *f) : file(f), pos(0), failed(false) {}
+
+  void write(const void *data, size_t size) {
+    if (size > 0 && fwrite(data, 1, size, file) != size)
+      failed = true;
+    pos += size;
+  }
+
+  // Sections are 8-byte aligned so that they can be used in place.
+  void align() {
+    static const char zeros[8] = {0};
+    if (pos % 8 != 0)
+      write(zeros, 8 - pos % 8);
+  }
+
+  void writeInt(int32_t v) { write(&v, sizeof(v)); }
+  void writeInt64(int64_t v) { write(&v, sizeof(v)); }
+
+  void writeLits(const vec<Lit> &lits) {
+    writeInt(lits.size());
+    align();
+    for (int i = 0; i < lits.size(); i++)
+      writeInt(toInt(lits[i]));
+    align();
+  }
+
+  void writeCoeffs(const vec<uint64_t> &coeffs) {
+    writeInt(coeffs.size());
+    align();
+    for (int i = 0; i < coeffs.size(); i++)
+      write(&coeffs[i], sizeof(uint64_t));
+  }
+
+  FILE *file;
+  size_t pos;
+  bool failed;
+};
+
+/*_________________________________________________________________________________________________
+  |
+  |  write : (fileName : const char *) (maxsat_formula : MaxSATFormula *) ->
+  |  [void]
+  |
+  |  Description:
+  |
+  |    Writes a snapshot with the following layout. Every section starts at an
+  |    8-byte aligned offset.
+  |
+  |      Header
+  |      hard offsets (int32 x nHard+1), hard literals (int32 x hard_lits)
+  |      soft offsets (int32 x nSoft+1), soft literals (int32 x soft_lits)
+  |      soft weights (uint64 x nSoft)
+  |      cardinality constraints (rhs, literals)
+  |      PB constraints (rhs, sign, literals, coefficients)
+  |      objective function (constant, literals, coefficients) if present
+  |      variable names (id, length, characters)
+  |
+  |  Pre-conditions:
+  |    * Soft clauses must not have been relaxed yet.
+  |
+  |________________________________________________________________________________________________@*/
+void FormulaSnapshot::write(const char *fileName,
+                            MaxSATFormula *maxsat_formula) {
+  FILE *f = fopen(fileName, "wb");
+  if (f == NULL)
+    snapshotError("Unable to open snapshot file", fileName);
+
+  Header h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, snapshot_magic, sizeof(h.magic));
+  h.version = _SNAPSHOT_VERSION_;
+  h.endianness = snapshot_endianness;
+  h.lit_size = sizeof(Lit);
+  h.format = maxsat_formula->format;
+  h.problem_type = maxsat_formula->problem_type;
+  h.n_vars = maxsat_formula->n_vars;
+  h.n_initial_vars = maxsat_formula->n_initial_vars;
+  h.n_hard = maxsat_formula->nHard();
+  h.n_soft = maxsat_formula->nSoft();
+  h.n_card = maxsat_formula->nCard();
+  h.n_pb = maxsat_formula->nPB();
+  h.n_names = maxsat_formula->_nameToIndex.size();
+  h.has_objective = maxsat_formula->objective_function != NULL;
+  h.hard_weight = maxsat_formula->hard_weight;
+  h.sum_soft_weight = maxsat_formula->sum_soft_weight;
+  h.max_soft_weight = maxsat_formula->max_soft_weight;
+  h.hard_lits = maxsat_formula->hard_arena.nLits();
+  h.soft_lits = maxsat_formula->soft_arena.nLits();
+
+  SnapshotWriter out(f);
+  out.write(&h, sizeof(h));
+  out.align();
+
+  ClauseArena *arenas[2] = {&maxsat_formula->hard_arena,
+                            &maxsat_formula->soft_arena};
+  for (int a = 0; a < 2; a++) {
+    out.write(arenas[a]->offsetsData(), sizeof(int) * (arenas[a]->size() + 1));
+    out.align();
+    out.write(arenas[a]->litsData(), sizeof(Lit) * arenas[a]->nLits());
+    out.align();
+  }
+
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    assert(maxsat_formula->soft_relaxations[i].size() == 0);
+    out.write(&maxsat_formula->soft_weights[i], sizeof(uint64_t));
+  }
+
+  for (int i = 0; i < maxsat_formula->nCard(); i++) {
+    Card *c = maxsat_formula->getCardinalityConstraint(i);
+    out.writeInt64(c->_rhs);
+    out.writeLits(c->_lits);
+  }
+
+  for (int i = 0; i < maxsat_formula->nPB(); i++) {
+    PB *p = maxsat_formula->getPBConstraint(i);
+    out.writeInt64(p->_rhs);
+    out.writeInt(p->_sign);
+    out.writeLits(p->_lits);
+    out.writeCoeffs(p->_coeffs);
+  }
+
+  if (h.has_objective) {
+    PBObjFunction *of = maxsat_formula->objective_function;
+    out.writeInt64(of->_const);
+    out.writeLits(of->_lits);
+    out.writeCoeffs(of->_coeffs);
+  }
+
+  for (nameMap::const_iterator it = maxsat_formula->_nameToIndex.begin();
+       it != maxsat_formula->_nameToIndex.end(); ++it) {
+    out.writeInt(it->second);
+    out.writeInt(it->first.size());
+    out.write(it->first.data(), it->first.size());
+  }
+
+  if (out.failed || fclose(f) != 0)
+    snapshotError("Unable to write snapshot file", fileName);
+}
+
+//=================================================================================================
+// Reader:
+
+class SnapshotReader {
+public:
+  SnapshotReader(const char *d, size_t s, const char *name)
+      : data(d), size(s), pos(0), fileName(name) {}
+
+  const char *read(size_t n) {
+    if (n > size - pos)
+      snapshotError("Truncated snapshot file", fileName);
+    const char *p = data + pos;
+    pos += n;
+    return p;
+  }
+
+  void align() {
+    if (pos % 8 != 0)
+      read(8 - pos % 8);
+  }
+
+  int32_t readInt() {
+    int32_t v;
+    memcpy(&v, read(sizeof(v)), sizeof(v));
+    return v;
+  }
+
+  int64_t readInt64() {
+    int64_t v;
+    memcpy(&v, read(sizeof(v)), sizeof(v));
+    return v;
+  }
+
+  void readLits(vec<Lit> &lits, int n_vars) {
+    int n = readInt();
+    align();
+    const int32_t *l = (const int32_t *)read(sizeof(int32_t) * n);
+    lits.clear();
+    for (int i = 0; i < n; i++) {
+      lits.push(toLit(l[i]));
+      if (var(lits.last()) < 0 || var(lits.last()) >= n_vars)
+        snapshotError("Corrupted snapshot file", fileName);
+    }
+    align();
+  }
+
+  void readCoeffs(vec<uint64_t> &coeffs) {
+    int n = readInt();
+    align();
+    const uint64_t *c = (const uint64_t *)read(sizeof(uint64_t) * n);
+    coeffs.clear();
+    for (int i = 0; i < n; i++)
+      coeffs.push(c[i]);
+  }
+
+  const char *data;
+  size_t size;
+  size_t pos;
+  const char *fileName;
+};
+
+bool FormulaSnapshot::isSnapshot(const char *fileName) {
+  char magic[sizeof(snapshot_magic)];
+  FILE *f = fopen(fileName, "rb");
+  if (f == NULL)
+    return false;
+  bool res = fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+             memcmp(magic, snapshot_magic, sizeof(magic)) == 0;
+  fclose(f);
+  return res;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  load : (fileName : const char *) (maxsat_formula : MaxSATFormula *) ->
+  |  [void]
+  |
+  |  Description:
+  |
+  |    Maps the snapshot into memory. The hard and soft clause arenas of the
+  |    formula refer directly to the mapped pages (they are only copied if a
+  |    clause is later added to the formula). Soft weights, constraints and
+  |    variable names are copied since algorithms modify them.
+  |
+  |  Pre-conditions:
+  |    * 'maxsat_formula' is empty.
+  |
+  |________________________________________________________________________________________________@*/
+void FormulaSnapshot::load(const char *fileName,
+                           MaxSATFormula *maxsat_formula) {
+  assert(maxsat_formula->nHard() == 0 && maxsat_formula->nSoft() == 0);
+
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0)
+    snapshotError("Unable to open snapshot file", fileName);
+
+  struct stat statbuf;
+  if (fstat(fd, &statbuf) < 0)
+    snapshotError("Unable to get size of snapshot file", fileName);
+
+  size_t size = statbuf.st_size;
+  void *map = size > 0 ? mmap(0, size, PROT_READ, MAP_SHARED, fd, 0)
+                       : MAP_FAILED;
+  close(fd);
+  if (map == MAP_FAILED)
+    snapshotError("Unable to put in memory snapshot file", fileName);
+
+  SnapshotReader in((const char *)map, size, fileName);
+  Header h;
+  memcpy(&h, in.read(sizeof(h)), sizeof(h));
+  in.align();
+
+  if (memcmp(h.magic, snapshot_magic, sizeof(h.magic)) != 0)
+    snapshotError("Not a snapshot file", fileName);
+  if (h.version != _SNAPSHOT_VERSION_)
+    snapshotError("Unsupported snapshot version in", fileName);
+  if (h.endianness != snapshot_endianness || h.lit_size != sizeof(Lit))
+    snapshotError("Snapshot was created on an incompatible machine:",
+                  fileName);
+
+  // The counts size the tables read below, so they are checked before any
+  // table is indexed. Each clause needs at least an offset in the file.
+  if (h.n_vars < 0 || h.n_initial_vars < 0 || h.n_hard < 0 || h.n_soft < 0 ||
+      h.n_card < 0 || h.n_pb < 0 || h.n_names < 0)
+    snapshotError("Corrupted snapshot file", fileName);
+  if ((uint64_t)h.n_hard + h.n_soft + 2 > size / sizeof(int) ||
+      h.hard_lits > size / sizeof(Lit) || h.soft_lits > size / sizeof(Lit))
+    snapshotError("Corrupted snapshot file", fileName);
+
+  maxsat_formula->snapshot_map = map;
+  maxsat_formula->snapshot_size = size;
+
+  maxsat_formula->format = h.format;
+  maxsat_formula->problem_type = h.problem_type;
+  maxsat_formula->n_vars = h.n_vars;
+  maxsat_formula->n_initial_vars = h.n_initial_vars;
+  maxsat_formula->hard_weight = h.hard_weight;
+  maxsat_formula->sum_soft_weight = h.sum_soft_weight;
+  maxsat_formula->max_soft_weight = h.max_soft_weight;
+
+  ClauseArena *arenas[2] = {&maxsat_formula->hard_arena,
+                            &maxsat_formula->soft_arena};
+  int n_clauses[2] = {h.n_hard, h.n_soft};
+  uint64_t n_lits[2] = {h.hard_lits, h.soft_lits};
+  for (int a = 0; a < 2; a++) {
+    const int *offsets =
+        (const int *)in.read(sizeof(int) * ((size_t)n_clauses[a] + 1));
+    in.align();
+    const Lit *lits = (const Lit *)in.read(sizeof(Lit) * n_lits[a]);
+    in.align();
+    if (offsets[0] != 0 || offsets[n_clauses[a]] != (int64_t)n_lits[a])
+      snapshotError("Corrupted snapshot file", fileName);
+    for (int i = 0; i < n_clauses[a]; i++)
+      if (offsets[i] > offsets[i + 1])
+        snapshotError("Corrupted snapshot file", fileName);
+    for (uint64_t i = 0; i < n_lits[a]; i++)
+      if (var(lits[i]) < 0 || var(lits[i]) >= h.n_vars)
+        snapshotError("Corrupted snapshot file", fileName);
+    arenas[a]->attach(lits, offsets, n_clauses[a]);
+  }
+  maxsat_formula->n_hard = h.n_hard;
+  maxsat_formula->n_soft = h.n_soft;
+
+  const uint64_t *weights =
+      (const uint64_t *)in.read(sizeof(uint64_t) * h.n_soft);
+  maxsat_formula->soft_weights.growTo(h.n_soft);
+  if (h.n_soft > 0)
+    memcpy(&maxsat_formula->soft_weights[0], weights,
+           sizeof(uint64_t) * h.n_soft);
+  maxsat_formula->soft_assumptions.growTo(h.n_soft, lit_Undef);
+  maxsat_formula->soft_relaxations.growTo(h.n_soft);
+
+  vec<Lit> lits;
+  vec<uint64_t> coeffs;
+  for (int i = 0; i < h.n_card; i++) {
+    int64_t rhs = in.readInt64();
+    in.readLits(lits, h.n_vars);
+    maxsat_formula->cardinality_constraints.push(new Card(lits, rhs));
+  }
+
+  for (int i = 0; i < h.n_pb; i++) {
+    int64_t rhs = in.readInt64();
+    bool sign = in.readInt();
+    in.readLits(lits, h.n_vars);
+    in.readCoeffs(coeffs);
+    maxsat_formula->pb_constraints.push(new PB(lits, coeffs, rhs, sign));
+  }
+
+  if (h.has_objective) {
+    int64_t c = in.readInt64();
+    in.readLits(lits, h.n_vars);
+    in.readCoeffs(coeffs);
+    maxsat_formula->objective_function = new PBObjFunction(lits, coeffs, c);
+  }
+
+  for (int i = 0; i < h.n_names; i++) {
+    int id = in.readInt();
+    int length = in.readInt();
+    std::string name(in.read(length), length);
+    maxsat_formula->_nameToIndex.insert(std::make_pair(name, id));
+    maxsat_formula->_indexToName.insert(std::make_pair(id, name));
+  }
+}
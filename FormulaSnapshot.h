@@ -0,0 +1,91 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef FormulaSnapshot_h
+#define FormulaSnapshot_h
+
+#include "MaxSATFormula.h"
+
+namespace openwbo {
+
+#define _SNAPSHOT_VERSION_ 1
+
+/*! Binary snapshot of a parsed MaxSAT formula.
+ *
+ * A snapshot stores the clauses, weights, PB/cardinality constraints, the
+ * objective function and the variable names of a formula as it is after
+ * parsing. Clauses are laid out exactly as in the clause arenas of
+ * MaxSATFormula so that a snapshot can be memory mapped and used in place:
+ * loading does not parse anything and the read-only pages are shared between
+ * all processes that load the same snapshot.
+ *
+ * Snapshots are not portable across architectures with different endianness
+ * or literal representation; both are checked when loading. */
+class FormulaSnapshot {
+
+public:
+  // Returns true if 'fileName' starts with the snapshot magic number.
+  static bool isSnapshot(const char *fileName);
+
+  // Writes the formula to 'fileName'. Must be called before the formula is
+  // relaxed by any algorithm.
+  static void write(const char *fileName, MaxSATFormula *maxsat_formula);
+
+  // Loads the snapshot in 'fileName' into an empty formula. The formula keeps
+  // the file mapped in memory until it is destroyed.
+  static void load(const char *fileName, MaxSATFormula *maxsat_formula);
+
+protected:
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianness;
+    uint32_t lit_size;
+    int32_t format;
+    int32_t problem_type;
+    int32_t n_vars;
+    int32_t n_initial_vars;
+    int32_t n_hard;
+    int32_t n_soft;
+    int32_t n_card;
+    int32_t n_pb;
+    int32_t n_names;
+    int32_t has_objective;
+    int32_t padding;
+    uint64_t hard_weight;
+    uint64_t sum_soft_weight;
+    uint64_t max_soft_weight;
+    uint64_t hard_lits;
+    uint64_t soft_lits;
+  };
+};
+
+} // namespace openwbo
+
+#endif
@@ -0,0 +1,422 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "LocalSearch.h"
+
+#include "mtl/Sort.h"
+
+#include <chrono>
+
+using namespace openwbo;
+
+LocalSearch::LocalSearch(MaxSATFormula *maxsat_formula, uint32_t seed)
+    : n_vars(maxsat_formula->nVars()), fixed_cost(0), infeasible(false),
+      unsat_weight(0), hard_inc(1), flips(0),
+      random_state(seed == 0 ? 1 : seed), best_cost(UINT64_MAX),
+      interrupted(false) {
+  assert(supports(maxsat_formula));
+
+  offsets.push(0);
+  occurs.growTo(2 * n_vars);
+
+  for (int i = 0; i < maxsat_formula->nHard(); i++)
+    addClause(maxsat_formula->getHardClause(i).clause, true, 0);
+
+  uint64_t sum_weights = 0;
+  int n_soft = 0;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    Soft soft = maxsat_formula->getSoftClause(i);
+    assert(soft.relaxation_vars.size() == 0);
+    addClause(soft.clause, false, soft.weight);
+    sum_weights += soft.weight;
+    n_soft++;
+  }
+
+  // The weight of a soft clause may grow up to a limit that is proportional
+  // to its weight in the formula.
+  double average = n_soft > 0 ? (double)sum_weights / n_soft : 1;
+  for (int c = 0; c < is_hard.size(); c++) {
+    if (is_hard[c])
+      continue;
+    double limit = 1 + org_weight[c] * (LS_SOFT_WEIGHT_LIMIT / average);
+    weight_limit[c] = limit < INT32_MAX ? (int64_t)limit : INT32_MAX;
+  }
+
+  if (maxsat_formula->getProblemType() == _WEIGHTED_)
+    hard_inc = 3;
+
+  initAssignment();
+}
+
+LocalSearch::~LocalSearch() { stop(); }
+
+bool LocalSearch::supports(MaxSATFormula *maxsat_formula) {
+  return maxsat_formula->getFormat() == _FORMAT_MAXSAT_ &&
+         maxsat_formula->nCard() == 0 && maxsat_formula->nPB() == 0;
+}
+
+// Adds a copy of 'clause' without duplicated literals. Tautologies are
+// ignored and empty clauses are only recorded.
+void LocalSearch::addClause(const ClauseView &clause, bool hard,
+                            uint64_t w) {
+  vec<Lit> copy;
+  clause.copyTo(copy);
+  sort(copy);
+
+  int j = 0;
+  for (int i = 0; i < copy.size(); i++) {
+    if (j > 0 && copy[i] == copy[j - 1])
+      continue;
+    if (j > 0 && copy[i] == ~copy[j - 1])
+      return;
+    copy[j++] = copy[i];
+  }
+  copy.shrink(copy.size() - j);
+
+  if (copy.size() == 0) {
+    if (hard)
+      infeasible = true;
+    else
+      fixed_cost += w;
+    return;
+  }
+
+  int c = is_hard.size();
+  for (int i = 0; i < copy.size(); i++) {
+    lits.push(copy[i]);
+    occurs[toInt(copy[i])].push(c);
+  }
+  offsets.push(lits.size());
+  is_hard.push(hard);
+  org_weight.push(w);
+  weight.push(1);
+  weight_limit.push(1);
+}
+
+// Builds a random assignment and the scores of the variables.
+void LocalSearch::initAssignment() {
+  int n_clauses = is_hard.size();
+
+  value.growTo(n_vars);
+  for (int v = 0; v < n_vars; v++)
+    value[v] = nextRandom() & 1;
+
+  sat_count.growTo(n_clauses, 0);
+  sat_var.growTo(n_clauses, -1);
+  unsat_index.growTo(n_clauses, -1);
+  score.growTo(n_vars, 0);
+  time_stamp.growTo(n_vars, 0);
+  good_index.growTo(n_vars, -1);
+
+  for (int c = 0; c < n_clauses; c++) {
+    for (int i = offsets[c]; i < offsets[c + 1]; i++) {
+      if (value[var(lits[i])] != sign(lits[i])) {
+        sat_count[c]++;
+        sat_var[c] = var(lits[i]);
+      }
+    }
+
+    if (sat_count[c] == 0) {
+      makeUnsat(c);
+      for (int i = offsets[c]; i < offsets[c + 1]; i++)
+        score[var(lits[i])] += weight[c];
+    } else if (sat_count[c] == 1)
+      score[sat_var[c]] -= weight[c];
+  }
+
+  for (int v = 0; v < n_vars; v++)
+    updateGoodVar(v);
+}
+
+void LocalSearch::makeUnsat(int c) {
+  vec<int> &list = is_hard[c] ? unsat_hard : unsat_soft;
+  unsat_index[c] = list.size();
+  list.push(c);
+  if (!is_hard[c])
+    unsat_weight += org_weight[c];
+}
+
+void LocalSearch::makeSat(int c) {
+  vec<int> &list = is_hard[c] ? unsat_hard : unsat_soft;
+  int last = list.last();
+  list[unsat_index[c]] = last;
+  unsat_index[last] = unsat_index[c];
+  list.pop();
+  unsat_index[c] = -1;
+  if (!is_hard[c])
+    unsat_weight -= org_weight[c];
+}
+
+// Keeps 'good_vars' equal to the set of variables with positive score.
+void LocalSearch::updateGoodVar(int v) {
+  if (score[v] > 0 && good_index[v] == -1) {
+    good_index[v] = good_vars.size();
+    good_vars.push(v);
+  } else if (score[v] <= 0 && good_index[v] != -1) {
+    int last = good_vars.last();
+    good_vars[good_index[v]] = last;
+    good_index[last] = good_index[v];
+    good_vars.pop();
+    good_index[v] = -1;
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  flip : (v : int)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Flips variable 'v' and updates the scores of the variables of the
+  |    clauses of 'v' whose number of satisfied literals becomes 0, 1 or 2.
+  |
+  |  Post-conditions:
+  |    * The score of 'v' is the symmetric of its previous score.
+  |
+  |________________________________________________________________________________________________@*/
+void LocalSearch::flip(int v) {
+  int64_t old_score = score[v];
+  value[v] = !value[v];
+
+  // Clauses where the literal of 'v' becomes satisfied.
+  vec<int> &made = occurs[toInt(mkLit(v, !value[v]))];
+  for (int k = 0; k < made.size(); k++) {
+    int c = made[k];
+    sat_count[c]++;
+    if (sat_count[c] == 1) {
+      sat_var[c] = v;
+      for (int i = offsets[c]; i < offsets[c + 1]; i++) {
+        score[var(lits[i])] -= weight[c];
+        updateGoodVar(var(lits[i]));
+      }
+      makeSat(c);
+    } else if (sat_count[c] == 2) {
+      score[sat_var[c]] += weight[c];
+      updateGoodVar(sat_var[c]);
+    }
+  }
+
+  // Clauses where the literal of 'v' becomes falsified.
+  vec<int> &broken = occurs[toInt(mkLit(v, value[v]))];
+  for (int k = 0; k < broken.size(); k++) {
+    int c = broken[k];
+    sat_count[c]--;
+    if (sat_count[c] == 0) {
+      for (int i = offsets[c]; i < offsets[c + 1]; i++) {
+        score[var(lits[i])] += weight[c];
+        updateGoodVar(var(lits[i]));
+      }
+      makeUnsat(c);
+    } else if (sat_count[c] == 1) {
+      for (int i = offsets[c]; i < offsets[c + 1]; i++) {
+        if (value[var(lits[i])] != sign(lits[i])) {
+          sat_var[c] = var(lits[i]);
+          score[sat_var[c]] -= weight[c];
+          updateGoodVar(sat_var[c]);
+          break;
+        }
+      }
+    }
+  }
+
+  score[v] = -old_score;
+  updateGoodVar(v);
+  time_stamp[v] = ++flips;
+}
+
+// Changes the dynamic weight of clause 'c' by 'delta'.
+void LocalSearch::changeWeight(int c, int64_t delta) {
+  weight[c] += delta;
+  if (sat_count[c] == 0) {
+    for (int i = offsets[c]; i < offsets[c + 1]; i++) {
+      score[var(lits[i])] += delta;
+      updateGoodVar(var(lits[i]));
+    }
+  } else if (sat_count[c] == 1) {
+    score[sat_var[c]] -= delta;
+    updateGoodVar(sat_var[c]);
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  updateWeights : [void]  ->  [void]
+  |
+  |  Description:
+  |
+  |    Called at local optima. Increases the weight of the falsified hard
+  |    clauses and of the falsified soft clauses below their limit. With a
+  |    small probability, the weights of the satisfied clauses are decreased
+  |    instead.
+  |
+  |________________________________________________________________________________________________@*/
+void LocalSearch::updateWeights() {
+  if (nextRandom() % 100 < LS_SMOOTH_PERCENT) {
+    for (int c = 0; c < is_hard.size(); c++) {
+      if (sat_count[c] == 0)
+        continue;
+      if (is_hard[c] && weight[c] > hard_inc)
+        changeWeight(c, -hard_inc);
+      else if (!is_hard[c] && weight[c] > 1)
+        changeWeight(c, -1);
+    }
+    return;
+  }
+
+  for (int i = 0; i < unsat_hard.size(); i++)
+    changeWeight(unsat_hard[i], hard_inc);
+  for (int i = 0; i < unsat_soft.size(); i++)
+    if (weight[unsat_soft[i]] < weight_limit[unsat_soft[i]])
+      changeWeight(unsat_soft[i], 1);
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  pickVariable : [void]  ->  [int]
+  |
+  |  Description:
+  |
+  |    Returns the best of LS_BMS_SAMPLES variables with positive score
+  |    sampled at random. If there are none, the weights are updated and the
+  |    best variable of a random falsified clause (hard clauses first) is
+  |    returned. Ties are broken in favor of the least recently flipped
+  |    variable.
+  |
+  |  Post-conditions:
+  |    * Returns -1 if all clauses are satisfied.
+  |
+  |________________________________________________________________________________________________@*/
+int LocalSearch::pickVariable() {
+  if (good_vars.size() > 0) {
+    int best = good_vars[nextRandom() % good_vars.size()];
+    int samples = good_vars.size() <= LS_BMS_SAMPLES ? good_vars.size()
+                                                     : LS_BMS_SAMPLES;
+    for (int i = 0; i < samples; i++) {
+      int v = good_vars.size() <= LS_BMS_SAMPLES
+                  ? good_vars[i]
+                  : good_vars[nextRandom() % good_vars.size()];
+      if (score[v] > score[best] ||
+          (score[v] == score[best] && time_stamp[v] < time_stamp[best]))
+        best = v;
+    }
+    return best;
+  }
+
+  updateWeights();
+
+  vec<int> &list = unsat_hard.size() > 0 ? unsat_hard : unsat_soft;
+  if (list.size() == 0)
+    return -1;
+
+  int c = list[nextRandom() % list.size()];
+  int best = var(lits[offsets[c]]);
+  for (int i = offsets[c] + 1; i < offsets[c + 1]; i++) {
+    int v = var(lits[i]);
+    if (score[v] > score[best] ||
+        (score[v] == score[best] && time_stamp[v] < time_stamp[best]))
+      best = v;
+  }
+  return best;
+}
+
+void LocalSearch::saveBest() {
+  std::lock_guard<std::mutex> lock(best_lock);
+  best_model.clear();
+  for (int v = 0; v < n_vars; v++)
+    best_model.push(lbool(value[v]));
+  best_cost.store(unsat_weight + fixed_cost);
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  search : (seconds : double)  ->  [bool]
+  |
+  |  Description:
+  |
+  |    Flips variables until the time limit is reached, 'interrupt' is called
+  |    or a model satisfying all soft clauses is found. A time limit of 0
+  |    only stops on 'interrupt'.
+  |
+  |  Post-conditions:
+  |    * 'best_model' and 'best_cost' are updated with the improving models.
+  |
+  |________________________________________________________________________________________________@*/
+bool LocalSearch::search(double seconds) {
+  if (infeasible)
+    return false;
+
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+  for (;;) {
+    if (unsat_hard.size() == 0 && unsat_weight + fixed_cost < best_cost.load())
+      saveBest();
+
+    if (unsat_soft.size() == 0 && unsat_hard.size() == 0)
+      break;
+
+    if ((flips & 1023) == 0) {
+      if (interrupted.load())
+        break;
+      if (seconds > 0 &&
+          std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                        start)
+                  .count() >= seconds)
+        break;
+    }
+
+    int v = pickVariable();
+    if (v == -1)
+      break;
+    flip(v);
+  }
+
+  return best_cost.load() != UINT64_MAX;
+}
+
+void LocalSearch::startBackground() {
+  assert(!background.joinable());
+  interrupted.store(false);
+  background = std::thread(&LocalSearch::search, this, 0.0);
+}
+
+void LocalSearch::stop() {
+  interrupt();
+  if (background.joinable())
+    background.join();
+}
+
+bool LocalSearch::getBestModel(vec<lbool> &model, uint64_t &cost) {
+  std::lock_guard<std::mutex> lock(best_lock);
+  if (best_model.size() == 0)
+    return false;
+  best_model.copyTo(model);
+  cost = best_cost.load();
+  return true;
+}
@@ -0,0 +1,161 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef LocalSearch_h
+#define LocalSearch_h
+
+#include "MaxSATFormula.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+
+// Number of good variables sampled at each step (best from multiple
+// selections).
+#define LS_BMS_SAMPLES 15
+// Limit of the dynamic weight of a soft clause of average weight.
+#define LS_SOFT_WEIGHT_LIMIT 50
+// Percentage of the weight updates that smooth the weights instead.
+#define LS_SMOOTH_PERCENT 1
+
+using NSPACE::vec;
+using NSPACE::Lit;
+using NSPACE::lbool;
+
+namespace openwbo {
+
+/*! Weighted MaxSAT local search in the style of SATLike.
+ *
+ * The clauses of the formula are copied when the object is built, so the
+ * algorithms may later change the formula. Every clause has a dynamic weight
+ * that is increased while the clause is falsified at a local optimum and
+ * smoothed from time to time. The score of a variable is the decrease of the
+ * dynamic weight of the falsified clauses if the variable is flipped. Scores
+ * are maintained incrementally on each flip from the number of satisfied
+ * literals of each clause and, for clauses with a single satisfied literal,
+ * the variable of that literal.
+ *
+ * Models that satisfy all hard clauses are kept when they improve the best
+ * cost. The best model can be read from another thread while the search is
+ * running in the background. */
+class LocalSearch {
+
+public:
+  LocalSearch(MaxSATFormula *maxsat_formula, uint32_t seed = 1);
+  ~LocalSearch();
+
+  // True if the formula only has hard and soft clauses.
+  static bool supports(MaxSATFormula *maxsat_formula);
+
+  // Searches for 'seconds' seconds or until 'interrupt' is called. The search
+  // continues from the current assignment. Returns true if a model was found.
+  bool search(double seconds);
+
+  // Runs 'search' in a background thread until 'stop' is called.
+  void startBackground();
+  void stop();
+  void interrupt() { interrupted.store(true); }
+
+  // Cost of the best model (UINT64_MAX if no model was found).
+  uint64_t getBestCost() { return best_cost.load(); }
+
+  // Copies the best model to 'model' and its cost to 'cost'. Returns false if
+  // no model was found.
+  bool getBestModel(vec<lbool> &model, uint64_t &cost);
+
+  uint64_t nFlips() { return flips; }
+
+protected:
+  void addClause(const ClauseView &clause, bool hard, uint64_t weight);
+  void initAssignment();
+
+  void flip(int v);
+  int pickVariable();
+  void updateWeights();
+  void changeWeight(int c, int64_t delta);
+
+  void makeUnsat(int c);
+  void makeSat(int c);
+  void updateGoodVar(int v);
+
+  void saveBest();
+
+  uint32_t nextRandom() {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+  }
+
+  int n_vars;
+
+  // Clauses are stored contiguously; clause 'c' has the literals in positions
+  // [offsets[c], offsets[c + 1]) of 'lits'.
+  vec<Lit> lits;
+  vec<int> offsets;
+  vec<bool> is_hard;
+  vec<uint64_t> org_weight;  // Weight of soft clauses in the formula.
+  vec<int64_t> weight;       // Dynamic weight of each clause.
+  vec<int64_t> weight_limit; // Soft clause weights are not increased beyond.
+  uint64_t fixed_cost;       // Weight of the empty soft clauses.
+  bool infeasible;           // An empty hard clause was found.
+
+  vec<vec<int>> occurs; // Clauses of each literal (indexed by 'toInt').
+
+  // Search state
+  vec<bool> value;
+  vec<int> sat_count; // Number of satisfied literals of each clause.
+  vec<int> sat_var;   // Some satisfied variable of each clause.
+  vec<int64_t> score;
+  vec<uint64_t> time_stamp; // Step of the last flip of each variable.
+
+  vec<int> unsat_hard;      // Falsified hard clauses.
+  vec<int> unsat_soft;      // Falsified soft clauses.
+  vec<int> unsat_index;     // Position of each clause in its list.
+  uint64_t unsat_weight;    // Weight of the falsified soft clauses.
+  vec<int> good_vars;       // Variables with positive score.
+  vec<int> good_index;      // Position of each variable in 'good_vars'.
+
+  int64_t hard_inc; // Increment of the weight of hard clauses.
+  uint64_t flips;
+  uint32_t random_state;
+
+  // Best model
+  std::mutex best_lock; // Protects 'best_model'.
+  vec<lbool> best_model;
+  std::atomic<uint64_t> best_cost;
+
+  std::atomic<bool> interrupted;
+  std::thread background;
+};
+
+} // namespace openwbo
+
+#endif
@@ -50,15 +50,22 @@
 #include "MaxSAT.h"
 #include "MaxTypes.h"
 #include "ParserMaxSAT.h"
+#include "ParserMaxSATParallel.h"
+#include "FormulaSnapshot.h"
 #include "ParserPB.h"
 
 // Algorithms
+#include "algorithms/Alg_BCD.h"
 #include "algorithms/Alg_LinearSU.h"
 #include "algorithms/Alg_MSU3.h"
 #include "algorithms/Alg_OLL.h"
 #include "algorithms/Alg_PartMSU3.h"
 #include "algorithms/Alg_WBO.h"
 #include "algorithms/Alg_Basic.h"
+#include "Decomposer.h"
+#include "LocalSearch.h"
+#include "Portfolio.h"
+#include "Preprocessor.h"
 
 #define VER1_(x) #x
 #define VER_(x) VER1_(x)
@@ -69,6 +76,8 @@ using NSPACE::cpuTime;
 using NSPACE::OutOfMemoryException;
 using NSPACE::IntOption;
 using NSPACE::BoolOption;
+using NSPACE::DoubleOption;
+using NSPACE::DoubleRange;
 using NSPACE::StringOption;
 using NSPACE::IntRange;
 using NSPACE::parseOptions;
@@ -117,9 +126,34 @@ int main(int argc, char **argv) {
 
     IntOption algorithm("Open-WBO", "algorithm",
                         "Search algorithm "
-                        "(0=wbo,1=linear-su,2=msu3,3=part-msu3,4=oll,5=best,6=basic)."
+                        "(0=wbo,1=linear-su,2=msu3,3=part-msu3,4=oll,5=best,6=basic,"
+                        "7=portfolio,8=bcd)."
                         "\n",
-                        5, IntRange(0, 6));
+                        5, IntRange(0, 8));
+
+    StringOption portfolio(
+        "Portfolio", "portfolio",
+        "Comma-separated list of the algorithms run in parallel by the "
+        "portfolio (default: 4,3,1,2 for unweighted and 4,1 for weighted "
+        "instances).\n",
+        NULL);
+
+    IntOption share_lbd("Portfolio", "share-lbd",
+                        "Maximum LBD of the learnt clauses shared between "
+                        "the threads of the portfolio (0=no sharing).\n",
+                        2, IntRange(0, INT32_MAX));
+
+    IntOption sat_threads("LinearSU", "sat-threads",
+                          "Number of diversified SAT solvers run in parallel "
+                          "in each SAT call (1=sequential).\n",
+                          1, IntRange(1, INT32_MAX));
+
+    IntOption sat_solver(
+        "Open-WBO", "sat-solver",
+        "SAT solver (0=glucose4.1, 1=glucose4.0, 2=minisat2.2) (native "
+        "cardinality constraints, -sat-threads and clause sharing need "
+        "glucose4.1).\n",
+        0, IntRange(0, 2));
 
     IntOption partition_strategy("PartMSU3", "partition-strategy",
                                  "Partition strategy (0=sequential, "
@@ -132,12 +166,77 @@ int main(int argc, char **argv) {
                          "based partition algorithms).",
                          2, IntRange(0, 2));
 
+    IntOption partition_threads(
+        "PartMSU3", "partition-threads",
+        "Number of threads used to solve independent subtrees of the guide "
+        "tree (1=sequential) (only for the binary partition strategy).",
+        1, IntRange(1, INT32_MAX));
+
+    IntOption community_mode(
+        "PartMSU3", "community-mode",
+        "Method used to find the communities of the graph (0=random, "
+        "1=unfolding, 2=label propagation) (only for unsat-based partition "
+        "algorithms).",
+        1, IntRange(0, 2));
+
+    IntOption community_threads(
+        "PartMSU3", "community-threads",
+        "Number of threads used to find the communities of the graph "
+        "(1=sequential) (only for unsat-based partition algorithms).",
+        1, IntRange(1, INT32_MAX));
+
+    BoolOption decompose(
+        "Open-WBO", "decompose",
+        "Solve the connected components of the formula independently.\n",
+        false);
+
+    IntOption decompose_threads(
+        "Open-WBO", "decompose-threads",
+        "Number of threads used to solve the connected components (only "
+        "with -decompose).\n",
+        1, IntRange(1, INT32_MAX));
+
+    DoubleOption ls_time(
+        "Open-WBO", "ls-time",
+        "Time in seconds of the local search run before the main algorithm "
+        "to find an initial upper bound (0=off).\n",
+        0, DoubleRange(0, true, HUGE_VAL, false));
+
+    BoolOption ls_background(
+        "Open-WBO", "ls-background",
+        "Keep the local search running in a background thread during the "
+        "search.\n",
+        false);
+
+    BoolOption wce("OLL", "wce",
+                   "Delay the encoding of the cores of each stratum until the "
+                   "assumptions are satisfiable (weighted instances).\n",
+                   false);
+
+    BoolOption exhaust("OLL", "exhaust",
+                       "Raise the bound of each new cardinality constraint "
+                       "while it is unsatisfiable (weighted instances).\n",
+                       false);
+
+    IntOption core_trim(
+        "Cores", "core-trim",
+        "Maximum number of rounds of trimming of each core in the core-guided "
+        "algorithms (0=off).\n",
+        0, IntRange(0, INT32_MAX));
+
+    IntOption core_min_budget(
+        "Cores", "core-min-budget",
+        "Conflict budget of each SAT call of the minimization of cores in the "
+        "core-guided algorithms (0=off).\n",
+        0, IntRange(0, INT32_MAX));
+
     BoolOption bmo("Open-WBO", "bmo", "BMO search.\n", true);
 
     IntOption cardinality("Encodings", "cardinality",
                           "Cardinality encoding (0=cardinality networks, "
-                          "1=totalizer, 2=modulo totalizer).\n",
-                          1, IntRange(0, 2));
+                          "1=totalizer, 2=modulo totalizer, 3=native; OLL "
+                          "and weighted PartMSU3 use the totalizer).\n",
+                          1, IntRange(0, 3));
 
     IntOption amo("Encodings", "amo", "AMO encoding (0=Ladder).\n", 0,
                   IntRange(0, 0));
@@ -148,6 +247,24 @@ int main(int argc, char **argv) {
     IntOption formula("Open-WBO", "formula",
                       "Type of formula (0=WCNF, 1=OPB).\n", 0, IntRange(0, 1));
 
+    IntOption parse_threads(
+        "Open-WBO", "parse-threads",
+        "Number of threads for parsing uncompressed WCNF files "
+        "(0=sequential parser).\n",
+        4, IntRange(0, 256));
+
+    StringOption write_snapshot(
+        "Open-WBO", "write-snapshot",
+        "Write a binary snapshot of the parsed formula to this file and "
+        "exit.\n",
+        NULL);
+
+    BoolOption preprocess(
+        "Open-WBO", "preprocess",
+        "Simplify the hard clauses with variable elimination and subsumption "
+        "before the search.\n",
+        false);
+
     IntOption weight(
         "WBO", "weight-strategy",
         "Weight strategy (0=none, 1=weight-based, 2=diversity-based).\n", 2,
@@ -162,43 +279,56 @@ int main(int argc, char **argv) {
 
     parseOptions(argc, argv, true);
 
-    double initial_time = cpuTime();
-    MaxSAT *S = NULL;
-
-    switch ((int)algorithm) {
-    case _ALGORITHM_WBO_:
-      S = new WBO(verbosity, weight, symmetry, symmetry_lim);
-      break;
-
-    case _ALGORITHM_LINEAR_SU_:
-      S = new LinearSU(verbosity, bmo, cardinality, pb);
-      break;
-
-    case _ALGORITHM_PART_MSU3_:
-      S = new PartMSU3(verbosity, partition_strategy, graph_type, cardinality);
-      break;
-
-    case _ALGORITHM_MSU3_:
-      S = new MSU3(verbosity);
-      break;
-
-    case _ALGORITHM_OLL_:
-      S = new OLL(verbosity, cardinality);
-      break;
-
-    case _ALGORITHM_BASIC_:
-      S = new Basic();
-      break;
-
-    case _ALGORITHM_BEST_:
-      break;
-
-    default:
-      printf("c Error: Invalid MaxSAT algorithm.\n");
+    if (sat_solver != _SAT_GLUCOSE41_ &&
+        (cardinality == _CARD_NATIVE_ || sat_threads > 1)) {
+      printf("c Error: Native cardinality constraints and -sat-threads are "
+             "only supported by glucose4.1.\n");
       printf("s UNKNOWN\n");
       exit(_ERROR_);
     }
 
+    double initial_time = cpuTime();
+    MaxSAT *S = NULL;
+
+    auto newAlgorithm = [&](int alg, int verb) -> MaxSAT * {
+      switch (alg) {
+      case _ALGORITHM_WBO_:
+        return new WBO(verb, weight, symmetry, symmetry_lim);
+      case _ALGORITHM_LINEAR_SU_: {
+        LinearSU *linear = new LinearSU(verb, bmo, cardinality, pb);
+        linear->setSATThreads(sat_threads);
+        return linear;
+      }
+      case _ALGORITHM_PART_MSU3_: {
+        PartMSU3 *part =
+            new PartMSU3(verb, partition_strategy, graph_type, cardinality);
+        part->setCommunityMode(community_mode);
+        part->setCommunityThreads(community_threads);
+        part->setThreads(partition_threads);
+        return part;
+      }
+      case _ALGORITHM_MSU3_:
+        // MSU3 uses the totalizer unless native constraints are requested.
+        return new MSU3(verb, cardinality == _CARD_NATIVE_ ? _CARD_NATIVE_
+                                                           : _CARD_TOTALIZER_);
+      case _ALGORITHM_OLL_: {
+        // OLL relaxes the totalizer outputs, which native constraints lack.
+        OLL *oll = new OLL(verb, _CARD_TOTALIZER_);
+        oll->setWCE(wce);
+        oll->setExhaust(exhaust);
+        return oll;
+      }
+      case _ALGORITHM_BASIC_:
+        return new Basic();
+      case _ALGORITHM_BCD_:
+        return new BCD(verb);
+      default:
+        printf("c Error: Invalid MaxSAT algorithm.\n");
+        printf("s UNKNOWN\n");
+        exit(_ERROR_);
+      }
+    };
+
     signal(SIGXCPU, SIGINT_exit);
     signal(SIGTERM, SIGINT_exit);
 
@@ -216,8 +346,17 @@ int main(int argc, char **argv) {
 
     MaxSATFormula *maxsat_formula = new MaxSATFormula();
 
-    if ((int)formula == _FORMAT_MAXSAT_) {
-      parseMaxSATFormula(in, maxsat_formula);
+    if (FormulaSnapshot::isSnapshot(argv[1])) {
+      FormulaSnapshot::load(argv[1], maxsat_formula);
+    } else if ((int)formula == _FORMAT_MAXSAT_) {
+      bool parsed = false;
+      if (parse_threads > 0) {
+        ParserMaxSATParallel parser(parse_threads);
+        parsed = parser.parse(argv[1], maxsat_formula);
+      }
+      // Compressed files are parsed with the sequential parser.
+      if (!parsed)
+        parseMaxSATFormula(in, maxsat_formula);
       maxsat_formula->setFormat(_FORMAT_MAXSAT_);
     } else {
       ParserPB *parser_pb = new ParserPB();
@@ -226,6 +365,12 @@ int main(int argc, char **argv) {
     }
     gzclose(in);
 
+    if (write_snapshot != NULL) {
+      FormulaSnapshot::write(write_snapshot, maxsat_formula);
+      printf("c Snapshot written to %s\n", (const char *)write_snapshot);
+      exit(0);
+    }
+
     printf("c |                                                                "
            "                                       |\n");
     printf("c ========================================[ Problem Statistics "
@@ -273,39 +418,132 @@ int main(int argc, char **argv) {
     printf("c |  Parse time:           %12.2f s                                "
            "                                 |\n",
            parsed_time - initial_time);
-    printf("c |                                                                "
-           "                                       |\n");
-
-    if (algorithm == _ALGORITHM_BEST_) {
-      assert(S == NULL);
-
-      if (maxsat_formula->getProblemType() == _UNWEIGHTED_) {
-        // Unweighted
-        S = new PartMSU3(_VERBOSITY_MINIMAL_, _PART_BINARY_, RES_GRAPH,
-                         cardinality);
-        S->loadFormula(maxsat_formula);
-
-        if (((PartMSU3 *)S)->chooseAlgorithm() == _ALGORITHM_MSU3_) {
-          // FIXME: possible memory leak
-          S = new MSU3(_VERBOSITY_MINIMAL_);
-        }
 
+    Preprocessor *preprocessor = NULL;
+    if (preprocess) {
+      preprocessor = new Preprocessor();
+      if (preprocessor->simplify(maxsat_formula)) {
+        printf("c |  Eliminated variables: %12d                                    "
+               "                               |\n",
+               preprocessor->nEliminated());
+        printf("c |  Simplified hard clauses:   %7d                                "
+               "                                   |\n",
+               maxsat_formula->nHard());
+        printf("c |  Preprocess time:      %12.2f s                                "
+               "                                 |\n",
+               cpuTime() - parsed_time);
       } else {
-        // Weighted
-        S = new OLL(_VERBOSITY_MINIMAL_, cardinality);
+        // The hard clauses are unsatisfiable and were left unchanged.
+        delete preprocessor;
+        preprocessor = NULL;
       }
     }
+    printf("c |                                                                "
+           "                                       |\n");
 
-    if (S->getMaxSATFormula() == NULL)
+    // Returns the selected algorithm with 'formula' loaded.
+    auto newSolver = [&](MaxSATFormula *formula) -> MaxSAT * {
+      MaxSAT *A = NULL;
+
+      if (algorithm == _ALGORITHM_BEST_) {
+        if (formula->getProblemType() == _UNWEIGHTED_) {
+          // Unweighted
+          A = new PartMSU3(_VERBOSITY_MINIMAL_, _PART_BINARY_, RES_GRAPH,
+                           cardinality);
+          ((PartMSU3 *)A)->setCommunityMode(community_mode);
+          ((PartMSU3 *)A)->setCommunityThreads(community_threads);
+          ((PartMSU3 *)A)->setThreads(partition_threads);
+          A->loadFormula(formula);
+
+          if (((PartMSU3 *)A)->chooseAlgorithm() == _ALGORITHM_MSU3_) {
+            // FIXME: possible memory leak
+            A = new MSU3(_VERBOSITY_MINIMAL_, cardinality == _CARD_NATIVE_
+                                                  ? _CARD_NATIVE_
+                                                  : _CARD_TOTALIZER_);
+          }
+
+        } else {
+          // Weighted
+          A = new OLL(_VERBOSITY_MINIMAL_, _CARD_TOTALIZER_);
+          ((OLL *)A)->setWCE(wce);
+          ((OLL *)A)->setExhaust(exhaust);
+        }
+      } else if (algorithm == _ALGORITHM_PORTFOLIO_) {
+        const char *list = portfolio;
+        if (list == NULL)
+          list = formula->getProblemType() == _UNWEIGHTED_ ? "4,3,1,2"
+                                                           : "4,1";
+
+        Portfolio *P = new Portfolio(verbosity);
+        P->setShareLBD(share_lbd);
+        for (const char *c = list; *c != '\0'; c++) {
+          if (*c == ',')
+            continue;
+          if (*c < '0' || *c > '9' || (c[1] != ',' && c[1] != '\0') ||
+              *c - '0' == _ALGORITHM_BEST_ ||
+              *c - '0' == _ALGORITHM_PORTFOLIO_) {
+            printf("c Error: Invalid portfolio: %s\n", list);
+            printf("s UNKNOWN\n");
+            exit(_ERROR_);
+          }
+          MaxSAT *W = newAlgorithm(*c - '0', _VERBOSITY_MINIMAL_);
+          W->setCoreReduction(core_trim, core_min_budget);
+          W->setSATSolver(sat_solver);
+          P->addAlgorithm(W, *c - '0');
+        }
+        A = P;
+      } else
+        A = newAlgorithm(algorithm, verbosity);
+
+      if (A->getMaxSATFormula() == NULL)
+        A->loadFormula(formula);
+      A->setSATSolver(sat_solver);
+      // The portfolio itself extracts no cores; its workers are set above.
+      if (algorithm != _ALGORITHM_PORTFOLIO_)
+        A->setCoreReduction(core_trim, core_min_budget);
+      return A;
+    };
+
+    if (decompose) {
+      S = new Decomposer(newSolver, decompose_threads, verbosity);
       S->loadFormula(maxsat_formula);
+    } else
+      S = newSolver(maxsat_formula);
+
+    S->setPreprocessor(preprocessor);
     S->setPrintModel(printmodel);
     S->setPrintSoft((const char *)printsoft);
     S->setInitialTime(initial_time);
     mxsolver = S;
     mxsolver->setPrint(true);
 
+    // The local search works on a copy of the clauses of the formula that is
+    // given to the algorithm, after the preprocessing.
+    LocalSearch *local_search = NULL;
+    if ((ls_time > 0 || ls_background) &&
+        LocalSearch::supports(S->getMaxSATFormula())) {
+      local_search = new LocalSearch(S->getMaxSATFormula());
+      S->setLocalSearch(local_search);
+
+      if (ls_time > 0) {
+        double ls_start = cpuTime();
+        if (local_search->search(ls_time))
+          printf("c LS : %-12" PRIu64 " flips : %-12" PRIu64 " time : %.2f s\n",
+                 local_search->getBestCost() + S->getOffSet(),
+                 local_search->nFlips(), cpuTime() - ls_start);
+        else
+          printf("c LS : no model after %" PRIu64 " flips\n",
+                 local_search->nFlips());
+      }
+
+      if (ls_background)
+        local_search->startBackground();
+    }
+
     int ret = (int)mxsolver->search();
+    delete local_search;
     delete S;
+    delete preprocessor;
     return ret;
   } catch (OutOfMemoryException &) {
     sleep(1);
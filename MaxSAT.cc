@@ -26,6 +26,9 @@
  */
 
 #include "MaxSAT.h"
+#include "LocalSearch.h"
+#include "Portfolio.h"
+#include "Preprocessor.h"
 
 #include <sstream>
 
@@ -54,61 +57,113 @@ void MaxSAT::setInitialTime(double initial) {
  ************************************************************************************************/
 
 // Creates an empty SAT Solver.
-Solver *MaxSAT::newSATSolver() {
+SATBackend *MaxSAT::newSATSolver() {
+  // Clause sharing and parallel SAT calls rely on glucose 4.1.
+  if (sat_solver != _SAT_GLUCOSE41_)
+    return SATBackend::create(sat_solver);
+
+#ifdef CLAUSE_SHARING
+  if (portfolio_worker != NULL) {
+    Solver *S = portfolio_worker->newSATSolver();
+    if (S != NULL)
+      return new NativeBackend(S);
+  }
 
-#ifdef SIMP
-  NSPACE::SimpSolver *S = new NSPACE::SimpSolver();
-#else
-  Solver *S = new Solver();
+  // The helpers of a MultiSolver are kept in sync through the virtual
+  // methods of the solver, which only glucose 4.1 provides.
+  if (sat_threads > 1)
+    return new NativeBackend(new MultiSolver(sat_threads));
 #endif
 
-  return (Solver *)S;
+  return SATBackend::create(_SAT_GLUCOSE41_);
 }
 
 // Creates a new variable in the SAT solver.
-void MaxSAT::newSATVariable(Solver *S) {
+void MaxSAT::newSATVariable(SATBackend *S) { S->newVar(); }
 
-#ifdef SIMP
-  ((NSPACE::SimpSolver *)S)->newVar();
-#else
-  S->newVar();
-#endif
+// Adds all hard clauses of the MaxSAT formula to the SAT solver.
+void MaxSAT::addHardClauses(SATBackend *S) {
+  vec<Lit> clause;
+  for (int i = 0; i < maxsat_formula->nHard(); i++) {
+    maxsat_formula->getHardClause(i).clause.copyTo(clause);
+    S->addClause(clause);
+  }
 }
 
 // Makes sure the underlying SAT solver has the given amount of variables
 // reserved.
-void MaxSAT::reserveSATVariables(Solver *S, unsigned maxVariable) {
+void MaxSAT::reserveSATVariables(SATBackend *S, unsigned maxVariable) {
 #ifdef SAT_HAS_RESERVATION
+  if (S->native() == NULL)
+    return;
 #ifdef SIMP
-  ((NSPACE::SimpSolver *)S)->reserveVars(maxVariable);
+  ((NSPACE::SimpSolver *)S->native())->reserveVars(maxVariable);
 #else
-  S->reserveVars(maxVariable);
+  S->native()->reserveVars(maxVariable);
 #endif
 #endif
 }
 
-// Solve the formula that is currently loaded in the SAT solver with a set of
-// assumptions and with the option to use preprocessing for 'simp'.
-lbool MaxSAT::searchSATSolver(Solver *S, vec<Lit> &assumptions, bool pre) {
+// Copies the units and the learnt clauses with LBD at most 'max_lbd' of 'from'
+// over the variables of the MaxSAT formula into 'to', and merges their
+// activities and saved phases. Both solvers must contain the clauses of the
+// MaxSAT formula, and the other clauses of 'from' must only define auxiliary
+// variables. Does nothing if the SAT solver does not support it.
+void MaxSAT::transferSearchState(SATBackend *from_backend,
+                                 SATBackend *to_backend, unsigned max_lbd) {
+#ifdef SEARCH_STATE_TRANSFER
+  Solver *from = from_backend->native();
+  Solver *to = to_backend->native();
+  if (from == NULL || to == NULL)
+    return;
+
+  int n = maxsat_formula->nVars();
+  assert(from->nVars() >= n && to->nVars() >= n);
+
+  vec<vec<Lit>> learnts;
+  from->exportLearnts(learnts, max_lbd, n);
+  for (int i = 0; i < learnts.size(); i++)
+    if (!to->addClause(learnts[i]))
+      break;
 
-// Currently preprocessing is disabled by default.
-// Variable elimination cannot be done on relaxation variables nor on variables
-// that belong to soft clauses. To preprocessing to be used those variables
-// should be frozen.
+  vec<double> activity;
+  vec<char> phase;
+  from->exportHeuristic(activity, phase, n);
+  to->importHeuristic(activity, phase);
 
-#ifdef SIMP
-  lbool res = ((NSPACE::SimpSolver *)S)->solveLimited(assumptions, pre);
-#else
-  lbool res = S->solveLimited(assumptions);
+  if (verbosity > 0)
+    printf("c Transferred %d learnt clauses\n", learnts.size());
 #endif
+}
+
+// Stops exporting the learnt clauses to the other threads of the portfolio.
+// Must be called before adding clauses that only hold for the models that
+// improve the upper bound, e.g. when hardening soft clauses.
+void MaxSAT::stopClauseExport() {
+  if (portfolio_worker != NULL)
+    portfolio_worker->stopExport();
+}
+
+// Solve the formula that is currently loaded in the SAT solver with a set of
+// assumptions.
+lbool MaxSAT::searchSATSolver(SATBackend *S, vec<Lit> &assumptions) {
+  importUpperBound();
+
+  if (portfolio_worker != NULL)
+    portfolio_worker->beginSearch(S, lbCost);
+
+  lbool res = S->solve(assumptions);
+
+  if (portfolio_worker != NULL)
+    portfolio_worker->endSearch();
 
   return res;
 }
 
 // Solve the formula without assumptions.
-lbool MaxSAT::searchSATSolver(Solver *S, bool pre) {
+lbool MaxSAT::searchSATSolver(SATBackend *S) {
   vec<Lit> dummy; // Empty set of assumptions.
-  return searchSATSolver(S, dummy, pre);
+  return searchSATSolver(S, dummy);
 }
 
 /************************************************************************************************
@@ -131,6 +186,7 @@ lbool MaxSAT::searchSATSolver(Solver *S, bool pre) {
   |
   |  Post-conditions:
   |    * 'model' is updated to the current model.
+  |    * In a portfolio thread, the model is published to the portfolio.
   |
   |________________________________________________________________________________________________@*/
 void MaxSAT::saveModel(vec<lbool> &currentModel) {
@@ -142,6 +198,43 @@ void MaxSAT::saveModel(vec<lbool> &currentModel) {
   // original MaxSAT formula.
   for (int i = 0; i < maxsat_formula->nInitialVars(); i++)
     model.push(currentModel[i]);
+
+  if (portfolio_worker != NULL)
+    portfolio_worker->publishModel(model);
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  importUpperBound : [void]  ->  [void]
+  |
+  |  Description:
+  |
+  |    Replaces 'model' by the best model of the local search if there is no
+  |    model yet or if it has a lower cost. Models are only imported by the
+  |    thread that registered the local search, since the other threads of an
+  |    algorithm may be using 'model' concurrently.
+  |
+  |  Post-conditions:
+  |    * 'model' and 'ubCost' are updated if the model is imported.
+  |
+  |________________________________________________________________________________________________@*/
+void MaxSAT::importUpperBound() {
+  if (local_search == NULL ||
+      std::this_thread::get_id() != local_search_thread)
+    return;
+
+  if (model.size() != 0 && local_search->getBestCost() >= ubCost)
+    return;
+
+  vec<lbool> ls_model;
+  uint64_t cost;
+  if (!local_search->getBestModel(ls_model, cost) ||
+      (model.size() != 0 && cost >= ubCost))
+    return;
+
+  saveModel(ls_model);
+  ubCost = cost;
+  printBound(ubCost + off_set);
 }
 
 /*_________________________________________________________________________________________________
@@ -155,45 +248,15 @@ void MaxSAT::saveModel(vec<lbool> &currentModel) {
   |    the weights of the unsatisfied soft clauses.
   |    If a weight is specified, then it only considers the sum of the weights
   |    of the unsatisfied soft clauses with the specified weight.
+  |    The cost is computed incrementally from the previous call (see
+  |    CostEvaluator).
   |
   |  Pre-conditions:
   |    * Assumes that 'currentModel' is not empty.
   |
   |________________________________________________________________________________________________@*/
 uint64_t MaxSAT::computeCostModel(vec<lbool> &currentModel, uint64_t weight) {
-
-  assert(currentModel.size() != 0);
-  uint64_t currentCost = 0;
-
-  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-    bool unsatisfied = true;
-    for (int j = 0; j < maxsat_formula->getSoftClause(i).clause.size(); j++) {
-
-      if (weight != UINT64_MAX &&
-          maxsat_formula->getSoftClause(i).weight != weight) {
-        unsatisfied = false;
-        continue;
-      }
-
-      assert(var(maxsat_formula->getSoftClause(i).clause[j]) <
-             currentModel.size());
-      if ((sign(maxsat_formula->getSoftClause(i).clause[j]) &&
-           currentModel[var(maxsat_formula->getSoftClause(i).clause[j])] ==
-               l_False) ||
-          (!sign(maxsat_formula->getSoftClause(i).clause[j]) &&
-           currentModel[var(maxsat_formula->getSoftClause(i).clause[j])] ==
-               l_True)) {
-        unsatisfied = false;
-        break;
-      }
-    }
-
-    if (unsatisfied) {
-      currentCost += maxsat_formula->getSoftClause(i).weight;
-    }
-  }
-
-  return currentCost;
+  return cost_evaluator.cost(maxsat_formula, currentModel, weight);
 }
 
 /*_________________________________________________________________________________________________
@@ -315,6 +378,12 @@ void MaxSAT::print_Card_configuration(int encoding) {
            "Modulo Totalizer");
     break;
 
+  case _CARD_NATIVE_:
+    printf("c |  Cardinality Encoding: %12s                                "
+           "                                   |\n",
+           "Native");
+    break;
+
   default:
     printf("c Error: Invalid cardinality encoding.\n");
     printf("s UNKNOWN\n");
@@ -322,7 +391,7 @@ void MaxSAT::print_Card_configuration(int encoding) {
   }
 }
 
-void MaxSAT::blockModel(Solver *solver) {
+void MaxSAT::blockModel(SATBackend *solver) {
   assert(model.size() != 0);
 
   vec<Lit> blocking;
@@ -349,6 +418,11 @@ void MaxSAT::printBound(int64_t bound)
 {
   if(!print) return;
 
+  // Bounds from the local search and from the algorithm are interleaved, so
+  // only improving bounds are printed.
+  if (bound >= last_bound) return;
+  last_bound = bound;
+
   // print bound only, if its below the hard weight
   // FIXME: possible issue for PB instances when bound is negative; in MaxSAT bound is always positive
   if( bound < maxsat_formula->getHardWeight() ) printf("o %" PRId64 "\n", bound);
@@ -403,30 +477,12 @@ void MaxSAT::printUnsatisfiedSoftClauses() {
   assert (model.size() != 0);
 
   std::stringstream s;
-  int soft_size = 0;
-  
-  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-    bool unsatisfied = true;
-    for (int j = 0; j < maxsat_formula->getSoftClause(i).clause.size(); j++) {
-
-      assert(var(maxsat_formula->getSoftClause(i).clause[j]) <
-             model.size());
-      if ((sign(maxsat_formula->getSoftClause(i).clause[j]) &&
-           model[var(maxsat_formula->getSoftClause(i).clause[j])] ==
-               l_False) ||
-          (!sign(maxsat_formula->getSoftClause(i).clause[j]) &&
-           model[var(maxsat_formula->getSoftClause(i).clause[j])] ==
-               l_True)) {
-        unsatisfied = false;
-        break;
-      }
-    }
+  vec<int> falsified;
+  cost_evaluator.falsified(maxsat_formula, model, falsified);
+  for (int i = 0; i < falsified.size(); i++)
+    s << printSoftClause(falsified[i]);
+  int soft_size = falsified.size();
 
-    if (unsatisfied) {
-      s << printSoftClause(i);
-      soft_size++;
-    }
-  }
   FILE * file = fopen (getPrintSoftFilename(),"w");
   fprintf(file,"p cnf %d %d\n",maxsat_formula->nInitialVars(),soft_size);
   fprintf(file,"%s", s.str().c_str());
@@ -449,6 +505,7 @@ void MaxSAT::printStats() {
   printf("c  Nb UNSAT calls:         %12d\n", nbCores);
   printf("c  Average core size:      %12.2f\n", avgCoreSize);
   printf("c  Nb symmetry clauses:    %12d\n", nbSymmetryClauses);
+  core_minimizer.printStats();
   printf("c\n");
 }
 
@@ -457,9 +514,16 @@ void MaxSAT::printAnswer(int type) {
   if (verbosity > 0 && print)
     printStats();
 
+  if (type == _UNKNOWN_ || type == _SATISFIABLE_)
+    importUpperBound();
+
   if (type == _UNKNOWN_ && model.size() > 0)
     type = _SATISFIABLE_;
 
+  // The search only assigns the variables of the simplified formula.
+  if (preprocessor != NULL && model.size() > 0)
+    preprocessor->extendModel(model);
+
   // store type in member variable
   searchStatus = (StatusCode)type;
   if(!print) return;
@@ -492,7 +556,7 @@ void MaxSAT::printAnswer(int type) {
 
 uint64_t MaxSAT::getUB() {
   // only works for partial MaxSAT currently
-  Solver *solver = newSATSolver();
+  SATBackend *solver = newSATSolver();
 
   vec<Lit> relaxation_vars;
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
@@ -503,8 +567,7 @@ uint64_t MaxSAT::getUB() {
   for (int i = 0; i < maxsat_formula->nVars() + maxsat_formula->nSoft(); i++)
     newSATVariable(solver);
 
-  for (int i = 0; i < maxsat_formula->nHard(); i++)
-    solver->addClause(maxsat_formula->getHardClause(i).clause);
+  addHardClauses(solver);
 
   vec<Lit> clause;
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
@@ -521,12 +584,12 @@ uint64_t MaxSAT::getUB() {
   }
 
   int limit = 1000;
-  solver->setConfBudget(limit);
+  solver->limit(limit);
 
   vec<Lit> dummy;
   lbool res = searchSATSolver(solver, dummy);
   if (res == l_True) {
-    uint64_t ub = computeCostModel(solver->model);
+    uint64_t ub = computeCostModel(solver->model());
     return ub;
   } else if (res == l_False) {
     printAnswer(_UNSATISFIABLE_);
@@ -538,7 +601,7 @@ uint64_t MaxSAT::getUB() {
 
 std::pair<uint64_t, int> MaxSAT::getLB() {
   // only works for partial MaxSAT currently
-  Solver *solver = newSATSolver();
+  SATBackend *solver = newSATSolver();
 
   vec<Lit> relaxation_vars;
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
@@ -549,8 +612,7 @@ std::pair<uint64_t, int> MaxSAT::getLB() {
   for (int i = 0; i < maxsat_formula->nVars() + maxsat_formula->nSoft(); i++)
     newSATVariable(solver);
 
-  for (int i = 0; i < maxsat_formula->nHard(); i++)
-    solver->addClause(maxsat_formula->getHardClause(i).clause);
+  addHardClauses(solver);
 
   vec<Lit> clause;
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
@@ -582,12 +644,12 @@ std::pair<uint64_t, int> MaxSAT::getLB() {
   }
 
   while (res == l_False) {
-    solver->setConfBudget(limit);
+    solver->limit(limit);
     res = searchSATSolver(solver, assumptions);
     if (res == l_False) {
 
-      for (int i = 0; i < solver->conflict.size(); i++) {
-        Lit p = solver->conflict[i];
+      for (int i = 0; i < solver->conflict().size(); i++) {
+        Lit p = solver->conflict()[i];
         if (core.find(p) != core.end()) {
           assert(!active[core[p]]);
           active[core[p]] = true;
@@ -36,12 +36,18 @@
 #include "core/Solver.h"
 #endif
 
+#include "CoreMinimizer.h"
+#include "CostEvaluator.h"
 #include "MaxSATFormula.h"
 #include "MaxTypes.h"
+#include "MultiSolver.h"
+#include "SATBackend.h"
+#include "SolverSession.h"
 #include "utils/System.h"
 #include <algorithm>
 #include <map>
 #include <set>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -55,6 +61,10 @@ using NSPACE::cpuTime;
 
 namespace openwbo {
 
+class LocalSearch;
+class PortfolioWorker;
+class Preprocessor;
+
 class MaxSAT {
 
 public:
@@ -81,6 +91,12 @@ public:
     print_soft = false;
     print = false;
     unsat_soft_file = NULL;
+    portfolio_worker = NULL;
+    preprocessor = NULL;
+    local_search = NULL;
+    last_bound = INT64_MAX;
+    sat_threads = 1;
+    sat_solver = _SAT_GLUCOSE41_;
   }
 
   MaxSAT() {
@@ -105,6 +121,12 @@ public:
     print_soft = false;
     print = false;
     unsat_soft_file = NULL;
+    portfolio_worker = NULL;
+    preprocessor = NULL;
+    local_search = NULL;
+    last_bound = INT64_MAX;
+    sat_threads = 1;
+    sat_solver = _SAT_GLUCOSE41_;
   }
 
   virtual ~MaxSAT() {
@@ -144,14 +166,14 @@ public:
     ubCost = maxsat_formula->getSumWeights();
   }
 
-  void blockModel(Solver *solver);
+  void blockModel(SATBackend *solver);
 
   // Get bounds methods
   uint64_t getUB();
   std::pair<uint64_t, int> getLB();
 
-  Soft &getSoftClause(int i) { return maxsat_formula->getSoftClause(i); }
-  Hard &getHardClause(int i) { return maxsat_formula->getHardClause(i); }
+  Soft getSoftClause(int i) { return maxsat_formula->getSoftClause(i); }
+  Hard getHardClause(int i) { return maxsat_formula->getHardClause(i); }
   Lit getAssumptionLit(int soft) {
     return maxsat_formula->getSoftClause(soft).assumption_var;
   }
@@ -179,6 +201,34 @@ public:
   bool isPrintSoft() { return print_soft; }
   char * getPrintSoftFilename() { return unsat_soft_file; }
 
+  // Reports models, lower bounds and SAT calls to a portfolio thread.
+  void setPortfolioWorker(PortfolioWorker *worker) {
+    portfolio_worker = worker;
+  }
+
+  // Trims the cores with up to 'trim' rounds and minimizes them with a
+  // budget of 'budget' conflicts per SAT call (see CoreMinimizer).
+  void setCoreReduction(int trim, int budget) {
+    core_minimizer.setTrimRounds(trim);
+    core_minimizer.setBudget(budget);
+  }
+
+  // Runs each SAT call with 'threads' diversified solvers (see MultiSolver).
+  void setSATThreads(int threads) { sat_threads = threads; }
+
+  // Uses SAT solvers of type 'solver' (see SATBackend::create).
+  void setSATSolver(int solver) { sat_solver = solver; }
+
+  // Extends the final model to the variables eliminated by 'pre'.
+  void setPreprocessor(Preprocessor *pre) { preprocessor = pre; }
+
+  // Imports the models found by 'ls' as upper bounds. The models are only
+  // imported by the thread that calls this method.
+  void setLocalSearch(LocalSearch *ls) {
+    local_search = ls;
+    local_search_thread = std::this_thread::get_id();
+  }
+
   /** return status of current search
    *
    *  This method helps to extract the status in case the solver is used as a
@@ -203,14 +253,27 @@ public:
 protected:
   // Interface with the SAT solver
   //
-  Solver *newSATSolver(); // Creates a SAT solver.
+  SATBackend *newSATSolver(); // Creates a SAT solver.
   // Solves the formula that is currently loaded in the SAT solver.
-  lbool searchSATSolver(Solver *S, vec<Lit> &assumptions, bool pre = false);
-  lbool searchSATSolver(Solver *S, bool pre = false);
+  lbool searchSATSolver(SATBackend *S, vec<Lit> &assumptions);
+  lbool searchSATSolver(SATBackend *S);
+
+  void newSATVariable(SATBackend *S); // Creates a new variable in the SAT solver.
+
+  void reserveSATVariables(SATBackend *S, unsigned maxVariable); // Reserve space for multiple variables in the SAT solver.
 
-  void newSATVariable(Solver *S); // Creates a new variable in the SAT solver.
+  void addHardClauses(SATBackend *S); // Adds the hard clauses to the SAT solver.
 
-  void reserveSATVariables(Solver *S, unsigned maxVariable); // Reserve space for multiple variables in the SAT solver.
+  // Warm-starts 'to' with the learnt clauses and heuristic state of 'from'.
+  void transferSearchState(SATBackend *from, SATBackend *to,
+                           unsigned max_lbd = 3);
+
+  // Stops sharing learnt clauses with the other portfolio threads. Called
+  // before adding clauses that are not implied by the hard clauses.
+  void stopClauseExport();
+
+  // SAT solver kept alive across the phases of the algorithm.
+  SolverSession session;
 
   // Properties of the MaxSAT formula
   //
@@ -224,6 +287,8 @@ protected:
   uint64_t sumSizeCores; // Sum of the sizes of cores.
   int nbSatisfiable;     // Number of satisfiable calls.
 
+  CoreMinimizer core_minimizer; // Reduction of the cores of the SAT solver.
+
   // Bound values
   //
   uint64_t ubCost; // Upper bound value.
@@ -240,6 +305,13 @@ protected:
   bool print;         // Controls if data should be printed at all
   bool print_soft;    // Controls if the unsatified soft clauses are printed at the end.
   char * unsat_soft_file;  // Name of the file where the unsatisfied soft clauses will be printed.
+  PortfolioWorker *portfolio_worker; // Portfolio thread running this solver.
+  Preprocessor *preprocessor; // Preprocessor that simplified the formula.
+  LocalSearch *local_search;  // Source of upper bounds (not owned).
+  std::thread::id local_search_thread; // Thread that imports its models.
+  int64_t last_bound;         // Last bound printed.
+  int sat_threads;            // Solvers used in each SAT call.
+  int sat_solver;             // Type of the SAT solvers (see MaxTypes.h).
 
   // Different weights that corresponds to each function in the BMO algorithm.
   std::vector<uint64_t> orderWeights;
@@ -247,9 +319,12 @@ protected:
   // Utils for model management
   //
   void saveModel(vec<lbool> &currentModel); // Saves a Model.
+  // Replaces 'model' by the model of 'local_search' if it is better.
+  void importUpperBound();
   // Compute the cost of a model.
   uint64_t computeCostModel(vec<lbool> &currentModel,
                             uint64_t weight = UINT64_MAX);
+  CostEvaluator cost_evaluator; // Incremental evaluation of model costs.
 
   // Utils for printing
   //
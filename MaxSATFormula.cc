@@ -26,25 +26,53 @@
  */
 
 #include <iostream>
+#include <sys/mman.h>
 
 #include "MaxSATFormula.h"
 
 using namespace openwbo;
 
-MaxSATFormula *MaxSATFormula::copyMaxSATFormula() {
-  assert(format == _FORMAT_MAXSAT_);
+MaxSATFormula::~MaxSATFormula() {
+  if (snapshot_map != NULL)
+    munmap(snapshot_map, snapshot_size);
+}
 
+// Copies the clauses and constraints of the formula. The objective function
+// of PB formulas is not copied: it is converted to soft clauses when the
+// formula is loaded, so the copy should be made after loading.
+MaxSATFormula *MaxSATFormula::copyMaxSATFormula() {
   MaxSATFormula *copymx = new MaxSATFormula();
   copymx->setInitialVars(nVars());
 
   for (int i = 0; i < nVars(); i++)
     copymx->newVar();
 
-  for (int i = 0; i < nSoft(); i++)
-    copymx->addSoftClause(getSoftClause(i).weight, getSoftClause(i).clause);
+  vec<Lit> clause;
+  copymx->reserveSoft(nSoft(), soft_arena.nLits());
+  for (int i = 0; i < nSoft(); i++) {
+    getSoftClause(i).clause.copyTo(clause);
+    copymx->addSoftClause(getSoftClause(i).weight, clause);
+  }
+
+  copymx->reserveHard(nHard(), hard_arena.nLits());
+  for (int i = 0; i < nHard(); i++) {
+    getHardClause(i).clause.copyTo(clause);
+    copymx->addHardClause(clause);
+  }
+
+  for (int i = 0; i < nCard(); i++)
+    copymx->cardinality_constraints.push(
+        new Card(cardinality_constraints[i]->_lits,
+                 cardinality_constraints[i]->_rhs));
+
+  for (int i = 0; i < nPB(); i++)
+    copymx->pb_constraints.push(
+        new PB(pb_constraints[i]->_lits, pb_constraints[i]->_coeffs,
+               pb_constraints[i]->_rhs, pb_constraints[i]->_sign));
 
-  for (int i = 0; i < nHard(); i++)
-    copymx->addHardClause(getHardClause(i).clause);
+  copymx->setFormat(getFormat());
+  copymx->_nameToIndex = _nameToIndex;
+  copymx->_indexToName = _indexToName;
 
   copymx->setProblemType(getProblemType());
   copymx->updateSumWeights(getSumWeights());
@@ -56,40 +84,45 @@ MaxSATFormula *MaxSATFormula::copyMaxSATFormula() {
 
 // Adds a new hard clause to the hard clause database.
 void MaxSATFormula::addHardClause(vec<Lit> &lits) {
-  hard_clauses.push();
-  vec<Lit> copy_lits;
-  lits.copyTo(copy_lits);
-  new (&hard_clauses[hard_clauses.size() - 1]) Hard(copy_lits);
+  hard_arena.add(lits);
   n_hard++;
 }
 
-// Adds a new soft clause to the hard clause database.
+// Removes all hard clauses from the hard clause database.
+void MaxSATFormula::clearHardClauses() {
+  hard_arena.clear();
+  n_hard = 0;
+}
+
+// Adds a new soft clause to the soft clause database.
 void MaxSATFormula::addSoftClause(uint64_t weight, vec<Lit> &lits) {
-  soft_clauses.push();
   vec<Lit> vars;
-  Lit assump = lit_Undef;
-  vec<Lit> copy_lits;
-  lits.copyTo(copy_lits);
-
-  new (&soft_clauses[soft_clauses.size() - 1])
-      Soft(copy_lits, weight, assump, vars);
-  n_soft++;
+  addSoftClause(weight, lits, vars);
 }
 
-// Adds a new soft clause to the hard clause database with predefined relaxation
-// variables.
+// Adds a new soft clause to the soft clause database with predefined
+// relaxation variables.
 void MaxSATFormula::addSoftClause(uint64_t weight, vec<Lit> &lits,
                                   vec<Lit> &vars) {
-  soft_clauses.push();
-  Lit assump = lit_Undef;
-  vec<Lit> copy_lits;
-  lits.copyTo(copy_lits);
-
-  new (&soft_clauses[soft_clauses.size() - 1])
-      Soft(copy_lits, weight, assump, vars);
+  soft_arena.add(lits);
+  soft_weights.push(weight);
+  soft_assumptions.push(lit_Undef);
+  soft_relaxations.push();
+  vars.copyTo(soft_relaxations.last());
   n_soft++;
 }
 
+void MaxSATFormula::reserveHard(int clauses, int lits) {
+  hard_arena.reserve(clauses, lits);
+}
+
+void MaxSATFormula::reserveSoft(int clauses, int lits) {
+  soft_arena.reserve(clauses, lits);
+  soft_weights.capacity(soft_weights.size() + clauses);
+  soft_assumptions.capacity(soft_assumptions.size() + clauses);
+  soft_relaxations.capacity(soft_relaxations.size() + clauses);
+}
+
 int MaxSATFormula::nInitialVars() {
   return n_initial_vars;
 } // Returns the number of variables in the working MaxSAT formula.
@@ -147,14 +180,9 @@ void MaxSATFormula::setHardWeight(uint64_t weight) {
   hard_weight = weight;
 } // Sets the weight of hard clauses.
 
-Soft &MaxSATFormula::getSoftClause(int pos) {
-  assert(pos < nSoft());
-  return soft_clauses[pos];
-}
-
-Hard &MaxSATFormula::getHardClause(int pos) {
-  assert(pos < nHard());
-  return hard_clauses[pos];
+// Adds a cardinality constraint. The formula takes ownership of 'card'.
+void MaxSATFormula::addCardinalityConstraint(Card *card) {
+  cardinality_constraints.push(card);
 }
 
 void MaxSATFormula::addPBConstraint(PB *p) {
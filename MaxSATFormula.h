@@ -50,40 +50,137 @@ namespace openwbo {
 typedef std::map<std::string, int> nameMap;
 typedef std::map<int, std::string> indexMap;
 
+class ClauseView {
+  /*! The clause view is a lightweight read-only reference to a clause stored
+   * in the literal arena of a MaxSAT formula. It is invalidated when new
+   * clauses are added to the formula. */
+public:
+  ClauseView(const Lit *lits, int size) : _lits(lits), _size(size) {}
+
+  int size() const { return _size; }
+
+  const Lit &operator[](int index) const {
+    assert(index >= 0 && index < _size);
+    return _lits[index];
+  }
+
+  void copyTo(vec<Lit> &copy) const {
+    copy.clear();
+    copy.growTo(_size);
+    for (int i = 0; i < _size; i++)
+      copy[i] = _lits[i];
+  }
+
+protected:
+  const Lit *_lits; //!< First literal of the clause in the arena
+  int _size;        //!< Number of literals of the clause
+};
+
+class ClauseArena {
+  /*! The clause arena stores clauses contiguously. Clause 'i' spans the
+   * literals in [offsets[i], offsets[i+1]). The arena may also refer to
+   * read-only memory owned by someone else (e.g. a memory mapped snapshot),
+   * in which case it is copied on the first modification. */
+public:
+  ClauseArena() : ext_lits(NULL), ext_offsets(NULL), ext_size(0) {
+    offsets.push(0);
+  }
+
+  int size() const { return ext_offsets != NULL ? ext_size : offsets.size() - 1; }
+  int nLits() const { return offsetsData()[size()]; }
+
+  ClauseView clause(int pos) const {
+    const int *o = offsetsData();
+    return ClauseView(litsData() + o[pos], o[pos + 1] - o[pos]);
+  }
+
+  void add(const vec<Lit> &clause) {
+    if (ext_offsets != NULL)
+      detach();
+    for (int i = 0; i < clause.size(); i++)
+      lits.push(clause[i]);
+    offsets.push(lits.size());
+  }
+
+  void reserve(int clauses, int n_lits) {
+    if (ext_offsets != NULL)
+      detach();
+    offsets.capacity(offsets.size() + clauses);
+    lits.capacity(lits.size() + n_lits);
+  }
+
+  void clear() {
+    lits.clear(true);
+    offsets.clear(true);
+    offsets.push(0);
+    ext_lits = NULL;
+    ext_offsets = NULL;
+    ext_size = 0;
+  }
+
+  // Uses 'n' clauses stored in external memory. 'ext_o' has 'n'+1 entries.
+  void attach(const Lit *ext_l, const int *ext_o, int n) {
+    lits.clear(true);
+    offsets.clear(true);
+    ext_lits = ext_l;
+    ext_offsets = ext_o;
+    ext_size = n;
+  }
+
+  const Lit *litsData() const {
+    return ext_offsets != NULL ? ext_lits : (const Lit *)&lits[0];
+  }
+  const int *offsetsData() const {
+    return ext_offsets != NULL ? ext_offsets : (const int *)&offsets[0];
+  }
+
+protected:
+  // Copies the external clauses into the arena.
+  void detach() {
+    int n = ext_offsets[ext_size];
+    lits.growTo(n);
+    for (int i = 0; i < n; i++)
+      lits[i] = ext_lits[i];
+    offsets.growTo(ext_size + 1);
+    for (int i = 0; i <= ext_size; i++)
+      offsets[i] = ext_offsets[i];
+    ext_lits = NULL;
+    ext_offsets = NULL;
+    ext_size = 0;
+  }
+
+  vec<Lit> lits;    //!< Literals of all clauses
+  vec<int> offsets; //!< Start of each clause in 'lits'
+
+  const Lit *ext_lits;    //!< External literals (NULL if not used)
+  const int *ext_offsets; //!< External offsets (NULL if not used)
+  int ext_size;           //!< Number of external clauses
+};
+
 class Soft {
 
 public:
-  /*! The soft class is used to model the soft clauses in a MaxSAT formula. */
-  Soft(const vec<Lit> &soft, uint64_t soft_weight, Lit assump_var,
-       const vec<Lit> &relax) {
-    soft.copyTo(clause);
-    weight = soft_weight;
-    assumption_var = assump_var;
-    relax.copyTo(relaxation_vars);
-  }
-
-  Soft() {}
-  ~Soft() {
-    clause.clear();
-    relaxation_vars.clear();
-  }
-
-  vec<Lit> clause;    //!< Soft clause
-  uint64_t weight;    //!< Weight of the soft clause
-  Lit assumption_var; //!< Assumption variable used for retrieving the core
-  vec<Lit> relaxation_vars; //!< Relaxation variables that will be added to the
-                            //! soft clause
+  /*! The soft class is a view of a soft clause of a MaxSAT formula. The
+   * clause is read-only while the weight, assumption variable and relaxation
+   * variables refer to the formula and can be modified through the view. */
+  Soft(const ClauseView &soft, uint64_t &soft_weight, Lit &assump_var,
+       vec<Lit> &relax)
+      : clause(soft), weight(soft_weight), assumption_var(assump_var),
+        relaxation_vars(relax) {}
+
+  ClauseView clause;  //!< Soft clause
+  uint64_t &weight;   //!< Weight of the soft clause
+  Lit &assumption_var; //!< Assumption variable used for retrieving the core
+  vec<Lit> &relaxation_vars; //!< Relaxation variables that will be added to
+                             //! the soft clause
 };
 
 class Hard {
-  /*! The hard class is used to model the hard clauses in a MaxSAT formula. */
+  /*! The hard class is a view of a hard clause of a MaxSAT formula. */
 public:
-  Hard(const vec<Lit> &hard) { hard.copyTo(clause); }
-
-  Hard() {}
-  ~Hard() { clause.clear(); }
+  Hard(const ClauseView &hard) : clause(hard) {}
 
-  vec<Lit> clause; //!< Hard clause
+  ClauseView clause; //!< Hard clause
 };
 
 class MaxSATFormula {
@@ -96,25 +193,20 @@ public:
         max_soft_weight(0) {
     objective_function = NULL;
     format = _FORMAT_MAXSAT_;
+    snapshot_map = NULL;
+    snapshot_size = 0;
   }
 
-  ~MaxSATFormula() {
-    for (int i = 0; i < nSoft(); i++) {
-      soft_clauses[i].clause.clear();
-      soft_clauses[i].relaxation_vars.clear();
-    }
-    soft_clauses.clear();
-
-    for (int i = 0; i < nHard(); i++)
-      hard_clauses[i].clause.clear();
-    hard_clauses.clear();
-  }
+  ~MaxSATFormula();
 
   MaxSATFormula *copyMaxSATFormula();
 
   /*! Add a new hard clause. */
   void addHardClause(vec<Lit> &lits);
 
+  /*! Remove all hard clauses. */
+  void clearHardClauses();
+
   /*! Add a new soft clause. */
   void addSoftClause(uint64_t weight, vec<Lit> &lits);
 
@@ -146,11 +238,22 @@ public:
   /*! Set initial number of variables. */
   void setInitialVars(int vars);
 
-  /*! Return i-soft clause. */
-  Soft &getSoftClause(int pos);
+  /*! Return a view of the i-soft clause. */
+  Soft getSoftClause(int pos) {
+    assert(pos < nSoft());
+    return Soft(soft_arena.clause(pos), soft_weights[pos],
+                soft_assumptions[pos], soft_relaxations[pos]);
+  }
+
+  /*! Return a view of the i-hard clause. */
+  Hard getHardClause(int pos) {
+    assert(pos < nHard());
+    return Hard(hard_arena.clause(pos));
+  }
 
-  /*! Return i-hard clause. */
-  Hard &getHardClause(int pos);
+  /*! Reserve space for the given number of clauses and literals. */
+  void reserveHard(int clauses, int lits);
+  void reserveSoft(int clauses, int lits);
 
   /*! Add a new cardinality constraint. */
   void addCardinalityConstraint(Card *card);
@@ -190,8 +293,12 @@ public:
 protected:
   // MaxSAT database
   //
-  vec<Soft> soft_clauses; //<! Stores the soft clauses of the MaxSAT formula.
-  vec<Hard> hard_clauses; //<! Stores the hard clauses of the MaxSAT formula.
+  ClauseArena hard_arena;     //<! Stores the hard clauses.
+  ClauseArena soft_arena;     //<! Stores the soft clauses.
+  vec<uint64_t> soft_weights; //<! Weights of the soft clauses.
+  vec<Lit> soft_assumptions;  //<! Assumption variables of the soft clauses.
+  vec<vec<Lit>> soft_relaxations; //<! Relaxation variables of the soft
+                                  //   clauses.
 
   // PB database
   //
@@ -218,6 +325,12 @@ protected:
   // Format
   //
   int format;
+
+  // Memory mapped snapshot backing the clause arenas (NULL if not used)
+  //
+  friend class FormulaSnapshot;
+  void *snapshot_map;
+  size_t snapshot_size;
 };
 
 } // namespace openwbo
@@ -58,17 +58,24 @@ void MaxSAT_Partition::init() {
     executed = true;
   }
 
-  if (_graph != NULL)
+  if (_graph != NULL) {
     delete _graph;
+    _graph = NULL;
+  }
+  // The graph only needs the unit propagation of the hard clauses, which is
+  // not part of the SAT backend interface, so glucose is used directly.
   if (_solver != NULL)
     delete _solver;
-  _solver = newSATSolver();
+  _solver = new Solver();
 
   for (int i = 0; i < maxsat_formula->nVars(); i++)
-    newSATVariable(_solver);
+    _solver->newVar();
 
-  for (int i = 0; i < maxsat_formula->nHard(); i++)
-    _solver->addClause(maxsat_formula->getHardClause(i).clause);
+  vec<Lit> clause;
+  for (int i = 0; i < maxsat_formula->nHard(); i++) {
+    maxsat_formula->getHardClause(i).clause.copyTo(clause);
+    _solver->addClause(clause);
+  }
 
   _graphMappingVar.clear();
   _graphMappingHard.clear();
@@ -88,6 +95,7 @@ void MaxSAT_Partition::split(int mode, int graphType) {
 
   if (!_solver->okay()) {
     delete _solver;
+    _solver = NULL;
     return;
   }
 
@@ -108,9 +116,15 @@ void MaxSAT_Partition::split(int mode, int graphType) {
 
       buildPartitions(graphType);
     }
+
+    // All soft clauses were fixed by unit propagation, so there is nothing to
+    // partition. The guide tree still needs a (possibly empty) partition.
+    if (_nPartitions == 0)
+      buildSinglePartition();
   }
 
   delete _solver;
+  _solver = NULL;
 }
 
 void MaxSAT_Partition::splitRandom() {
@@ -129,7 +143,7 @@ void MaxSAT_Partition::splitRandom() {
   }
 }
 
-int MaxSAT_Partition::unassignedLiterals(vec<Lit> &sc) {
+int MaxSAT_Partition::unassignedLiterals(const ClauseView &sc) {
   int u = 0;
   for (int i = 0; i < sc.size(); i++)
     if (_solver->value(sc[i]) == l_True)
@@ -139,14 +153,14 @@ int MaxSAT_Partition::unassignedLiterals(vec<Lit> &sc) {
   return u;
 }
 
-bool MaxSAT_Partition::isUnsatisfied(vec<Lit> &sc) {
+bool MaxSAT_Partition::isUnsatisfied(const ClauseView &sc) {
   for (int i = 0; i < sc.size(); i++)
     if (_solver->value(sc[i]) != l_False)
       return false;
   return true;
 }
 
-void MaxSAT_Partition::printClause(vec<Lit> &sc) {
+void MaxSAT_Partition::printClause(const ClauseView &sc) {
   for (int i = 0; i < sc.size(); i++)
     printf("%d ", (sign(sc[i]) ? -(var(sc[i]) + 1) : (var(sc[i]) + 1)));
 }
@@ -236,7 +250,7 @@ void MaxSAT_Partition::buildVIGPartitions() {
 
   for (int ci = 0; ci < maxsat_formula->nHard(); ci++) {
     // Compute which partition the hard clause belongs to...
-    vec<Lit> &c = maxsat_formula->getHardClause(ci).clause;
+    ClauseView c = maxsat_formula->getHardClause(ci).clause;
     if (unassignedLiterals(c) == 0)
       continue;
 
@@ -354,79 +368,85 @@ Graph *MaxSAT_Partition::buildVIGGraph(bool weighted) {
   for (int i = 0; i < maxsat_formula->nHard(); i++)
     _graphMappingHard[i] = -1;
 
-  Graph *g = new Graph(gVars);
+  GraphBuilder g(gVars);
 
-  int nEdges = 0;
-  for (int ci = 0; ci < maxsat_formula->nHard(); ci++) {
-    vec<Lit> &c = maxsat_formula->getHardClause(ci).clause;
-    int ul = unassignedLiterals(c); // returns 0 if c is satisfied
-    if (ul == 0)
-      continue;
+  // The edges are generated twice: the first pass counts the edges of each
+  // vertex and the second one stores them in the rows of the graph.
+  for (int pass = 0; pass < 2; pass++) {
+    if (pass == 1)
+      g.allocate();
 
-    double w = (weighted ? (2.0 / (ul * (ul - 1))) : 1.0);
-    for (int i = 0; i < c.size(); i++) {
-      if (_solver->value(c[i]) != l_Undef)
+    int nEdges = 0;
+    for (int ci = 0; ci < maxsat_formula->nHard(); ci++) {
+      ClauseView c = maxsat_formula->getHardClause(ci).clause;
+      int ul = unassignedLiterals(c); // returns 0 if c is satisfied
+      if (ul == 0)
         continue;
 
-      for (int j = i + 1; j < c.size(); j++) {
-        if (_solver->value(c[j]) != l_Undef)
+      double w = (weighted ? (2.0 / (ul * (ul - 1))) : 1.0);
+      for (int i = 0; i < c.size(); i++) {
+        if (_solver->value(c[i]) != l_Undef)
           continue;
 
-        int u = var(c[i]), v = var(c[j]);
-        g->addEdge(_graphMappingVar[u], _graphMappingVar[v],
-                   graphWeight[u] * graphWeight[v] * w);
-        g->addEdge(_graphMappingVar[v], _graphMappingVar[u],
-                   graphWeight[u] * graphWeight[v] * w);
-        nEdges++;
+        for (int j = i + 1; j < c.size(); j++) {
+          if (_solver->value(c[j]) != l_Undef)
+            continue;
+
+          int u = var(c[i]), v = var(c[j]);
+          g.addEdge(_graphMappingVar[u], _graphMappingVar[v],
+                     graphWeight[u] * graphWeight[v] * w);
+          g.addEdge(_graphMappingVar[v], _graphMappingVar[u],
+                     graphWeight[u] * graphWeight[v] * w);
+          nEdges++;
+        }
       }
-    }
 
-    if (nEdges >= _EDGE_LIMIT_) {
-      // cout << "c Graph is too large." << endl;
-      delete[] graphWeight;
-      delete g;
-      return NULL;
+      if (nEdges >= _EDGE_LIMIT_) {
+        // cout << "c Graph is too large." << endl;
+        delete[] graphWeight;
+        return NULL;
+      }
     }
-  }
-
-  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-    // Only adds soft clauses that are being considered in the working formula
-    int ul = unassignedLiterals(maxsat_formula->getSoftClause(i).clause);
-    if (ul == 0)
-      continue;
 
-    double w = (weighted ? (2.0 / (ul * (ul - 1))) : 1.0);
-    for (int j = 0; j < maxsat_formula->getSoftClause(i).clause.size(); j++) {
-      if (_solver->value(maxsat_formula->getSoftClause(i).clause[j]) != l_Undef)
+    for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+      // Only adds soft clauses that are being considered in the working
+      // formula
+      int ul = unassignedLiterals(maxsat_formula->getSoftClause(i).clause);
+      if (ul == 0)
         continue;
 
-      for (int k = j + 1; k < maxsat_formula->getSoftClause(i).clause.size();
-           k++) {
-        if (_solver->value(maxsat_formula->getSoftClause(i).clause[k]) !=
+      double w = (weighted ? (2.0 / (ul * (ul - 1))) : 1.0);
+      for (int j = 0; j < maxsat_formula->getSoftClause(i).clause.size(); j++) {
+        if (_solver->value(maxsat_formula->getSoftClause(i).clause[j]) !=
             l_Undef)
           continue;
 
-        int u = var(maxsat_formula->getSoftClause(i).clause[j]),
-            v = var(maxsat_formula->getSoftClause(i).clause[k]);
-        g->addEdge(_graphMappingVar[u], _graphMappingVar[v],
-                   graphWeight[u] * graphWeight[v] * w);
-        g->addEdge(_graphMappingVar[v], _graphMappingVar[u],
-                   graphWeight[u] * graphWeight[v] * w);
-        nEdges++;
+        for (int k = j + 1; k < maxsat_formula->getSoftClause(i).clause.size();
+             k++) {
+          if (_solver->value(maxsat_formula->getSoftClause(i).clause[k]) !=
+              l_Undef)
+            continue;
+
+          int u = var(maxsat_formula->getSoftClause(i).clause[j]),
+              v = var(maxsat_formula->getSoftClause(i).clause[k]);
+          g.addEdge(_graphMappingVar[u], _graphMappingVar[v],
+                     graphWeight[u] * graphWeight[v] * w);
+          g.addEdge(_graphMappingVar[v], _graphMappingVar[u],
+                     graphWeight[u] * graphWeight[v] * w);
+          nEdges++;
+        }
       }
-    }
 
-    if (nEdges >= _EDGE_LIMIT_) {
-      // cout << "c Graph is too large." << endl;
-      delete[] graphWeight;
-      delete g;
-      return NULL;
+      if (nEdges >= _EDGE_LIMIT_) {
+        // cout << "c Graph is too large." << endl;
+        delete[] graphWeight;
+        return NULL;
+      }
     }
   }
 
-  g->mergeDuplicatedEdges();
   delete[] graphWeight;
-  return g;
+  return g.build();
 }
 
 Graph *MaxSAT_Partition::buildCVIGGraph(bool weighted) {
@@ -470,74 +490,79 @@ Graph *MaxSAT_Partition::buildCVIGGraph(bool weighted) {
       _graphMappingHard[i] = gVars + sVars + hVars++;
   }
 
-  Graph *g = new Graph(gVars + sVars + hVars);
-  int nEdges = 0;
+  GraphBuilder g(gVars + sVars + hVars);
+  // The edges are generated twice: the first pass counts the edges of each
+  // vertex and the second one stores them in the rows of the graph.
+  for (int pass = 0; pass < 2; pass++) {
+    if (pass == 1)
+      g.allocate();
 
-  for (int ci = 0; ci < maxsat_formula->nHard(); ci++) {
-    if (_graphMappingHard[ci] != -1) { // -1 if it is not unresolved
-      vec<Lit> &c = maxsat_formula->getHardClause(ci).clause;
-      int ul = unassignedLiterals(c);
+    int nEdges = 0;
 
-      // printf("c Clause %d is unresolved\n", ci);
+    for (int ci = 0; ci < maxsat_formula->nHard(); ci++) {
+      if (_graphMappingHard[ci] != -1) { // -1 if it is not unresolved
+        ClauseView c = maxsat_formula->getHardClause(ci).clause;
+        int ul = unassignedLiterals(c);
 
-      // double w = (weighted ? (2.0 / (ul * (ul-1))) : 1.0);
-      for (int i = 0; i < c.size(); i++) {
-        if (_solver->value(c[i]) != l_Undef)
-          continue;
+        // printf("c Clause %d is unresolved\n", ci);
 
-        int u = var(c[i]);
-        g->addEdge(_graphMappingVar[u], _graphMappingHard[ci],
-                   ((double)graphWeight[u]) / ul);
-        g->addEdge(_graphMappingHard[ci], _graphMappingVar[u],
-                   ((double)graphWeight[u]) / ul);
-        nEdges++;
+        // double w = (weighted ? (2.0 / (ul * (ul-1))) : 1.0);
+        for (int i = 0; i < c.size(); i++) {
+          if (_solver->value(c[i]) != l_Undef)
+            continue;
 
-        // printf("c Adding edge! #E: %d\n", g->nEdges());
-      }
+          int u = var(c[i]);
+          g.addEdge(_graphMappingVar[u], _graphMappingHard[ci],
+                     ((double)graphWeight[u]) / ul);
+          g.addEdge(_graphMappingHard[ci], _graphMappingVar[u],
+                     ((double)graphWeight[u]) / ul);
+          nEdges++;
 
-      if (nEdges >= _EDGE_LIMIT_) {
-        printf("c Graph is too large.\n");
-        delete[] graphWeight;
-        delete g;
-        return NULL;
+          // printf("c Adding edge! #E: %d\n", g->nEdges());
+        }
+
+        if (nEdges >= _EDGE_LIMIT_) {
+          printf("c Graph is too large.\n");
+          delete[] graphWeight;
+          return NULL;
+        }
       }
     }
-  }
 
-  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-    // Only adds unresolved soft clauses
-    if (_graphMappingSoft[i] != -1) { // -1 if it is not unresolved
-      int ul = unassignedLiterals(maxsat_formula->getSoftClause(i).clause);
-      // double w = (weighted ? (2.0 / (ul * (ul-1))) : 1.0);
-
-      for (int j = 0; j < maxsat_formula->getSoftClause(i).clause.size(); j++) {
-        if (_solver->value(maxsat_formula->getSoftClause(i).clause[j]) !=
-            l_Undef)
-          continue;
-
-        int u = var(maxsat_formula->getSoftClause(i).clause[j]);
-        g->addEdge(_graphMappingVar[u], _graphMappingSoft[i],
-                   ((double)graphWeight[u]) / ul);
-        g->addEdge(_graphMappingSoft[i], _graphMappingVar[u],
-                   ((double)graphWeight[u]) / ul);
-        nEdges++;
-      }
+    for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+      // Only adds unresolved soft clauses
+      if (_graphMappingSoft[i] != -1) { // -1 if it is not unresolved
+        int ul = unassignedLiterals(maxsat_formula->getSoftClause(i).clause);
+        // double w = (weighted ? (2.0 / (ul * (ul-1))) : 1.0);
+
+        for (int j = 0; j < maxsat_formula->getSoftClause(i).clause.size();
+             j++) {
+          if (_solver->value(maxsat_formula->getSoftClause(i).clause[j]) !=
+              l_Undef)
+            continue;
+
+          int u = var(maxsat_formula->getSoftClause(i).clause[j]);
+          g.addEdge(_graphMappingVar[u], _graphMappingSoft[i],
+                     ((double)graphWeight[u]) / ul);
+          g.addEdge(_graphMappingSoft[i], _graphMappingVar[u],
+                     ((double)graphWeight[u]) / ul);
+          nEdges++;
+        }
 
-      if (nEdges >= _EDGE_LIMIT_) {
-        printf("c Graph is too large.\n");
-        delete[] graphWeight;
-        delete g;
-        return NULL;
+        if (nEdges >= _EDGE_LIMIT_) {
+          printf("c Graph is too large.\n");
+          delete[] graphWeight;
+          return NULL;
+        }
       }
     }
   }
 
-  g->mergeDuplicatedEdges();
   delete[] graphWeight;
-  return g;
+  return g.build();
 }
 
-int MaxSAT_Partition::markUnassignedLiterals(vec<Lit> &c, int *markedLits,
+int MaxSAT_Partition::markUnassignedLiterals(const ClauseView &c, int *markedLits,
                                              bool v) {
   int u = 0;
   for (int i = 0; i < c.size(); i++) {
@@ -589,12 +614,11 @@ Graph *MaxSAT_Partition::buildRESGraph(bool weighted) {
       _graphMappingHard[i] = sVars + hVars++;
   }
 
-  Graph *g = new Graph(sVars + hVars);
-  int nEdges = 0;
+  GraphBuilder g(sVars + hVars);
 
   for (int ci = 0; ci < maxsat_formula->nHard(); ci++) {
     if (_graphMappingHard[ci] != -1) { // -1 if it is not unresolved
-      vec<Lit> &c = maxsat_formula->getHardClause(ci).clause;
+      ClauseView c = maxsat_formula->getHardClause(ci).clause;
 
       for (int i = 0; i < c.size(); i++) {
         if (_solver->value(c[i]) != l_Undef)
@@ -604,125 +628,132 @@ Graph *MaxSAT_Partition::buildRESGraph(bool weighted) {
     }
   }
 
-  for (int ci = 0; ci < maxsat_formula->nHard(); ci++) {
-    if (_graphMappingHard[ci] != -1) { // -1 if it is not unresolved
-      vec<Lit> &c = maxsat_formula->getHardClause(ci).clause;
-
-      // Mark clause literals - returns number of unassigned literals
-      int mrk = markUnassignedLiterals(c, markedLits, true);
-
-      for (int i = 0; i < c.size(); i++) {
-        if (_solver->value(c[i]) != l_Undef)
-          continue;
-
-        int li = toInt(~c[i]);
-        for (int iter = 0; iter < litClauses[li].size(); iter++) {
-          int ri = litClauses[li][iter];
-          if (ri <= ci)
-            continue; // avoid duplication checks
-
-          vec<Lit> &rc = maxsat_formula->getHardClause(ri).clause;
-          int rl = 0, ul = mrk - 1;
-
-          for (int j = 0; j < rc.size(); j++) {
-            if (_solver->value(rc[j]) != l_Undef)
-              continue;
-
-            // Counts number of resolution literals l and ~l
-            if (markedLits[toInt(~rc[j])] == true)
-              rl++;
-            // Counts number of different literals in resulting resolution
-            // clause
-            else if (markedLits[toInt(rc[j])] != true)
-              ul++;
+  // The edges are generated twice: the first pass counts the edges of each
+  // vertex and the second one stores them in the rows of the graph.
+  for (int pass = 0; pass < 2; pass++) {
+    if (pass == 1)
+      g.allocate();
+
+    int nEdges = 0;
+
+    for (int ci = 0; ci < maxsat_formula->nHard(); ci++) {
+      if (_graphMappingHard[ci] != -1) { // -1 if it is not unresolved
+        ClauseView c = maxsat_formula->getHardClause(ci).clause;
+
+        // Mark clause literals - returns number of unassigned literals
+        int mrk = markUnassignedLiterals(c, markedLits, true);
+
+        for (int i = 0; i < c.size(); i++) {
+          if (_solver->value(c[i]) != l_Undef)
+            continue;
+
+          int li = toInt(~c[i]);
+          for (int iter = 0; iter < litClauses[li].size(); iter++) {
+            int ri = litClauses[li][iter];
+            if (ri <= ci)
+              continue; // avoid duplication checks
+
+            ClauseView rc = maxsat_formula->getHardClause(ri).clause;
+            int rl = 0, ul = mrk - 1;
+
+            for (int j = 0; j < rc.size(); j++) {
+              if (_solver->value(rc[j]) != l_Undef)
+                continue;
+
+              // Counts number of resolution literals l and ~l
+              if (markedLits[toInt(~rc[j])] == true)
+                rl++;
+              // Counts number of different literals in resulting resolution
+              // clause
+              else if (markedLits[toInt(rc[j])] != true)
+                ul++;
+            }
+
+            if (rl == 0)
+              printf("No way!! There must be at least one!!\n");
+            if (rl == 1) {
+              if (!weighted)
+                ul = 1;
+              g.addEdge(_graphMappingHard[ci], _graphMappingHard[ri], 1.0 / ul);
+              g.addEdge(_graphMappingHard[ri], _graphMappingHard[ci], 1.0 / ul);
+              nEdges++;
+            }
           }
 
-          if (rl == 0)
-            printf("No way!! There must be at least one!!\n");
-          if (rl == 1) {
-            if (!weighted)
-              ul = 1;
-            g->addEdge(_graphMappingHard[ci], _graphMappingHard[ri], 1.0 / ul);
-            g->addEdge(_graphMappingHard[ri], _graphMappingHard[ci], 1.0 / ul);
-            nEdges++;
+          // printf("%d Edges\n", nEdges);
+          if (nEdges >= _EDGE_LIMIT_) {
+            printf("c Graph is too large.\n");
+            for (int i = 0; i < nLits; i++)
+              litClauses[i].clear();
+            delete[] litClauses;
+            delete[] markedLits;
+            delete[] graphWeight;
+            return NULL;
           }
         }
 
-        // printf("%d Edges\n", nEdges);
-        if (nEdges >= _EDGE_LIMIT_) {
-          printf("c Graph is too large.\n");
-          for (int i = 0; i < nLits; i++)
-            litClauses[i].clear();
-          delete[] litClauses;
-          delete[] markedLits;
-          delete[] graphWeight;
-          delete g;
-          return NULL;
-        }
+        // Clear marked literals
+        markUnassignedLiterals(c, markedLits, false);
       }
-
-      // Clear marked literals
-      markUnassignedLiterals(c, markedLits, false);
     }
-  }
-
-  // Connect soft clauses with hard clauses!!!
-  for (int ci = 0; ci < maxsat_formula->nSoft(); ci++) {
-    if (_graphMappingSoft[ci] != -1) { // -1 if it is not unresolved
-      vec<Lit> &c = maxsat_formula->getSoftClause(ci).clause;
-
-      // Mark clause literals
-      int mrk = markUnassignedLiterals(c, markedLits, true);
 
-      for (int i = 0; i < c.size(); i++) {
-        if (_solver->value(c[i]) != l_Undef)
-          continue;
-
-        int li = toInt(~c[i]);
-        for (int iter = 0; iter < litClauses[li].size(); iter++) {
-          int ri = litClauses[li][iter];
-          // if (ri <= ci) continue; //avoid duplication checks
-
-          vec<Lit> &rc = maxsat_formula->getHardClause(ri).clause;
-          int rl = 0, ul = mrk - 1;
-
-          for (int j = 0; j < rc.size(); j++) {
-            if (_solver->value(rc[j]) != l_Undef)
-              continue;
-
-            // Counts number of resolution literals l and ~l
-            if (markedLits[toInt(~rc[j])] == true)
-              rl++;
-            // Counts number of different literals in resulting resolution
-            // clause
-            else if (markedLits[toInt(rc[j])] != true)
-              ul++;
+    // Connect soft clauses with hard clauses!!!
+    for (int ci = 0; ci < maxsat_formula->nSoft(); ci++) {
+      if (_graphMappingSoft[ci] != -1) { // -1 if it is not unresolved
+        ClauseView c = maxsat_formula->getSoftClause(ci).clause;
+
+        // Mark clause literals
+        int mrk = markUnassignedLiterals(c, markedLits, true);
+
+        for (int i = 0; i < c.size(); i++) {
+          if (_solver->value(c[i]) != l_Undef)
+            continue;
+
+          int li = toInt(~c[i]);
+          for (int iter = 0; iter < litClauses[li].size(); iter++) {
+            int ri = litClauses[li][iter];
+            // if (ri <= ci) continue; //avoid duplication checks
+
+            ClauseView rc = maxsat_formula->getHardClause(ri).clause;
+            int rl = 0, ul = mrk - 1;
+
+            for (int j = 0; j < rc.size(); j++) {
+              if (_solver->value(rc[j]) != l_Undef)
+                continue;
+
+              // Counts number of resolution literals l and ~l
+              if (markedLits[toInt(~rc[j])] == true)
+                rl++;
+              // Counts number of different literals in resulting resolution
+              // clause
+              else if (markedLits[toInt(rc[j])] != true)
+                ul++;
+            }
+
+            if (rl == 0)
+              printf("No way!! There must be at least one!!\n");
+            if (rl == 1) {
+              if (!weighted)
+                ul = 1;
+              g.addEdge(_graphMappingSoft[ci], _graphMappingHard[ri], 1.0 / ul);
+              g.addEdge(_graphMappingHard[ri], _graphMappingSoft[ci], 1.0 / ul);
+              nEdges++;
+            }
           }
-
-          if (rl == 0)
-            printf("No way!! There must be at least one!!\n");
-          if (rl == 1) {
-            if (!weighted)
-              ul = 1;
-            g->addEdge(_graphMappingSoft[ci], _graphMappingHard[ri], 1.0 / ul);
-            g->addEdge(_graphMappingHard[ri], _graphMappingSoft[ci], 1.0 / ul);
-            nEdges++;
+          if (nEdges >= _EDGE_LIMIT_) {
+            printf("c Graph is too large.\n");
+            for (int i = 0; i < nLits; i++)
+              litClauses[i].clear();
+            delete[] litClauses;
+            delete[] markedLits;
+            delete[] graphWeight;
+            return NULL;
           }
         }
-        if (nEdges >= _EDGE_LIMIT_) {
-          printf("c Graph is too large.\n");
-          for (int i = 0; i < nLits; i++)
-            litClauses[i].clear();
-          delete[] litClauses;
-          delete[] markedLits;
-          delete[] graphWeight;
-          delete g;
-          return NULL;
-        }
-      }
 
-      // Clear marked literals
-      markUnassignedLiterals(c, markedLits, false);
+        // Clear marked literals
+        markUnassignedLiterals(c, markedLits, false);
+      }
     }
   }
 
@@ -732,7 +763,6 @@ Graph *MaxSAT_Partition::buildRESGraph(bool weighted) {
   delete[] litClauses;
   delete[] markedLits;
 
-  g->mergeDuplicatedEdges();
   delete[] graphWeight;
-  return g;
+  return g.build();
 }
@@ -63,6 +63,10 @@ public:
   void setRandomSeed(int n) { _randomSeed = n; }
   int getRandomSeed() { return _randomSeed; }
 
+  // Set number of threads used by community detection
+  void setCommunityThreads(int n) { _gc.setThreads(n); }
+  int getCommunityThreads() { return _gc.getThreads(); }
+
   double getModularity() { return _gc.getModularity(); }
   int nPartitions() { return _nPartitions; }
   int varPartition(Var v) { return _graphMappingVar[v]; }
@@ -86,10 +90,15 @@ public:
     return _partitions[index].hclauses;
   }
 
-  const vec<int> &adjacentPartitions(int index) {
+  // Random partitions have no community graph and thus no adjacencies.
+  GraphRow<int> adjacentPartitions(int index) {
+    if (!_gc.hasCommunityGraph())
+      return GraphRow<int>(NULL, 0);
     return _gc.adjCommunities(index);
   }
-  const vec<double> &adjacentPartitionWeights(int index) {
+  GraphRow<float> adjacentPartitionWeights(int index) {
+    if (!_gc.hasCommunityGraph())
+      return GraphRow<float>(NULL, 0);
     return _gc.adjCommunityWeights(index);
   }
 
@@ -123,12 +132,12 @@ protected:
   Graph *buildCVIGGraph(bool weighted);
   Graph *buildRESGraph(bool weighted);
 
-  int unassignedLiterals(vec<Lit> &sc);
-  bool isUnsatisfied(vec<Lit> &sc);
+  int unassignedLiterals(const ClauseView &sc);
+  bool isUnsatisfied(const ClauseView &sc);
 
-  int markUnassignedLiterals(vec<Lit> &c, int *markedLits, bool v);
+  int markUnassignedLiterals(const ClauseView &c, int *markedLits, bool v);
 
-  void printClause(vec<Lit> &sc);
+  void printClause(const ClauseView &sc);
 
 protected:
   Solver *_solver;
@@ -57,7 +57,9 @@ enum {
   _ALGORITHM_PART_MSU3_,
   _ALGORITHM_OLL_,
   _ALGORITHM_BEST_,
-  _ALGORITHM_BASIC_
+  _ALGORITHM_BASIC_,
+  _ALGORITHM_PORTFOLIO_,
+  _ALGORITHM_BCD_
 };
 enum StatusCode {
   _SATISFIABLE_ = 10,
@@ -72,10 +74,16 @@ enum {
   _INCREMENTAL_WEAKENING_,
   _INCREMENTAL_ITERATIVE_
 };
-enum { _CARD_CNETWORKS_ = 0, _CARD_TOTALIZER_, _CARD_MTOTALIZER_ };
+enum {
+  _CARD_CNETWORKS_ = 0,
+  _CARD_TOTALIZER_,
+  _CARD_MTOTALIZER_,
+  _CARD_NATIVE_
+};
 enum { _AMO_LADDER_ = 0 };
 enum { _PB_SWC_ = 0, _PB_GTE_, _PB_ADDER_ };
 enum { _PART_SEQUENTIAL_ = 0, _PART_SEQUENTIAL_SORTED_, _PART_BINARY_ };
+enum { _SAT_GLUCOSE41_ = 0, _SAT_GLUCOSE40_, _SAT_MINISAT22_ };
 
 }
 #endif
@@ -0,0 +1,199 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "MultiSolver.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace openwbo;
+
+MultiSolver::MultiSolver(int threads) : nb_wins(0) {
+  for (int i = 1; i < threads; i++) {
+    Solver *S = new Solver();
+    // The helpers differ in their random decisions. As in glucose-syrup,
+    // their first descent is random.
+    S->random_seed = 91648253 + i;
+    S->random_var_freq = 0.01 * (i % 5);
+#ifdef CLAUSE_SHARING
+    S->randomizeFirstDescent = true;
+#endif
+    helpers.push(S);
+  }
+}
+
+MultiSolver::~MultiSolver() {
+  for (int i = 0; i < helpers.size(); i++)
+    delete helpers[i];
+}
+
+Var MultiSolver::newVar(bool polarity, bool dvar) {
+  for (int i = 0; i < helpers.size(); i++)
+    helpers[i]->newVar(polarity, dvar);
+#ifdef SIMP
+  return NSPACE::SimpSolver::newVar(polarity, dvar);
+#else
+  return Solver::newVar(polarity, dvar);
+#endif
+}
+
+bool MultiSolver::addClause_(vec<Lit> &ps) {
+  // 'addClause_' simplifies its argument.
+  for (int i = 0; i < helpers.size(); i++) {
+    ps.copyTo(buffer);
+    helpers[i]->addClause_(buffer);
+  }
+#ifdef SIMP
+  return NSPACE::SimpSolver::addClause_(ps);
+#else
+  return Solver::addClause_(ps);
+#endif
+}
+
+#ifdef NATIVE_CARDINALITY
+// The constraints are added in the same order to every solver, so they have
+// the same index in all of them.
+int MultiSolver::addAtMost(const vec<Lit> &ps, int k, Lit guard) {
+  for (int i = 0; i < helpers.size(); i++)
+    helpers[i]->addAtMost(ps, k, guard);
+  return Solver::addAtMost(ps, k, guard);
+}
+
+bool MultiSolver::tightenAtMost(int c, int k) {
+  for (int i = 0; i < helpers.size(); i++)
+    helpers[i]->tightenAtMost(c, k);
+  return Solver::tightenAtMost(c, k);
+}
+
+// A helper may have assigned the guard at level 0 on its own, so the
+// constraint is only updated if it can be updated in every solver.
+bool MultiSolver::updateAtMost(int c, const vec<Lit> &ps, int k) {
+  Lit guard = card_guard[c];
+  for (int i = 0; i < helpers.size(); i++)
+    if (helpers[i]->value(guard) != l_Undef)
+      return false;
+  if (value(guard) != l_Undef)
+    return false;
+
+  for (int i = 0; i < helpers.size(); i++)
+    helpers[i]->updateAtMost(c, ps, k);
+  return Solver::updateAtMost(c, ps, k);
+}
+
+void MultiSolver::removeAtMost(int c) {
+  for (int i = 0; i < helpers.size(); i++)
+    helpers[i]->removeAtMost(c);
+  Solver::removeAtMost(c);
+}
+#endif
+
+/*_________________________________________________________________________________________________
+  |
+  |  solveParallel : (assumps : const vec<Lit>&)  ->  [lbool]
+  |
+  |  Description:
+  |
+  |    Runs this solver in the calling thread and each helper in its own
+  |    thread. The first solver that returns 'l_True' or 'l_False' wins and
+  |    interrupts the others. This solver always stops the helpers when it
+  |    returns, so that its budget and interrupts apply to the whole call.
+  |    An interrupt raised by the caller is still pending after the call.
+  |    Returns 'l_Undef' if no solver found an answer.
+  |
+  |  Post-conditions:
+  |    * 'model' or 'conflict' of this solver holds the answer of the winner.
+  |    * The helpers are ready for another call.
+  |
+  |________________________________________________________________________________________________@*/
+lbool MultiSolver::solveParallel(const vec<Lit> &assumps) {
+  if (helpers.size() == 0) {
+#ifdef SIMP
+    return NSPACE::SimpSolver::solveLimited(assumps, false);
+#else
+    return Solver::solveLimited(assumps);
+#endif
+  }
+
+  std::atomic<int> winner(-1);
+  std::vector<lbool> results(helpers.size(), l_Undef);
+  // Set if a helper won and interrupted this solver. Only that interrupt is
+  // cleared afterwards, so that one raised by the algorithm is kept.
+  bool interrupted = false;
+
+  auto stopOthers = [&](int id) {
+    int none = -1;
+    if (!winner.compare_exchange_strong(none, id))
+      return;
+    if (id != helpers.size() && !asynch_interrupt) {
+      interrupted = true;
+      interrupt();
+    }
+    for (int i = 0; i < helpers.size(); i++)
+      if (i != id)
+        helpers[i]->interrupt();
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < helpers.size(); i++)
+    threads.push_back(std::thread([&, i]() {
+      results[i] = helpers[i]->solveLimited(assumps);
+      if (results[i] != l_Undef)
+        stopOthers(i);
+    }));
+
+  // This solver has identifier 'helpers.size()'.
+#ifdef SIMP
+  lbool res = NSPACE::SimpSolver::solveLimited(assumps, false);
+#else
+  lbool res = Solver::solveLimited(assumps);
+#endif
+  if (res != l_Undef)
+    stopOthers(helpers.size());
+  for (int i = 0; i < helpers.size(); i++)
+    helpers[i]->interrupt();
+
+  for (size_t i = 0; i < threads.size(); i++)
+    threads[i].join();
+  for (int i = 0; i < helpers.size(); i++)
+    helpers[i]->clearInterrupt();
+
+  int w = winner.load();
+  if (w == -1 || w == helpers.size())
+    return res;
+
+  if (interrupted)
+    clearInterrupt();
+  nb_wins++;
+  if (results[w] == l_True)
+    helpers[w]->model.copyTo(model);
+  else
+    helpers[w]->conflict.copyTo(conflict);
+  return results[w];
+}
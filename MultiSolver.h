@@ -0,0 +1,89 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef MultiSolver_h
+#define MultiSolver_h
+
+#ifdef SIMP
+#include "simp/SimpSolver.h"
+#else
+#include "core/Solver.h"
+#endif
+
+using NSPACE::vec;
+using NSPACE::Lit;
+using NSPACE::Var;
+using NSPACE::lbool;
+using NSPACE::Solver;
+
+namespace openwbo {
+
+/*! SAT solver that runs diversified copies of itself on each SAT call.
+ *
+ * This follows the 'MultiSolvers' engine of glucose-syrup, which is not
+ * incremental: every variable, clause and native cardinality constraint
+ * added to this solver is also added to each helper solver, so the helpers
+ * keep their own learnt clauses between calls. 'solveParallel' runs this
+ * solver and the helpers in parallel under the same assumptions and
+ * returns the first definite answer; the model or the conflict of a helper
+ * is copied into this solver. */
+#ifdef SIMP
+class MultiSolver : public NSPACE::SimpSolver {
+#else
+class MultiSolver : public NSPACE::Solver {
+#endif
+
+public:
+  MultiSolver(int threads); // Runs 'threads' solvers (including this one).
+  ~MultiSolver();
+
+  Var newVar(bool polarity = true, bool dvar = true);
+  bool addClause_(vec<Lit> &ps);
+#ifdef NATIVE_CARDINALITY
+  int addAtMost(const vec<Lit> &ps, int k, Lit guard = NSPACE::lit_Undef);
+  bool tightenAtMost(int c, int k);
+  bool updateAtMost(int c, const vec<Lit> &ps, int k);
+  void removeAtMost(int c);
+#endif
+
+  // Solves the formula under 'assumps' with all solvers. The budget and the
+  // interrupts of this solver also stop the helpers.
+  lbool solveParallel(const vec<Lit> &assumps);
+
+  int nWins() { return nb_wins; } // Calls answered by a helper.
+
+protected:
+  vec<Solver *> helpers;
+  vec<Lit> buffer;
+  int nb_wins;
+};
+
+} // namespace openwbo
+
+#endif
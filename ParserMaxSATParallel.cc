@@ -0,0 +1,356 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+#include "ParserMaxSATParallel.h"
+
+using namespace openwbo;
+
+// Chunks smaller than this are not worth a thread of their own.
+#define _MIN_CHUNK_SIZE_ (1 << 20)
+
+static inline bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' ||
+         c == '\f';
+}
+
+static inline const char *skipSpaces(const char *in, const char *end) {
+  while (in < end && isSpace(*in))
+    ++in;
+  return in;
+}
+
+static inline const char *skipLine(const char *in, const char *end) {
+  while (in < end && *in != '\n')
+    ++in;
+  return in < end ? in + 1 : end;
+}
+
+// Parses an unsigned integer. Returns NULL if no digit was found.
+static inline const char *parseUInt64(const char *in, const char *end,
+                                      uint64_t &val) {
+  val = 0;
+  in = skipSpaces(in, end);
+  if (in == end || *in < '0' || *in > '9')
+    return NULL;
+  while (in < end && *in >= '0' && *in <= '9')
+    val = val * 10 + (*in - '0'), ++in;
+  return in;
+}
+
+// Parses a signed integer. Returns NULL if no digit was found.
+static inline const char *parseInt(const char *in, const char *end,
+                                   int &val) {
+  bool neg = false;
+  in = skipSpaces(in, end);
+  if (in < end && (*in == '-' || *in == '+'))
+    neg = (*in == '-'), ++in;
+  if (in == end || *in < '0' || *in > '9')
+    return NULL;
+  val = 0;
+  while (in < end && *in >= '0' && *in <= '9')
+    val = val * 10 + (*in - '0'), ++in;
+  if (neg)
+    val = -val;
+  return in;
+}
+
+// Returns true if the line that finishes right before 'eol' (a '\n') ends a
+// clause, i.e. its last token is '0'.
+static bool endsClause(const char *start, const char *eol) {
+  const char *p = eol;
+  while (p > start && isSpace(*(p - 1)))
+    --p;
+  if (p == start || *(p - 1) != '0')
+    return false;
+  --p;
+  return p == start || isSpace(*(p - 1));
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  parse : (fileName : const char *) (maxsat_formula : MaxSATFormula *) ->
+  |  [bool]
+  |
+  |  Description:
+  |
+  |    Maps the file into memory and parses it with 'n_threads' threads. The
+  |    header is parsed sequentially, the remaining of the file is split into
+  |    chunks that end with a complete clause, and each chunk is parsed into
+  |    its own buffer. Buffers are merged in file order so that the resulting
+  |    formula is identical to the one built by the sequential parser.
+  |
+  |  Post-conditions:
+  |    * Returns false if the file is empty or compressed. In this case the
+  |      formula is left untouched.
+  |
+  |________________________________________________________________________________________________@*/
+bool ParserMaxSATParallel::parse(const char *fileName,
+                                 MaxSATFormula *maxsat_formula) {
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0) {
+    printf("c ERROR! Could not open file: %s\n", fileName);
+    printf("s UNKNOWN\n");
+    exit(_ERROR_);
+  }
+
+  struct stat statbuf;
+  if (fstat(fd, &statbuf) < 0 || statbuf.st_size == 0) {
+    close(fd);
+    return false;
+  }
+
+  size_t size = statbuf.st_size;
+  void *map = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED) {
+    close(fd);
+    return false;
+  }
+  madvise(map, size, MADV_SEQUENTIAL);
+
+  const char *start = (const char *)map;
+  const char *end = start + size;
+
+  // gzip magic number: leave compressed files to the StreamBuffer parser.
+  if (size >= 2 && (unsigned char)start[0] == 0x1f &&
+      (unsigned char)start[1] == 0x8b) {
+    munmap(map, size);
+    close(fd);
+    return false;
+  }
+
+  weighted = false;
+  hard_weight = UINT64_MAX;
+  const char *body = parseHeader(start, end, maxsat_formula);
+
+  // Split the body into line-aligned chunks.
+  size_t body_size = end - body;
+  int n_chunks = n_threads < 1 ? 1 : n_threads;
+  if (body_size / _MIN_CHUNK_SIZE_ < (size_t)n_chunks)
+    n_chunks = body_size / _MIN_CHUNK_SIZE_ + 1;
+
+  std::vector<ChunkBuffer> chunks;
+  const char *in = body;
+  for (int i = 0; i < n_chunks && in < end; i++) {
+    const char *stop = end;
+    if (i < n_chunks - 1 && in + body_size / n_chunks < end) {
+      stop = in + body_size / n_chunks;
+      // Move the boundary to the end of a line that closes a clause.
+      for (;;) {
+        const char *line = stop;
+        while (stop < end && *stop != '\n')
+          stop++;
+        if (stop == end)
+          break;
+        while (line > in && *(line - 1) != '\n')
+          line--;
+        stop++;
+        if (endsClause(line, stop - 1))
+          break;
+      }
+    }
+    chunks.push_back(ChunkBuffer());
+    ChunkBuffer &c = chunks.back();
+    c.begin = in;
+    c.end = stop;
+    c.max_var = 0;
+    c.error = NULL;
+    in = stop;
+  }
+
+  if (chunks.size() == 1)
+    parseChunk(&chunks[0], weighted);
+  else {
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < chunks.size(); i++)
+      workers.push_back(std::thread(parseChunk, &chunks[i], weighted));
+    for (size_t i = 0; i < workers.size(); i++)
+      workers[i].join();
+  }
+
+  for (size_t i = 0; i < chunks.size(); i++)
+    if (chunks[i].error != NULL)
+      parseError(chunks[i].error, end);
+
+  merge(chunks, maxsat_formula);
+
+  munmap(map, size);
+  close(fd);
+
+  if (maxsat_formula->getMaximumWeight() == 1)
+    maxsat_formula->setProblemType(_UNWEIGHTED_);
+  else
+    maxsat_formula->setProblemType(_WEIGHTED_);
+
+  return true;
+}
+
+const char *ParserMaxSATParallel::parseHeader(const char *in, const char *end,
+                                              MaxSATFormula *maxsat_formula) {
+  for (;;) {
+    const char *line = skipSpaces(in, end);
+    if (line == end || (*line != 'c' && *line != 'p'))
+      return line;
+
+    if (*line == 'c') {
+      in = skipLine(line, end);
+      continue;
+    }
+
+    uint64_t n;
+    const char *p = line + 1;
+    p = skipSpaces(p, end);
+    if (end - p >= 4 && strncmp(p, "wcnf", 4) == 0) {
+      weighted = true;
+      maxsat_formula->setProblemType(_WEIGHTED_);
+      p += 4;
+    } else if (end - p >= 3 && strncmp(p, "cnf", 3) == 0)
+      p += 3;
+    else
+      parseError(p, end);
+
+    if ((p = parseUInt64(p, end, n)) == NULL) // Variables
+      parseError(line, end);
+    if ((p = parseUInt64(p, end, n)) == NULL) // Clauses
+      parseError(line, end);
+
+    // Optional weight of hard clauses.
+    while (p < end && (*p == ' ' || *p == '\t'))
+      p++;
+    if (weighted && p < end && *p != '\r' && *p != '\n') {
+      if ((p = parseUInt64(p, end, hard_weight)) == NULL)
+        parseError(line, end);
+      maxsat_formula->setHardWeight(hard_weight);
+    }
+    in = skipLine(p, end);
+  }
+}
+
+void ParserMaxSATParallel::parseChunk(ChunkBuffer *chunk, bool weighted) {
+  const char *in = chunk->begin;
+  const char *end = chunk->end;
+  int max_var = 0;
+
+  for (;;) {
+    in = skipSpaces(in, end);
+    if (in == end)
+      break;
+
+    // Like the sequential parser, 'p' lines after the header are ignored.
+    if (*in == 'c' || *in == 'p') {
+      in = skipLine(in, end);
+      continue;
+    }
+
+    const char *clause = in;
+    if (weighted) {
+      uint64_t weight;
+      if ((in = parseUInt64(in, end, weight)) == NULL) {
+        chunk->error = clause;
+        return;
+      }
+      chunk->weights.push_back(weight);
+    }
+
+    int size = 0;
+    for (;;) {
+      int parsed_lit;
+      const char *next = parseInt(in, end, parsed_lit);
+      if (next == NULL) {
+        chunk->error = skipSpaces(in, end);
+        return;
+      }
+      in = next;
+      if (parsed_lit == 0)
+        break;
+      int var = abs(parsed_lit);
+      if (var > max_var)
+        max_var = var;
+      chunk->lits.push_back(parsed_lit);
+      size++;
+    }
+    chunk->sizes.push_back(size);
+  }
+
+  chunk->max_var = max_var;
+}
+
+void ParserMaxSATParallel::merge(std::vector<ChunkBuffer> &chunks,
+                                 MaxSATFormula *maxsat_formula) {
+  int max_var = 0;
+  for (size_t i = 0; i < chunks.size(); i++)
+    if (chunks[i].max_var > max_var)
+      max_var = chunks[i].max_var;
+
+  // Single reservation for all variables in the formula.
+  maxsat_formula->newVar(max_var);
+
+  vec<Lit> lits;
+  for (size_t i = 0; i < chunks.size(); i++) {
+    ChunkBuffer &c = chunks[i];
+    int pos = 0;
+    for (size_t j = 0; j < c.sizes.size(); j++) {
+      lits.clear();
+      for (int k = 0; k < c.sizes[j]; k++, pos++) {
+        int parsed_lit = c.lits[pos];
+        int var = abs(parsed_lit) - 1;
+        lits.push((parsed_lit > 0) ? mkLit(var) : ~mkLit(var));
+      }
+
+      uint64_t weight = weighted ? c.weights[j] : 1;
+      if (weight < hard_weight || !weighted) {
+        assert(weight > 0);
+        maxsat_formula->setMaximumWeight(weight);
+        maxsat_formula->updateSumWeights(weight);
+        maxsat_formula->addSoftClause(weight, lits);
+      } else
+        maxsat_formula->addHardClause(lits);
+    }
+
+    // Release the buffer as soon as it has been merged.
+    std::vector<int>().swap(c.lits);
+    std::vector<int>().swap(c.sizes);
+    std::vector<uint64_t>().swap(c.weights);
+  }
+}
+
+void ParserMaxSATParallel::parseError(const char *pos, const char *end) {
+  printf("c PARSE ERROR! Unexpected char: %c\n", pos < end ? *pos : ' ');
+  printf("s UNKNOWN\n");
+  exit(_ERROR_);
+}
@@ -0,0 +1,92 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ParserMaxSATParallel_h
+#define ParserMaxSATParallel_h
+
+#include "MaxSATFormula.h"
+
+#include <vector>
+
+using NSPACE::vec;
+
+namespace openwbo {
+
+/*! Multi-threaded parser for uncompressed WCNF files. The file is mapped into
+ * memory, split into line-aligned chunks that are parsed concurrently into
+ * per-thread clause buffers, and then merged into the MaxSAT formula in file
+ * order with a single variable reservation.
+ *
+ * Compressed files are not handled by this parser; 'parse' returns false and
+ * the caller should fall back to 'parseMaxSATFormula' in ParserMaxSAT.h. */
+class ParserMaxSATParallel {
+
+public:
+  ParserMaxSATParallel(int threads = 1) : n_threads(threads) {}
+  ~ParserMaxSATParallel() {}
+
+  // Parses 'fileName' into 'maxsat_formula'. Returns false if the file cannot
+  // be memory mapped (e.g. if it is compressed) and nothing was loaded.
+  bool parse(const char *fileName, MaxSATFormula *maxsat_formula);
+
+protected:
+  // Clauses parsed by one thread. Literals are stored in DIMACS notation and
+  // clause 'i' spans 'sizes[i]' consecutive entries of 'lits'.
+  struct ChunkBuffer {
+    const char *begin;
+    const char *end;
+    std::vector<int> lits;
+    std::vector<int> sizes;
+    std::vector<uint64_t> weights; // Only used for weighted formulas.
+    int max_var;
+    const char *error; // Position of the first parse error (NULL if none).
+  };
+
+  // Parses the comment lines and the 'p' line at the top of the file.
+  // Returns a pointer to the first clause line.
+  const char *parseHeader(const char *in, const char *end,
+                          MaxSATFormula *maxsat_formula);
+
+  // Parses all clauses in [chunk->begin, chunk->end).
+  static void parseChunk(ChunkBuffer *chunk, bool weighted);
+
+  // Adds the clauses of all chunks to the formula in file order.
+  void merge(std::vector<ChunkBuffer> &chunks, MaxSATFormula *maxsat_formula);
+
+  // Reports a parse error at position 'pos' and exits.
+  void parseError(const char *pos, const char *end);
+
+  int n_threads;        // Number of parser threads.
+  bool weighted;        // True if the file has a 'p wcnf' header.
+  uint64_t hard_weight; // Weight of hard clauses (from the header).
+};
+
+} // namespace openwbo
+
+#endif
@@ -0,0 +1,431 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "Portfolio.h"
+
+#include <inttypes.h>
+#include <thread>
+#include <vector>
+
+using NSPACE::OutOfMemoryException;
+using namespace openwbo;
+
+static const char *algorithmName(int alg) {
+  switch (alg) {
+  case _ALGORITHM_WBO_:
+    return "WBO";
+  case _ALGORITHM_LINEAR_SU_:
+    return "LinearSU";
+  case _ALGORITHM_MSU3_:
+    return "MSU3";
+  case _ALGORITHM_PART_MSU3_:
+    return "PartMSU3";
+  case _ALGORITHM_OLL_:
+    return "OLL";
+  case _ALGORITHM_BASIC_:
+    return "Basic";
+  case _ALGORITHM_BCD_:
+    return "BCD";
+  default:
+    return "Unknown";
+  }
+}
+
+/************************************************************************************************
+ //
+ // Portfolio worker
+ //
+ ************************************************************************************************/
+
+PortfolioWorker::PortfolioWorker(Portfolio *p, MaxSAT *S, int alg)
+    : portfolio(p), solver(S), algorithm(alg), status(_UNKNOWN_),
+      active(NULL), best_cost(UINT64_MAX), exchange(NULL), thread_id(0),
+      share_lbd(0), n_original(0), export_clauses(false), nb_exported(0),
+      nb_imported(0) {
+  // The lower bound of the core-guided algorithms is the sum of the costs of
+  // the cores found so far. The linear search algorithms only use 'lbCost'
+  // for the levels of BMO instances that are already fixed.
+  share_lb = algorithm == _ALGORITHM_WBO_ || algorithm == _ALGORITHM_MSU3_ ||
+             algorithm == _ALGORITHM_PART_MSU3_ ||
+             algorithm == _ALGORITHM_OLL_ || algorithm == _ALGORITHM_BCD_;
+}
+
+PortfolioWorker::~PortfolioWorker() { delete solver; }
+
+void PortfolioWorker::run() {
+  try {
+    status = solver->search();
+  } catch (SearchInterrupted &) {
+    status = _UNKNOWN_;
+  } catch (MaxSATException &) {
+    status = _ERROR_;
+  } catch (OutOfMemoryException &) {
+    status = _ERROR_;
+  }
+  portfolio->finished(this);
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  publishModel : (model : vec<lbool>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Publishes a model saved by the algorithm. Its cost is computed on the
+  |    formula of the portfolio, since the copy used by the algorithm may
+  |    have been extended with new soft clauses.
+  |
+  |________________________________________________________________________________________________@*/
+void PortfolioWorker::publishModel(vec<lbool> &model) {
+  uint64_t cost = evaluator.cost(portfolio->getMaxSATFormula(), model);
+  if (cost < best_cost) {
+    best_cost = cost;
+    portfolio->publishUB(cost, model);
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  beginSearch : (S : SATBackend *) (lb : uint64_t)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Registers 'S' as the SAT solver of this worker before a SAT call and
+  |    publishes the lower bound of the algorithm. Throws 'SearchInterrupted'
+  |    if the portfolio has been stopped.
+  |
+  |    The solver is registered before the stop flag is checked, so either
+  |    this thread sees the flag or 'Portfolio::stop' sees the solver.
+  |
+  |________________________________________________________________________________________________@*/
+void PortfolioWorker::beginSearch(SATBackend *S, uint64_t lb) {
+  if (share_lb)
+    portfolio->publishLB(lb);
+
+  active_lock.lock();
+  active = S;
+  active_lock.unlock();
+
+  if (portfolio->isStopped()) {
+    endSearch();
+    throw SearchInterrupted();
+  }
+}
+
+void PortfolioWorker::endSearch() {
+  active_lock.lock();
+  active = NULL;
+  active_lock.unlock();
+
+  // The result of an interrupted call is not meaningful.
+  if (portfolio->isStopped())
+    throw SearchInterrupted();
+}
+
+void PortfolioWorker::interrupt() {
+  active_lock.lock();
+  if (active != NULL)
+    active->terminate();
+  active_lock.unlock();
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  setExchange : (e : ClauseExchange *) (id : int) (lbd : unsigned)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Shares the learnt clauses of the SAT solvers of this worker through
+  |    'e'. Every worker imports clauses, but only the algorithms whose SAT
+  |    solvers hold the hard clauses plus clauses that any model of the hard
+  |    clauses can satisfy through fresh variables export them. This is the
+  |    case of the core-guided algorithms (the soft clauses are relaxed with
+  |    variables that are assumed, and the cardinality constraints are
+  |    enforced with assumptions), so their learnt clauses over the original
+  |    variables are implied by the hard clauses. The linear search
+  |    algorithms add the upper bound as hard clauses and never export.
+  |
+  |  Pre-conditions:
+  |    * The algorithm has loaded its copy of the formula.
+  |
+  |________________________________________________________________________________________________@*/
+void PortfolioWorker::setExchange(ClauseExchange *e, int id, unsigned lbd) {
+  exchange = e;
+  thread_id = id;
+  share_lbd = lbd;
+  n_original = portfolio->getMaxSATFormula()->nVars();
+  export_clauses = share_lb;
+}
+
+Solver *PortfolioWorker::newSATSolver() {
+#ifdef CLAUSE_SHARING
+  if (exchange != NULL)
+    return new SharingSolver(this);
+#endif
+  return NULL;
+}
+
+void PortfolioWorker::exportClause(const vec<Lit> &clause) {
+  for (int i = 0; i < clause.size(); i++)
+    if (var(clause[i]) >= n_original)
+      return;
+  if (exchange->push(thread_id, clause))
+    nb_exported++;
+}
+
+bool PortfolioWorker::importClause(vec<Lit> &clause) {
+  if (!exchange->pop(thread_id, clause))
+    return false;
+  nb_imported++;
+  return true;
+}
+
+#ifdef CLAUSE_SHARING
+/************************************************************************************************
+ //
+ // SAT solver with clause sharing
+ //
+ ************************************************************************************************/
+
+void SharingSolver::parallelExportUnaryClause(Lit p) {
+  if (!worker->exportsLBD(1))
+    return;
+  buffer.clear();
+  buffer.push(p);
+  worker->exportClause(buffer);
+}
+
+void SharingSolver::parallelExportClauseDuringSearch(NSPACE::Clause &c) {
+  // The permanent learnt clauses of the Chanseok strategy do not store
+  // their lbd, which is only known to be at most 'coLBDBound'. They are
+  // exported only if that bound is within the sharing bound.
+  if (!worker->exportsLBD(c.learnt() ? c.lbd() : coLBDBound))
+    return;
+  buffer.clear();
+  for (int i = 0; i < c.size(); i++)
+    buffer.push(c[i]);
+  worker->exportClause(buffer);
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  parallelImportClauses : [void]  ->  [bool]
+  |
+  |  Description:
+  |
+  |    Adds the clauses exported by the other threads as problem clauses.
+  |    Clauses with variables that are unknown or eliminated in this solver
+  |    are ignored. Returns true if an empty clause was derived.
+  |
+  |  Pre-conditions:
+  |    * The solver is at decision level 0.
+  |
+  |________________________________________________________________________________________________@*/
+bool SharingSolver::parallelImportClauses() {
+  while (worker->importClause(buffer)) {
+    bool known = true;
+    for (int i = 0; i < buffer.size() && known; i++) {
+      known = var(buffer[i]) < nVars();
+#ifdef SIMP
+      known = known && !isEliminated(var(buffer[i]));
+#endif
+    }
+    if (known && !addClause_(buffer))
+      return true;
+  }
+  return false;
+}
+#endif
+
+/************************************************************************************************
+ //
+ // Portfolio
+ //
+ ************************************************************************************************/
+
+Portfolio::Portfolio(int verb)
+    : stopped(false), share_lbd(0), exchange(NULL) {
+  verbosity = verb;
+}
+
+Portfolio::~Portfolio() {
+  for (int i = 0; i < workers.size(); i++)
+    delete workers[i];
+  if (exchange != NULL)
+    delete exchange;
+}
+
+void Portfolio::addAlgorithm(MaxSAT *S, int alg) {
+  workers.push(new PortfolioWorker(this, S, alg));
+}
+
+void Portfolio::publishUB(uint64_t cost, vec<lbool> &currentModel) {
+  if (!board.updateUB(cost))
+    return;
+
+  answer_lock.lock();
+  // Another thread may have published a better model after the update.
+  if (model.size() == 0 || cost < ubCost) {
+    currentModel.copyTo(model);
+    ubCost = cost;
+    printBound(ubCost + off_set);
+  }
+  answer_lock.unlock();
+
+  checkGap();
+}
+
+void Portfolio::publishLB(uint64_t bound) {
+  if (board.updateLB(bound))
+    checkGap();
+}
+
+void Portfolio::finished(PortfolioWorker *w) {
+  switch (w->getStatus()) {
+  case _OPTIMUM_:
+    // The best model published by the worker is optimal.
+    if (w->getBestCost() != UINT64_MAX)
+      publishLB(w->getBestCost());
+    break;
+  case _UNSATISFIABLE_:
+    board.setUnsat();
+    checkGap();
+    break;
+  default:
+    break;
+  }
+
+  if (verbosity > 0) {
+    printf("c  %s finished with status %d\n",
+           algorithmName(w->getAlgorithmType()), w->getStatus());
+    if (exchange != NULL)
+      printf("c  %s exported %" PRIu64 " and imported %" PRIu64
+             " clauses\n",
+             algorithmName(w->getAlgorithmType()), w->nExported(),
+             w->nImported());
+  }
+}
+
+void Portfolio::checkGap() {
+  if (board.gapClosed())
+    stop();
+}
+
+void Portfolio::stop() {
+  if (stopped.exchange(true))
+    return;
+  for (int i = 0; i < workers.size(); i++)
+    workers[i]->interrupt();
+}
+
+void Portfolio::printConfiguration() {
+  if (!print)
+    return;
+
+  printf("c ==========================================[ Solver Settings "
+         "]============================================\n");
+  printf("c |                                                                "
+         "                                       |\n");
+  printf("c |  Algorithm: %23s                                             "
+         "                      |\n",
+         "Portfolio");
+  for (int i = 0; i < workers.size(); i++)
+    printf("c |  Thread %2d: %23s                                             "
+           "                      |\n",
+           i, algorithmName(workers[i]->getAlgorithmType()));
+  printf("c |                                                                "
+         "                                       |\n");
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  search : [void] ->  [StatusCode]
+  |
+  |  Description:
+  |
+  |    Runs every algorithm of the portfolio in its own thread until one of
+  |    them proves optimality or unsatisfiability, or until the lower and
+  |    upper bounds published by different threads meet.
+  |
+  |  Pre-conditions:
+  |    * At least one algorithm was added with 'addAlgorithm'.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode Portfolio::search() {
+  if (workers.size() == 0)
+    throw MaxSATException(__FILE__, __LINE__, "Empty portfolio");
+
+  printConfiguration();
+
+#ifdef CLAUSE_SHARING
+  // Each clause is stored with a header of three integers. The clauses are
+  // exchanged through hooks of glucose 4.1.
+  if (share_lbd > 0 && workers.size() > 1 && sat_solver == _SAT_GLUCOSE41_)
+    exchange = new ClauseExchange(workers.size(), 100000 * workers.size());
+#endif
+
+  for (int i = 0; i < workers.size(); i++) {
+    MaxSAT *S = workers[i]->getAlgorithm();
+    S->loadFormula(maxsat_formula->copyMaxSATFormula());
+    S->setInitialTime(initialTime);
+    S->setPrint(false);
+    S->setPortfolioWorker(workers[i]);
+    if (exchange != NULL)
+      workers[i]->setExchange(exchange, i, share_lbd);
+  }
+
+  // A model of the local search bounds the models published by the threads.
+  importUpperBound();
+  if (model.size() != 0)
+    board.updateUB(ubCost);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < workers.size(); i++)
+    threads.push_back(std::thread(&PortfolioWorker::run, workers[i]));
+  for (size_t i = 0; i < threads.size(); i++)
+    threads[i].join();
+
+  if (exchange != NULL && verbosity > 0)
+    printf("c Shared clauses: %" PRIu64 " (%" PRIu64 " dropped)\n",
+           exchange->nPushed(), exchange->nDropped());
+
+  if (board.isUnsat()) {
+    printAnswer(_UNSATISFIABLE_);
+    return _UNSATISFIABLE_;
+  }
+
+  lbCost = board.getLB();
+  if (model.size() != 0 && lbCost >= ubCost) {
+    printAnswer(_OPTIMUM_);
+    return _OPTIMUM_;
+  }
+
+  printAnswer(_UNKNOWN_);
+  return searchStatus;
+}
@@ -0,0 +1,230 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef Portfolio_h
+#define Portfolio_h
+
+#include "ClauseExchange.h"
+#include "CostEvaluator.h"
+#include "MaxSAT.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+namespace openwbo {
+
+class Portfolio;
+class PortfolioWorker;
+
+/*! Thrown inside a portfolio thread when the search has been stopped. */
+class SearchInterrupted {};
+
+/*! Bounds shared by the threads of the portfolio.
+ *
+ * The board only holds numbers and is updated with compare-and-swap loops,
+ * so publishing a bound never blocks a thread. Costs do not include the
+ * offset of the objective function. */
+class BoundBoard {
+
+public:
+  BoundBoard() : ub(UINT64_MAX), lb(0), unsat(false) {}
+
+  // Lowers the upper bound to 'cost'. Returns true if 'cost' improved it.
+  bool updateUB(uint64_t cost) {
+    uint64_t current = ub.load();
+    while (cost < current)
+      if (ub.compare_exchange_weak(current, cost))
+        return true;
+    return false;
+  }
+
+  // Raises the lower bound to 'bound'. Returns true if 'bound' improved it.
+  bool updateLB(uint64_t bound) {
+    uint64_t current = lb.load();
+    while (bound > current)
+      if (lb.compare_exchange_weak(current, bound))
+        return true;
+    return false;
+  }
+
+  void setUnsat() { unsat.store(true); }
+  bool isUnsat() { return unsat.load(); }
+
+  uint64_t getUB() { return ub.load(); }
+  uint64_t getLB() { return lb.load(); }
+
+  // True if the formula is unsatisfiable or the bounds have met.
+  bool gapClosed() { return isUnsat() || getLB() >= getUB(); }
+
+protected:
+  std::atomic<uint64_t> ub;
+  std::atomic<uint64_t> lb;
+  std::atomic<bool> unsat;
+};
+
+#ifdef CLAUSE_SHARING
+/*! SAT solver of a portfolio thread that shares its learnt clauses.
+ *
+ * The clauses are exported and imported by the worker through the hooks
+ * that glucose-syrup uses for its parallel solver. Clauses are imported at
+ * decision level 0, i.e. on each restart. */
+#ifdef SIMP
+class SharingSolver : public NSPACE::SimpSolver {
+#else
+class SharingSolver : public NSPACE::Solver {
+#endif
+
+public:
+  SharingSolver(PortfolioWorker *w) : worker(w) {}
+
+protected:
+  void parallelExportUnaryClause(Lit p);
+  void parallelExportClauseDuringSearch(NSPACE::Clause &c);
+  bool parallelImportClauses();
+
+  PortfolioWorker *worker;
+  vec<Lit> buffer;
+};
+#endif
+
+/*! One algorithm of the portfolio, running on its own copy of the formula.
+ *
+ * The algorithm reports to the worker through 'MaxSAT::saveModel' and
+ * 'MaxSAT::searchSATSolver'. The SAT solver that is currently searching is
+ * registered so that it can be interrupted from another thread. */
+class PortfolioWorker {
+
+public:
+  PortfolioWorker(Portfolio *p, MaxSAT *S, int alg);
+  ~PortfolioWorker();
+
+  void run(); // Thread entry point.
+
+  // Called by the algorithm.
+  void publishModel(vec<lbool> &model);
+  void beginSearch(SATBackend *S, uint64_t lb);
+  void endSearch();
+
+  // Called by the portfolio to stop the current SAT call.
+  void interrupt();
+
+  // Clause sharing through 'exchange' as thread 'id'. Only clauses with
+  // lbd <= 'lbd' and variables of the original formula are exported.
+  void setExchange(ClauseExchange *e, int id, unsigned lbd);
+  Solver *newSATSolver(); // NULL if clauses are not shared.
+  bool exportsLBD(unsigned lbd) { return export_clauses && lbd <= share_lbd; }
+  void exportClause(const vec<Lit> &clause);
+  bool importClause(vec<Lit> &clause);
+  // Called by the algorithm before it adds clauses that are not implied by
+  // the hard clauses. Later learnt clauses are not exported.
+  void stopExport() { export_clauses = false; }
+
+  MaxSAT *getAlgorithm() { return solver; }
+  int getAlgorithmType() { return algorithm; }
+  StatusCode getStatus() { return status; }
+  uint64_t getBestCost() { return best_cost; }
+  uint64_t nExported() { return nb_exported; }
+  uint64_t nImported() { return nb_imported; }
+
+protected:
+  Portfolio *portfolio;
+  MaxSAT *solver;        // Algorithm run by this worker.
+  int algorithm;         // Type of the algorithm (see MaxTypes.h).
+  bool share_lb;         // True if 'lbCost' of the algorithm is a lower bound.
+  StatusCode status;     // Result of the search.
+
+  std::mutex active_lock;
+  SATBackend *active;    // SAT solver in a 'searchSATSolver' call.
+
+  CostEvaluator evaluator; // Cost of models on the original formula.
+  uint64_t best_cost;      // Cost of the best model of this worker.
+
+  // Clause sharing
+  ClauseExchange *exchange;           // NULL if clauses are not shared.
+  int thread_id;                      // Identifier in 'exchange'.
+  unsigned share_lbd;                 // Maximum lbd of exported clauses.
+  int n_original;                     // Variables of the original formula.
+  std::atomic<bool> export_clauses;   // True if learnt clauses are exported.
+  std::atomic<uint64_t> nb_exported;  // Statistics
+  std::atomic<uint64_t> nb_imported;
+};
+
+/*! Runs several MaxSAT algorithms concurrently.
+ *
+ * Each algorithm works on a copy of the formula in its own thread. Improving
+ * models and proven lower bounds are published on a shared 'BoundBoard'.
+ * When the bounds meet (or a thread proves the formula unsatisfiable) all
+ * SAT solvers are stopped with 'SATBackend::terminate'. The best model is
+ * kept in this object, which prints the bounds and the final answer.
+ *
+ * Short learnt clauses over the variables of the original formula are
+ * shared between the threads through a 'ClauseExchange'. */
+class Portfolio : public MaxSAT {
+
+public:
+  Portfolio(int verb = _VERBOSITY_MINIMAL_);
+  ~Portfolio();
+
+  // Adds an algorithm of type 'alg' to the portfolio. The portfolio takes
+  // ownership of 'S'.
+  void addAlgorithm(MaxSAT *S, int alg);
+  int nAlgorithms() { return workers.size(); }
+
+  // Shares the learnt clauses with lbd <= 'lbd' between the threads
+  // (0 disables clause sharing). Only glucose 4.1 shares clauses.
+  void setShareLBD(int lbd) { share_lbd = lbd; }
+
+  StatusCode search();
+
+protected:
+  friend class PortfolioWorker;
+
+  void publishUB(uint64_t cost, vec<lbool> &currentModel);
+  void publishLB(uint64_t bound);
+  void finished(PortfolioWorker *w);
+
+  void checkGap(); // Stops all threads if the gap is closed.
+  void stop();     // Interrupts all threads.
+  bool isStopped() { return stopped.load(); }
+
+  void printConfiguration();
+
+  BoundBoard board;
+  std::atomic<bool> stopped;
+  std::mutex answer_lock; // Protects 'model' and the output of bounds.
+  vec<PortfolioWorker *> workers;
+
+  int share_lbd;              // Maximum lbd of shared clauses.
+  ClauseExchange *exchange;   // Clauses shared by the threads.
+};
+
+} // namespace openwbo
+
+#endif
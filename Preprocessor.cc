@@ -0,0 +1,190 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "Preprocessor.h"
+#include "simp/SimpSolver.h"
+
+using NSPACE::Clause;
+using NSPACE::Var;
+using NSPACE::lit_Undef;
+using NSPACE::toLit;
+
+using namespace openwbo;
+
+namespace {
+
+// Gives access to the simplified clause database and to the elimination
+// stack of the SAT solver.
+class EliminationSolver : public NSPACE::SimpSolver {
+
+public:
+  void freeze(Lit l) {
+    if (l != lit_Undef && var(l) < nVars())
+      setFrozen(var(l), true);
+  }
+
+  // Adds the clauses that survived the simplification to 'formula'.
+  void exportClauses(MaxSATFormula *formula) {
+    vec<Lit> clause;
+    for (int i = 0; i < trail.size(); i++) {
+      clause.clear();
+      clause.push(trail[i]);
+      formula->addHardClause(clause);
+    }
+
+    for (int i = 0; i < clauses.size(); i++) {
+      const Clause &c = ca[clauses[i]];
+      if (c.mark() == 1)
+        continue;
+
+      bool satisfied = false;
+      clause.clear();
+      for (int j = 0; j < c.size() && !satisfied; j++) {
+        if (value(c[j]) == l_True)
+          satisfied = true;
+        else if (value(c[j]) == l_Undef)
+          clause.push(c[j]);
+      }
+
+      if (!satisfied)
+        formula->addHardClause(clause);
+    }
+  }
+
+  void exportElimination(vec<uint32_t> &stack) { elimclauses.copyTo(stack); }
+};
+
+} // namespace
+
+/*_________________________________________________________________________________________________
+  |
+  |  simplify : (formula : MaxSATFormula *)  ->  [bool]
+  |
+  |  Description:
+  |
+  |    Simplifies the hard clauses of 'formula' with the SAT solver. The soft
+  |    clauses, cardinality and PB constraints and the objective function are
+  |    not changed and their variables are frozen.
+  |
+  |  Post-conditions:
+  |    * If the hard clauses are satisfiable, they are replaced by the
+  |      simplified ones and 'elimclauses' allows to extend models.
+  |
+  |________________________________________________________________________________________________@*/
+bool Preprocessor::simplify(MaxSATFormula *formula) {
+  EliminationSolver S;
+  S.verbosity = 0;
+
+  n_vars = formula->nVars();
+  n_hard_before = formula->nHard();
+  for (int i = 0; i < n_vars; i++)
+    S.newVar();
+
+  for (int i = 0; i < formula->nSoft(); i++) {
+    Soft soft = formula->getSoftClause(i);
+    for (int j = 0; j < soft.clause.size(); j++)
+      S.freeze(soft.clause[j]);
+    for (int j = 0; j < soft.relaxation_vars.size(); j++)
+      S.freeze(soft.relaxation_vars[j]);
+    S.freeze(soft.assumption_var);
+  }
+
+  for (int i = 0; i < formula->nCard(); i++) {
+    Card *card = formula->getCardinalityConstraint(i);
+    for (int j = 0; j < card->_lits.size(); j++)
+      S.freeze(card->_lits[j]);
+  }
+
+  for (int i = 0; i < formula->nPB(); i++) {
+    PB *pb = formula->getPBConstraint(i);
+    for (int j = 0; j < pb->_lits.size(); j++)
+      S.freeze(pb->_lits[j]);
+  }
+
+  if (formula->getObjFunction() != NULL) {
+    PBObjFunction *of = formula->getObjFunction();
+    for (int j = 0; j < of->_lits.size(); j++)
+      S.freeze(of->_lits[j]);
+  }
+
+  vec<Lit> clause;
+  for (int i = 0; i < formula->nHard(); i++) {
+    formula->getHardClause(i).clause.copyTo(clause);
+    if (!S.addClause(clause))
+      return false;
+  }
+
+  if (!S.eliminate(true))
+    return false;
+
+  n_eliminated = 0;
+  for (Var v = 0; v < n_vars; v++)
+    if (S.isEliminated(v))
+      n_eliminated++;
+
+  formula->clearHardClauses();
+  S.exportClauses(formula);
+  S.exportElimination(elimclauses);
+
+  return true;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  extendModel : (model : vec<lbool>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Assigns the eliminated variables of 'model' by going backwards through
+  |    the clauses removed by the variable elimination. Each eliminated
+  |    variable satisfies the removed clauses that are not satisfied by the
+  |    rest of the model.
+  |
+  |  Pre-conditions:
+  |    * 'model' satisfies the simplified hard clauses.
+  |
+  |________________________________________________________________________________________________@*/
+void Preprocessor::extendModel(vec<lbool> &model) {
+  if (model.size() < n_vars)
+    model.growTo(n_vars, l_False);
+
+  int i, j;
+  Lit x;
+  for (i = elimclauses.size() - 1; i > 0; i -= j) {
+    for (j = elimclauses[i--]; j > 1; j--, i--) {
+      x = toLit(elimclauses[i]);
+      if ((model[var(x)] ^ sign(x)) != l_False)
+        goto next;
+    }
+
+    x = toLit(elimclauses[i]);
+    model[var(x)] = lbool(!sign(x));
+  next:;
+  }
+}
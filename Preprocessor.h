@@ -0,0 +1,78 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef Preprocessor_h
+#define Preprocessor_h
+
+#include "MaxSATFormula.h"
+
+using NSPACE::vec;
+using NSPACE::Lit;
+using NSPACE::lbool;
+
+namespace openwbo {
+
+/*! MaxSAT-safe preprocessing of the hard clauses.
+ *
+ * Runs bounded variable elimination, subsumption and self-subsuming
+ * resolution of the SAT solver once on the hard clauses, before the MaxSAT
+ * algorithm starts. Every variable that occurs in a soft clause (including
+ * its relaxation and assumption variables), in a cardinality or PB constraint
+ * or in the objective function is frozen, so the simplified formula has the
+ * same optimum as the original one. Models of the simplified formula are
+ * mapped back to the original formula with 'extendModel'. */
+class Preprocessor {
+
+public:
+  Preprocessor() : n_vars(0), n_eliminated(0), n_hard_before(0) {}
+
+  // Simplifies the hard clauses of 'formula' in place. Returns false if they
+  // are unsatisfiable, in which case 'formula' is left unchanged.
+  bool simplify(MaxSATFormula *formula);
+
+  // Assigns the variables eliminated by 'simplify' in 'model'.
+  void extendModel(vec<lbool> &model);
+
+  int nEliminated() { return n_eliminated; }
+  int nHardBefore() { return n_hard_before; }
+
+protected:
+  int n_vars;        // Variables of the formula when it was simplified.
+  int n_eliminated;  // Eliminated variables.
+  int n_hard_before; // Hard clauses before the simplification.
+
+  // Clauses removed by the variable elimination, in the layout used by the
+  // SAT solver: the literals of each clause, with the eliminated one first,
+  // followed by the size of the clause.
+  vec<uint32_t> elimclauses;
+};
+
+} // namespace openwbo
+
+#endif
@@ -0,0 +1,247 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "SATBackend.h"
+#include "MultiSolver.h"
+
+using namespace openwbo;
+
+SATBackend *SATBackend::create(int solver) {
+  switch (solver) {
+  case _SAT_GLUCOSE41_:
+#ifdef SIMP
+    return new NativeBackend(new NSPACE::SimpSolver());
+#else
+    return new NativeBackend(new Solver());
+#endif
+#ifdef IPASIR_SOLVERS
+  case _SAT_GLUCOSE40_:
+    return new IPASIRBackend(&ipasir_glucose40);
+  case _SAT_MINISAT22_:
+    return new IPASIRBackend(&ipasir_minisat22);
+#endif
+  default:
+    printf("c Error: The SAT solver is not available in this build.\n");
+    printf("s UNKNOWN\n");
+    exit(_ERROR_);
+  }
+}
+
+const char *SATBackend::name(int solver) {
+  switch (solver) {
+  case _SAT_GLUCOSE41_:
+    return "glucose4.1";
+  case _SAT_GLUCOSE40_:
+    return "glucose4.0";
+  case _SAT_MINISAT22_:
+    return "minisat2.2";
+  default:
+    return "unknown";
+  }
+}
+
+/************************************************************************************************
+ //
+ // Glucose 4.1
+ //
+ ************************************************************************************************/
+
+NativeBackend::NativeBackend(Solver *S)
+    : solver(S), conflict_limit(-1) {}
+
+NativeBackend::~NativeBackend() { delete solver; }
+
+Var NativeBackend::newVar() {
+#ifdef SIMP
+  return ((NSPACE::SimpSolver *)solver)->newVar();
+#else
+  return solver->newVar();
+#endif
+}
+
+void NativeBackend::add(Lit p) {
+  if (p != NSPACE::lit_Undef) {
+    clause.push(p);
+    return;
+  }
+
+  // As in IPASIR, the variables of the clause are created on demand.
+  for (int i = 0; i < clause.size(); i++)
+    while (var(clause[i]) >= solver->nVars())
+      newVar();
+  solver->addClause(clause);
+  clause.clear();
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  solve : [void]  ->  [lbool]
+  |
+  |  Description:
+  |
+  |    Solves with the current assumptions and conflict limit, which are both
+  |    reset afterwards. The call of a MultiSolver runs its helpers in
+  |    parallel. Preprocessing is never used, since the variables of the
+  |    encodings are added between the calls.
+  |
+  |  Post-conditions:
+  |    * If the call is unsatisfiable, 'core' has the assumptions whose
+  |      negation is in the conflict of the solver and 'failed_lits' marks
+  |      them.
+  |
+  |________________________________________________________________________________________________@*/
+lbool NativeBackend::solve() {
+  if (conflict_limit >= 0)
+    solver->setConfBudget(conflict_limit);
+
+  MultiSolver *M = dynamic_cast<MultiSolver *>(solver);
+  lbool res;
+  if (M != NULL)
+    res = M->solveParallel(assumptions);
+  else
+#ifdef SIMP
+    res = ((NSPACE::SimpSolver *)solver)->solveLimited(assumptions, false);
+#else
+    res = solver->solveLimited(assumptions);
+#endif
+
+  if (conflict_limit >= 0)
+    solver->budgetOff();
+  assumptions.clear();
+  conflict_limit = -1;
+
+  for (int i = 0; i < core.size(); i++)
+    failed_lits[toInt(core[i])] = 0;
+  core.clear();
+  if (res == l_False) {
+    failed_lits.growTo(2 * solver->nVars(), 0);
+    for (int i = 0; i < solver->conflict.size(); i++) {
+      core.push(~solver->conflict[i]);
+      failed_lits[toInt(core.last())] = 1;
+    }
+  }
+  return res;
+}
+
+/************************************************************************************************
+ //
+ // IPASIR solvers
+ //
+ ************************************************************************************************/
+
+IPASIRBackend::IPASIRBackend(const IPASIRSolver *api)
+    : api(api), n_vars(0), conflict_limit(-1), terminated(false) {
+  solver = api->init();
+  if (api->set_terminate != NULL)
+    api->set_terminate(solver, this, stop);
+}
+
+IPASIRBackend::~IPASIRBackend() { api->release(solver); }
+
+int IPASIRBackend::stop(void *data) {
+  return ((IPASIRBackend *)data)->terminated.load();
+}
+
+void IPASIRBackend::add(Lit p) {
+  if (p == NSPACE::lit_Undef) {
+    api->add(solver, 0);
+    return;
+  }
+  if (var(p) >= n_vars)
+    n_vars = var(p) + 1;
+  api->add(solver, toDimacs(p));
+}
+
+void IPASIRBackend::assume(Lit p) {
+  if (var(p) >= n_vars)
+    n_vars = var(p) + 1;
+  assumptions.push(p);
+  api->assume(solver, toDimacs(p));
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  solve : [void]  ->  [lbool]
+  |
+  |  Description:
+  |
+  |    Solves with the current assumptions. The conflict limit is ignored if
+  |    the solver does not support it.
+  |
+  |  Post-conditions:
+  |    * If the call is satisfiable, 'model' has the value of each variable.
+  |      The variables whose value does not matter are false.
+  |    * If the call is unsatisfiable, 'conflict' has the negation of the
+  |      failed assumptions.
+  |
+  |________________________________________________________________________________________________@*/
+lbool IPASIRBackend::solve() {
+  if (conflict_limit >= 0 && api->limit != NULL)
+    api->limit(solver, conflict_limit);
+  conflict_limit = -1;
+
+  int res = terminated.load() ? 0 : api->solve(solver);
+
+  model_.clear();
+  conflict_.clear();
+  if (res == 10) {
+    model_.growTo(n_vars, l_False);
+    for (int v = 0; v < n_vars; v++)
+      if (api->val(solver, v + 1) > 0)
+        model_[v] = l_True;
+  } else if (res == 20) {
+    for (int i = 0; i < assumptions.size(); i++)
+      if (api->failed(solver, toDimacs(assumptions[i])))
+        conflict_.push(~assumptions[i]);
+  }
+  assumptions.clear();
+
+  return res == 10 ? l_True
+                   : (res == 20 ? l_False : l_Undef);
+}
+
+lbool IPASIRBackend::val(Lit p) {
+  assert(var(p) < model_.size());
+  return model_[var(p)] ^ sign(p);
+}
+
+bool IPASIRBackend::failed(Lit p) {
+  return api->failed(solver, toDimacs(p)) != 0;
+}
+
+void IPASIRBackend::terminate() {
+  terminated.store(true);
+  if (api->interrupt != NULL)
+    api->interrupt(solver);
+}
+
+void IPASIRBackend::phase(Lit p) {
+  if (api->phase != NULL)
+    api->phase(solver, toDimacs(p));
+}
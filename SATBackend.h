@@ -0,0 +1,227 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SATBackend_h
+#define SATBackend_h
+
+#ifdef SIMP
+#include "simp/SimpSolver.h"
+#else
+#include "core/Solver.h"
+#endif
+
+#include "ipasir/IPASIR.h"
+#include "MaxTypes.h"
+
+#include <atomic>
+#include <stdint.h>
+
+using NSPACE::vec;
+using NSPACE::Var;
+using NSPACE::Lit;
+using NSPACE::lbool;
+using NSPACE::Solver;
+
+namespace openwbo {
+
+/*! Incremental SAT solver interface in the style of IPASIR.
+ *
+ * Clauses are added literal by literal and closed with 'lit_Undef'.
+ * Assumptions only hold for the next call of 'solve'. After a satisfiable
+ * call 'val' gives the model, and after an unsatisfiable call 'failed'
+ * tells which assumptions are part of the core. The algorithms and the
+ * encodings only talk to the SAT solver through this interface, so that
+ * the solver can be chosen at runtime (see 'create').
+ *
+ * 'model' and 'conflict' give the whole result of the last call in the
+ * format of the native solver. The conflict can be changed by the caller,
+ * e.g. to minimize the core, which does not change 'failed'. The features
+ * that are specific to glucose 4.1 (native cardinality constraints, clause
+ * sharing, warm starts) are reached through 'native', which is NULL for the
+ * other solvers. */
+class SATBackend {
+
+public:
+  virtual ~SATBackend() {}
+
+  // Creates a solver of type 'solver' (see MaxTypes.h).
+  static SATBackend *create(int solver);
+  static const char *name(int solver);
+
+  virtual const char *name() = 0;
+
+  // Creates a variable. Variables are also created on demand by 'add'.
+  virtual Var newVar() = 0;
+  virtual int nVars() = 0;
+
+  // Adds 'p' to the current clause, or closes it if 'p' is 'lit_Undef'.
+  virtual void add(Lit p) = 0;
+  // Assumes 'p' in the next call of 'solve'.
+  virtual void assume(Lit p) = 0;
+  // Limits the next call of 'solve' to 'conflicts' conflicts.
+  virtual void limit(int64_t conflicts) = 0;
+  // Returns l_True, l_False, or l_Undef if the call was limited or stopped.
+  virtual lbool solve() = 0;
+  // Value of 'p' in the model of the last satisfiable call.
+  virtual lbool val(Lit p) = 0;
+  // True if the assumption 'p' was used to prove the last call unsatisfiable.
+  virtual bool failed(Lit p) = 0;
+  // Stops the current call of 'solve' from another thread. The later calls
+  // also return l_Undef.
+  virtual void terminate() = 0;
+  // Prefers the polarity of 'p' in the decisions (ignored if unsupported).
+  virtual void phase(Lit p) = 0;
+
+  // Model of the last satisfiable call, indexed by variable.
+  virtual vec<lbool> &model() = 0;
+  // Negation of the failed assumptions of the last unsatisfiable call.
+  virtual vec<Lit> &conflict() = 0;
+
+  // Glucose 4.1 solver behind this backend, or NULL.
+  virtual Solver *native() { return NULL; }
+
+  void addClause(const vec<Lit> &clause) {
+    for (int i = 0; i < clause.size(); i++)
+      add(clause[i]);
+    add(NSPACE::lit_Undef);
+  }
+  void addClause(Lit p) {
+    add(p);
+    add(NSPACE::lit_Undef);
+  }
+  void addClause(Lit p, Lit q) {
+    add(p);
+    add(q);
+    add(NSPACE::lit_Undef);
+  }
+  void addClause(Lit p, Lit q, Lit r) {
+    add(p);
+    add(q);
+    add(r);
+    add(NSPACE::lit_Undef);
+  }
+
+  lbool solve(const vec<Lit> &assumptions) {
+    for (int i = 0; i < assumptions.size(); i++)
+      assume(assumptions[i]);
+    return solve();
+  }
+};
+
+/*! Adapter for the glucose 4.1 solver that open-wbo is built with.
+ *
+ * The adapter owns the solver, which can be a MultiSolver or a solver that
+ * shares clauses with a portfolio. 'model' and 'conflict' are the ones of
+ * the solver. */
+class NativeBackend : public SATBackend {
+
+public:
+  explicit NativeBackend(Solver *S);
+  ~NativeBackend();
+
+  const char *name() { return SATBackend::name(_SAT_GLUCOSE41_); }
+
+  Var newVar();
+  int nVars() { return solver->nVars(); }
+
+  void add(Lit p);
+  void assume(Lit p) { assumptions.push(p); }
+  void limit(int64_t conflicts) { conflict_limit = conflicts; }
+  lbool solve();
+  lbool val(Lit p) { return solver->modelValue(p); }
+  bool failed(Lit p) {
+    return toInt(p) < failed_lits.size() && failed_lits[toInt(p)];
+  }
+  void terminate() { solver->interrupt(); }
+  void phase(Lit p) { solver->setPolarity(var(p), sign(p)); }
+
+  vec<lbool> &model() { return solver->model; }
+  vec<Lit> &conflict() { return solver->conflict; }
+
+  Solver *native() { return solver; }
+
+protected:
+  Solver *solver;
+
+  vec<Lit> clause;      // Clause being added.
+  vec<Lit> assumptions; // Assumptions of the next call.
+  int64_t conflict_limit;
+  vec<Lit> core;         // Failed assumptions of the last call.
+  vec<char> failed_lits; // Marks the literals of 'core' (by 'toInt').
+};
+
+/*! Adapter for a solver with the IPASIR interface (see ipasir/IPASIR.h).
+ *
+ * Literals are translated to the DIMACS format. The model and the conflict
+ * are read with 'val' and 'failed' after each call, so that they can be
+ * used as the ones of the native solver. */
+class IPASIRBackend : public SATBackend {
+
+public:
+  explicit IPASIRBackend(const IPASIRSolver *api);
+  ~IPASIRBackend();
+
+  const char *name() { return api->signature(); }
+
+  Var newVar() { return n_vars++; }
+  int nVars() { return n_vars; }
+
+  void add(Lit p);
+  void assume(Lit p);
+  void limit(int64_t conflicts) { conflict_limit = conflicts; }
+  lbool solve();
+  lbool val(Lit p);
+  bool failed(Lit p);
+  void terminate();
+  void phase(Lit p);
+
+  vec<lbool> &model() { return model_; }
+  vec<Lit> &conflict() { return conflict_; }
+
+protected:
+  static int32_t toDimacs(Lit p) {
+    return sign(p) ? -(var(p) + 1) : var(p) + 1;
+  }
+  static int stop(void *data);
+
+  const IPASIRSolver *api;
+  void *solver;
+  int n_vars;
+
+  vec<Lit> assumptions; // Assumptions of the next call.
+  int64_t conflict_limit;
+  std::atomic<bool> terminated;
+
+  vec<lbool> model_;  // Model of the last satisfiable call.
+  vec<Lit> conflict_; // Conflict of the last unsatisfiable call.
+};
+
+} // namespace openwbo
+
+#endif
@@ -0,0 +1,206 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "SoftKernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define _SOFT_KERNEL_AVX2_
+#include <immintrin.h>
+#endif
+
+using namespace openwbo;
+
+void ModelBitset::load(const vec<lbool> &model) {
+  n_vars = model.size();
+  words.clear();
+  words.growTo((2 * n_vars + 31) / 32, 0);
+
+  // Each word holds the literals of 16 variables.
+  for (int w = 0; w < words.size(); w++) {
+    uint32_t bits = 0;
+    int first = w * 16;
+    int last = first + 16 < n_vars ? first + 16 : n_vars;
+    for (int v = first; v < last; v++) {
+      int shift = 2 * (v - first);
+      bits |= (uint32_t)(model[v] == l_True) << shift;
+      bits |= (uint32_t)(model[v] == l_False) << (shift + 1);
+    }
+    words[w] = bits;
+  }
+}
+
+bool SoftKernel::useAVX2() {
+#ifdef _SOFT_KERNEL_AVX2_
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return avx2;
+#else
+  return false;
+#endif
+}
+
+void SoftKernel::clear() {
+  for (int k = 0; k < _SHORT_CLAUSE_SIZE_; k++) {
+    for (int j = 0; j < _SHORT_CLAUSE_SIZE_; j++)
+      short_lits[k][j].clear(true);
+    short_ids[k].clear(true);
+  }
+  long_ids.clear(true);
+  formula = NULL;
+  n_indexed = 0;
+  max_var = -1;
+}
+
+void SoftKernel::update(MaxSATFormula *maxsat_formula) {
+  if (formula != maxsat_formula) {
+    clear();
+    formula = maxsat_formula;
+  }
+
+  for (int i = n_indexed; i < formula->nSoft(); i++) {
+    ClauseView clause = formula->getSoftClause(i).clause;
+    int size = clause.size();
+    for (int j = 0; j < size; j++)
+      if (var(clause[j]) > max_var)
+        max_var = var(clause[j]);
+    if (size == 0 || size > _SHORT_CLAUSE_SIZE_) {
+      long_ids.push(i);
+      continue;
+    }
+    for (int j = 0; j < size; j++)
+      short_lits[size - 1][j].push(toInt(clause[j]));
+    short_ids[size - 1].push(i);
+  }
+  n_indexed = formula->nSoft();
+}
+
+namespace {
+
+inline uint32_t litBit(const uint32_t *bits, int x) {
+  return (bits[x >> 5] >> (x & 31)) & 1;
+}
+
+// Evaluates clauses [from, to) of a group of clauses with 'size' literals.
+void evaluateScalar(const uint32_t *bits, vec<int> *lits, int size,
+                    const vec<int> &ids, int from, int to, vec<int> &falsified,
+                    vec<int> *nb_true) {
+  for (int i = from; i < to; i++) {
+    uint32_t count = 0;
+    for (int j = 0; j < size; j++)
+      count += litBit(bits, lits[j][i]);
+    if (nb_true != NULL)
+      (*nb_true)[ids[i]] = count;
+    if (count == 0)
+      falsified.push(ids[i]);
+  }
+}
+
+#ifdef _SOFT_KERNEL_AVX2_
+// Evaluates the clauses of a group eight at a time. Returns the number of
+// clauses evaluated; the remaining ones are left to the scalar path.
+__attribute__((target("avx2"))) int
+evaluateAVX2(const uint32_t *bits, vec<int> *lits, int size,
+             const vec<int> &ids, vec<int> &falsified, vec<int> *nb_true) {
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i low = _mm256_set1_epi32(31);
+  const __m256i zero = _mm256_setzero_si256();
+  int n = ids.size() & ~7;
+  uint32_t counts[8];
+
+  for (int i = 0; i < n; i += 8) {
+    __m256i count = zero;
+    for (int j = 0; j < size; j++) {
+      __m256i x = _mm256_loadu_si256((const __m256i *)&lits[j][i]);
+      __m256i w = _mm256_i32gather_epi32((const int *)bits,
+                                         _mm256_srli_epi32(x, 5), 4);
+      w = _mm256_srlv_epi32(w, _mm256_and_si256(x, low));
+      count = _mm256_add_epi32(count, _mm256_and_si256(w, one));
+    }
+
+    if (nb_true != NULL) {
+      _mm256_storeu_si256((__m256i *)counts, count);
+      for (int k = 0; k < 8; k++)
+        (*nb_true)[ids[i + k]] = counts[k];
+    }
+
+    unsigned mask = _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpeq_epi32(count, zero)));
+    while (mask != 0) {
+      falsified.push(ids[i + __builtin_ctz(mask)]);
+      mask &= mask - 1;
+    }
+  }
+  return n;
+}
+#endif
+
+} // namespace
+
+/*_________________________________________________________________________________________________
+  |
+  |  evaluate : (model : const ModelBitset &) (falsified : vec<int> &)
+  |             (nb_true : vec<int> *)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Evaluates all indexed soft clauses against 'model'. Short clauses are
+  |    evaluated in bulk from their literal arrays; each lane gathers the word
+  |    of the bitset holding its literal and extracts the corresponding bit.
+  |
+  |  Pre-conditions:
+  |    * 'model' assigns every variable that occurs in a soft clause.
+  |
+  |________________________________________________________________________________________________@*/
+void SoftKernel::evaluate(const ModelBitset &model, vec<int> &falsified,
+                          vec<int> *nb_true) {
+  assert(formula != NULL && n_indexed == formula->nSoft());
+  assert(max_var < model.nVars());
+  const uint32_t *bits = model.data();
+
+  for (int k = 0; k < _SHORT_CLAUSE_SIZE_; k++) {
+    int from = 0;
+#ifdef _SOFT_KERNEL_AVX2_
+    if (useAVX2())
+      from = evaluateAVX2(bits, short_lits[k], k + 1, short_ids[k], falsified,
+                          nb_true);
+#endif
+    evaluateScalar(bits, short_lits[k], k + 1, short_ids[k], from,
+                   short_ids[k].size(), falsified, nb_true);
+  }
+
+  for (int i = 0; i < long_ids.size(); i++) {
+    ClauseView clause = formula->getSoftClause(long_ids[i]).clause;
+    int count = 0;
+    for (int j = 0; j < clause.size(); j++)
+      count += model.isTrue(clause[j]);
+    if (nb_true != NULL)
+      (*nb_true)[long_ids[i]] = count;
+    if (count == 0)
+      falsified.push(long_ids[i]);
+  }
+}
@@ -0,0 +1,120 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SoftKernel_h
+#define SoftKernel_h
+
+#include "MaxSATFormula.h"
+
+#include <stdint.h>
+
+using NSPACE::vec;
+using NSPACE::Lit;
+using NSPACE::lbool;
+
+namespace openwbo {
+
+/*! Model packed as a bitset over literals.
+ *
+ * Bit 'toInt(l)' is set if and only if the literal 'l' is satisfied by the
+ * model. Unassigned variables have both literals unset. */
+class ModelBitset {
+
+public:
+  ModelBitset() : n_vars(0) {}
+
+  // Packs 'model' into the bitset.
+  void load(const vec<lbool> &model);
+
+  bool isTrue(Lit l) const {
+    int x = toInt(l);
+    assert(var(l) < n_vars);
+    return (words[x >> 5] >> (x & 31)) & 1;
+  }
+
+  int nVars() const { return n_vars; }
+  const uint32_t *data() const {
+    return words.size() == 0 ? NULL : &words[0];
+  }
+
+protected:
+  int n_vars;
+  vec<uint32_t> words;
+};
+
+/*! Bulk evaluation of soft clauses against a packed model.
+ *
+ * Soft clauses with one, two or three literals are stored in structure of
+ * arrays form (the j-th literal of every clause of a given size in its own
+ * array), so that eight clauses can be evaluated at once with AVX2 gathers.
+ * Longer clauses are evaluated one literal at a time. The AVX2 path is
+ * selected at runtime; the scalar path is used when the processor (or the
+ * compiler) does not support it. */
+class SoftKernel {
+
+public:
+  SoftKernel() : formula(NULL), n_indexed(0), max_var(-1) {}
+
+  // Indexes the soft clauses of 'maxsat_formula' that were added since the
+  // last call. A different formula resets the kernel.
+  void update(MaxSATFormula *maxsat_formula);
+
+  // Appends to 'falsified' the soft clauses with no literal satisfied by
+  // 'model', grouped by clause size. If 'nb_true' is not NULL, it receives
+  // the number of satisfied literals of each indexed soft clause.
+  void evaluate(const ModelBitset &model, vec<int> &falsified,
+                vec<int> *nb_true = NULL);
+
+  int nIndexed() { return n_indexed; }
+
+  // Clears all data structures.
+  void clear();
+
+  // True if the AVX2 path is used.
+  static bool useAVX2();
+
+protected:
+  enum { _SHORT_CLAUSE_SIZE_ = 3 };
+
+  MaxSATFormula *formula; // Formula of the indexed soft clauses.
+  int n_indexed;          // Number of indexed soft clauses.
+  int max_var;            // Largest variable in an indexed soft clause.
+
+  // Short clauses: 'short_lits[k-1][j][i]' is 'toInt' of the j-th literal of
+  // the i-th clause of size k, and 'short_ids[k-1][i]' its soft index.
+  vec<int> short_lits[_SHORT_CLAUSE_SIZE_][_SHORT_CLAUSE_SIZE_];
+  vec<int> short_ids[_SHORT_CLAUSE_SIZE_];
+
+  // Remaining clauses (empty or longer than '_SHORT_CLAUSE_SIZE_').
+  vec<int> long_ids;
+};
+
+} // namespace openwbo
+
+#endif
@@ -0,0 +1,138 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "SolverSession.h"
+#include "Encoder.h"
+
+using NSPACE::lit_Undef;
+using namespace openwbo;
+
+void SolverSession::start(SATBackend *S) {
+  close();
+  solver = S;
+}
+
+void SolverSession::close() {
+  if (solver != NULL)
+    delete solver;
+  solver = NULL;
+  n_hard = 0;
+  n_card = 0;
+  n_pb = 0;
+  n_loaded_soft = 0;
+  soft_relax.clear();
+  soft_assump.clear();
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  loadHard : (formula : MaxSATFormula *)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Adds to the solver the part of the hard formula that it does not have
+  |    yet. Cardinality and PB constraints are only added by the first call;
+  |    the algorithms do not add them during the search.
+  |
+  |  Post-conditions:
+  |    * The solver and 'formula' have the same number of variables.
+  |
+  |________________________________________________________________________________________________@*/
+void SolverSession::loadHard(MaxSATFormula *formula) {
+  assert(solver != NULL);
+
+  while (solver->nVars() < formula->nVars())
+    solver->newVar();
+
+  vec<Lit> clause;
+  for (; n_hard < formula->nHard(); n_hard++) {
+    formula->getHardClause(n_hard).clause.copyTo(clause);
+    solver->addClause(clause);
+  }
+
+  for (; n_pb < formula->nPB(); n_pb++) {
+    Encoder enc(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_, _AMO_LADDER_,
+                _PB_GTE_);
+    PB *pb = formula->getPBConstraint(n_pb);
+
+    // Make sure the PB is on the form <=
+    if (!pb->_sign)
+      pb->changeSign();
+
+    enc.encodePB(solver, pb->_lits, pb->_coeffs, pb->_rhs);
+  }
+
+  for (; n_card < formula->nCard(); n_card++) {
+    Encoder enc(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_, _AMO_LADDER_,
+                _PB_GTE_);
+    Card *card = formula->getCardinalityConstraint(n_card);
+
+    if (card->_rhs == 1)
+      enc.encodeAMO(solver, card->_lits);
+    else
+      enc.encodeCardinality(solver, card->_lits, card->_rhs);
+  }
+
+  // Auxiliary variables of the encodings must not be reused by the formula.
+  formula->newVar(solver->nVars());
+}
+
+void SolverSession::loadSoft(MaxSATFormula *formula, int i, bool assumption) {
+  assert(solver != NULL);
+  assert(!isLoaded(i));
+
+  while (solver->nVars() < formula->nVars())
+    solver->newVar();
+
+  if (soft_relax.size() <= i) {
+    soft_relax.growTo(i + 1, -1);
+    soft_assump.growTo(i + 1, lit_Undef);
+  }
+  if (soft_relax[i] < 0)
+    n_loaded_soft++;
+
+  Soft soft = formula->getSoftClause(i);
+  vec<Lit> clause;
+  soft.clause.copyTo(clause);
+  for (int j = 0; j < soft.relaxation_vars.size(); j++)
+    clause.push(soft.relaxation_vars[j]);
+  if (assumption)
+    clause.push(soft.assumption_var);
+  solver->addClause(clause);
+
+  soft_relax[i] = soft.relaxation_vars.size();
+  soft_assump[i] = assumption ? soft.assumption_var : lit_Undef;
+}
+
+void SolverSession::retireSoft(int i) {
+  assert(isLoaded(i) && soft_assump[i] != lit_Undef);
+  solver->addClause(soft_assump[i]);
+  soft_relax[i] = -1;
+  n_loaded_soft--;
+}
@@ -0,0 +1,105 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SolverSession_h
+#define SolverSession_h
+
+#include "MaxSATFormula.h"
+#include "SATBackend.h"
+
+using NSPACE::vec;
+using NSPACE::Lit;
+
+namespace openwbo {
+
+/*! A SAT solver kept alive across the phases of a MaxSAT algorithm.
+ *
+ * The session remembers which part of the working formula is already loaded
+ * in the solver, so that each phase only adds what changed since the last
+ * one: new variables, hard clauses and soft clauses. Learnt clauses, variable
+ * activities and phases are kept.
+ *
+ * A soft clause is loaded as (C v R v a), where R are its relaxation
+ * variables and 'a' its assumption variable, and is enabled by assuming ~a.
+ * When new relaxation variables are added to a soft clause, the loaded
+ * version is retired by asserting 'a' and the clause is loaded again with a
+ * fresh assumption variable. */
+class SolverSession {
+
+public:
+  SolverSession()
+      : solver(NULL), n_hard(0), n_card(0), n_pb(0), n_loaded_soft(0) {}
+  ~SolverSession() { close(); }
+
+  // Starts a session on 'S'. The session takes ownership of the solver.
+  void start(SATBackend *S);
+  // Deletes the solver and forgets the loaded formula.
+  void close();
+
+  bool isActive() { return solver != NULL; }
+  SATBackend *getSolver() { return solver; }
+
+  // Creates the missing variables and loads the hard clauses, cardinality
+  // and PB constraints added to 'formula' since the last call. Variables
+  // created by the encodings are also reserved in 'formula'.
+  void loadHard(MaxSATFormula *formula);
+
+  // Loads soft clause 'i'. If 'assumption' is false the clause is loaded
+  // without its assumption variable and cannot be retired.
+  void loadSoft(MaxSATFormula *formula, int i, bool assumption = true);
+
+  // Permanently disables the loaded version of soft clause 'i'.
+  void retireSoft(int i);
+
+  bool isLoaded(int i) { return i < soft_relax.size() && soft_relax[i] >= 0; }
+
+  // True if soft clause 'i' is loaded with fewer relaxation variables than
+  // it currently has.
+  bool isOutdated(MaxSATFormula *formula, int i) {
+    return isLoaded(i) &&
+           soft_relax[i] < formula->getSoftClause(i).relaxation_vars.size();
+  }
+
+  int nLoadedSoft() { return n_loaded_soft; }
+
+protected:
+  SATBackend *solver;
+  int n_hard; // Hard clauses already loaded.
+  int n_card; // Cardinality constraints already loaded.
+  int n_pb;   // PB constraints already loaded.
+
+  int n_loaded_soft;       // Soft clauses currently loaded.
+  vec<int> soft_relax;     // Relaxation variables of the loaded version of
+                           // each soft clause (-1 if not loaded).
+  vec<Lit> soft_assump;    // Assumption literal of the loaded version.
+};
+
+} // namespace openwbo
+
+#endif
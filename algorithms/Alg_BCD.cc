@@ -0,0 +1,521 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "Alg_BCD.h"
+
+#include <set>
+
+using namespace openwbo;
+
+/*_________________________________________________________________________________________________
+  |
+  |  BCD_search : [void] ->  [StatusCode]
+  |
+  |  Description:
+  |
+  |    Core-guided binary search over disjoint cores. Each core keeps a lower
+  |    bound and the cost of the core in the last model, and each SAT call
+  |    assumes with a totalizer that the cost of every core is at most the
+  |    middle of its bounds. A model lowers the upper bound of every core,
+  |    while a core either raises the lower bound of the only core it
+  |    involves or merges the cores and the soft clauses it involves into a
+  |    new core. The search stops when the sum of the lower bounds of the
+  |    cores reaches the cost of the best model.
+  |
+  |    The cost of a core is the sum of the weights of its falsified soft
+  |    clauses, which is bounded with a GTE encoding if the formula is
+  |    weighted. Weighted soft clauses are also stratified: only those with a
+  |    weight of at least the current level are assumed, and the next level
+  |    is considered once the bounds of every core meet.
+  |
+  |  For further details see:
+  |    * Federico Heras, António Morgado, Joao Marques-Silva: Core-Guided
+  |      Binary Search Algorithms for Maximum Satisfiability. AAAI 2011
+  |
+  |  Post-conditions:
+  |    * 'ubCost' is updated.
+  |    * 'lbCost' is updated.
+  |    * 'nbSatisfiable' is updated.
+  |    * 'nbCores' is updated.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode BCD::BCD_search() {
+
+  lbool res = l_True;
+  initRelaxation();
+  solver = rebuildSolver();
+  vec<Lit> assumptions;
+
+  softCore.growTo(maxsat_formula->nSoft(), -1);
+  unsatSoft.growTo(maxsat_formula->nSoft(), true);
+  weightLevels(levels);
+  level = 0;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    coreMapping[getAssumptionLit(i)] = i;
+
+  for (;;) {
+
+    setAssumptions(assumptions);
+    res = searchSATSolver(solver, assumptions);
+
+    if (res == l_True) {
+      nbSatisfiable++;
+      uint64_t newCost = computeCostModel(solver->model());
+      if (model.size() == 0 || newCost < ubCost) {
+        saveModel(solver->model());
+        if (maxsat_formula->getFormat() == _FORMAT_PB_) {
+          // optimization problem
+          if (maxsat_formula->getObjFunction() != NULL) {
+            printBound(newCost + off_set);
+          }
+        } else
+          printBound(newCost + off_set);
+        ubCost = newCost;
+      }
+
+      updateUpperBounds(solver->model());
+
+      if (lbCost >= ubCost) {
+        if (maxsat_formula->getFormat() == _FORMAT_PB_ &&
+            maxsat_formula->getObjFunction() == NULL) {
+          printAnswer(_SATISFIABLE_);
+          return _SATISFIABLE_;
+        }
+        printAnswer(_OPTIMUM_);
+        return _OPTIMUM_;
+      }
+
+      // The bounds of every core meet, so this level cannot improve.
+      bool converged = true;
+      for (int c = 0; c < coreLits.size(); c++)
+        if (coreLits[c].size() > 0 && coreLB[c] < coreUB[c])
+          converged = false;
+      if (converged) {
+        assert(level < levels.size() - 1);
+        level++;
+        if (verbosity > 0)
+          printf("c Weight level : %-12" PRIu64 "\n", levels[level]);
+      }
+    }
+
+    if (res == l_False) {
+      nbCores++;
+      core_minimizer.reduce(solver);
+      sumSizeCores += solver->conflict().size();
+
+      // The hard clauses are unsatisfiable.
+      if (solver->conflict().size() == 0) {
+        printAnswer(_UNSATISFIABLE_);
+        return _UNSATISFIABLE_;
+      }
+
+      relaxCore(solver->conflict());
+      if (verbosity > 0)
+        printf("c LB : %-12" PRIu64 "\n", lbCost);
+
+      if (nbSatisfiable > 0 && lbCost >= ubCost) {
+        if (verbosity > 0)
+          printf("c LB = UB\n");
+        printAnswer(_OPTIMUM_);
+        return _OPTIMUM_;
+      }
+    }
+  }
+  return _ERROR_;
+}
+
+StatusCode BCD::search() {
+  printConfiguration();
+  return BCD_search();
+}
+
+/************************************************************************************************
+ //
+ // Rebuild MaxSAT solver
+ //
+ ************************************************************************************************/
+
+/*_________________________________________________________________________________________________
+  |
+  |  rebuildSolver : [void]  ->  [SATBackend *]
+  |
+  |  Description:
+  |
+  |    Rebuilds a SAT solver with the current MaxSAT formula.
+  |
+  |________________________________________________________________________________________________@*/
+SATBackend *BCD::rebuildSolver() {
+
+  SATBackend *S = newSATSolver();
+
+  reserveSATVariables(S, maxsat_formula->nVars());
+
+  for (int i = 0; i < maxsat_formula->nVars(); i++)
+    newSATVariable(S);
+
+  addHardClauses(S);
+
+  vec<Lit> clause;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    clause.clear();
+    Soft s = getSoftClause(i);
+    s.clause.copyTo(clause);
+    for (int j = 0; j < s.relaxation_vars.size(); j++)
+      clause.push(s.relaxation_vars[j]);
+
+    S->addClause(clause);
+  }
+
+  for (int i = 0; i < maxsat_formula->nPB(); i++) {
+    Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
+                               _AMO_LADDER_, _PB_GTE_);
+
+    // Make sure the PB is on the form <=
+    if (!maxsat_formula->getPBConstraint(i)->_sign)
+      maxsat_formula->getPBConstraint(i)->changeSign();
+
+    enc->encodePB(S, maxsat_formula->getPBConstraint(i)->_lits,
+                  maxsat_formula->getPBConstraint(i)->_coeffs,
+                  maxsat_formula->getPBConstraint(i)->_rhs);
+
+    delete enc;
+  }
+
+  for (int i = 0; i < maxsat_formula->nCard(); i++) {
+    Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
+                               _AMO_LADDER_, _PB_GTE_);
+
+    if (maxsat_formula->getCardinalityConstraint(i)->_rhs == 1) {
+      enc->encodeAMO(S, maxsat_formula->getCardinalityConstraint(i)->_lits);
+    } else {
+      enc->encodeCardinality(S,
+                             maxsat_formula->getCardinalityConstraint(i)->_lits,
+                             maxsat_formula->getCardinalityConstraint(i)->_rhs);
+    }
+
+    delete enc;
+  }
+
+  return S;
+}
+
+/************************************************************************************************
+ //
+ // Utils for core management
+ //
+ ************************************************************************************************/
+
+/*_________________________________________________________________________________________________
+  |
+  |  setAssumptions : (assumps : vec<Lit>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Assumes that the soft clauses outside the cores with a weight of at
+  |    least the current level are satisfied, and that the cost of each core
+  |    is at most the middle of its bounds.
+  |
+  |  Post-conditions:
+  |    * 'coreMid' holds the bound assumed for each core.
+  |    * 'boundMapping' maps the assumed outputs to their cores.
+  |
+  |________________________________________________________________________________________________@*/
+void BCD::setAssumptions(vec<Lit> &assumps) {
+  assumps.clear();
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    if (softCore[i] == -1 &&
+        maxsat_formula->getSoftClause(i).weight >= levels[level])
+      assumps.push(~getAssumptionLit(i));
+
+  for (int c = 0; c < coreLits.size(); c++) {
+    if (coreLits[c].size() == 0)
+      continue;
+
+    uint64_t mid = coreLB[c] + (coreUB[c] - coreLB[c]) / 2;
+    coreMid[c] = mid;
+    if (mid >= coreWeight[c])
+      continue;
+
+    if (mid == 0) {
+      for (int j = 0; j < coreLits[c].size(); j++)
+        assumps.push(~coreLits[c][j]);
+      continue;
+    }
+
+    Lit out = boundLit(c, mid);
+    boundMapping[out] = c;
+    assumps.push(~out);
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  boundLit : (c : int) (mid : uint64_t)  ->  [Lit]
+  |
+  |  Description:
+  |
+  |    Returns an output of the encoding of core 'c' that is true if the
+  |    cost of the core is larger than 'mid'. The totalizer of an unweighted
+  |    core is built the first time a bound is needed and extended when the
+  |    bound grows beyond the encoded outputs. The GTE of a weighted core
+  |    encodes the costs up to its upper bound, which never increases.
+  |
+  |________________________________________________________________________________________________@*/
+Lit BCD::boundLit(int c, uint64_t mid) {
+  if (maxsat_formula->getProblemType() == _WEIGHTED_) {
+    if (coreEncoder[c] == NULL) {
+      vec<uint64_t> coeffs;
+      for (int j = 0; j < coreLits[c].size(); j++)
+        coeffs.push(
+            maxsat_formula->getSoftClause(coreMapping[coreLits[c][j]]).weight);
+      coreEncoder[c] = new Encoder(_INCREMENTAL_NONE_, _CARD_TOTALIZER_,
+                                   _AMO_LADDER_, _PB_GTE_);
+      coreEncoder[c]->encodePBOutputs(solver, coreLits[c], coeffs, coreUB[c]);
+      coreEncoded[c] = coreUB[c];
+    }
+
+    assert(mid <= coreEncoded[c]);
+    Lit out = coreEncoder[c]->pbOutputAbove(mid);
+    assert(out != lit_Undef);
+    return out;
+  }
+
+  if (coreEncoder[c] == NULL) {
+    coreEncoder[c] = new Encoder();
+    coreEncoder[c]->setIncremental(_INCREMENTAL_ITERATIVE_);
+    coreEncoder[c]->buildCardinality(solver, coreLits[c], mid);
+    coreEncoded[c] = mid;
+  } else if (mid > coreEncoded[c]) {
+    vec<Lit> encodingAssumptions;
+    coreEncoder[c]->incUpdateCardinality(solver, coreLits[c], mid,
+                                         encodingAssumptions);
+    coreEncoded[c] = mid;
+  }
+
+  // The output 'mid' is true if more than 'mid' literals are true.
+  assert((uint64_t)coreEncoder[c]->outputs().size() > mid);
+  Lit out = coreEncoder[c]->outputs()[mid];
+  assert(out != lit_Undef);
+  return out;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  relaxCore : (conflict : const vec<Lit>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Updates the cores with an unsatisfiable subset of the assumptions.
+  |    If it only involves the bound of one core, the cost of that core is
+  |    larger than the bound. Otherwise, the cores and the soft clauses that
+  |    it involves are merged into a new core. At least one of them costs
+  |    more than its assumed bound (0 for the soft clauses), so the lower
+  |    bound of the new core is the sum of their lower bounds plus the
+  |    smallest increase.
+  |
+  |  Post-conditions:
+  |    * 'coreLB', 'coreUB' and 'lbCost' are updated.
+  |    * The merged cores have no literals and no encoder.
+  |
+  |________________________________________________________________________________________________@*/
+void BCD::relaxCore(const vec<Lit> &conflict) {
+  std::set<int> cores;
+  vec<int> softs;
+
+  for (int i = 0; i < conflict.size(); i++) {
+    if (coreMapping.find(conflict[i]) != coreMapping.end()) {
+      int soft = coreMapping[conflict[i]];
+      if (softCore[soft] == -1)
+        softs.push(soft);
+      else
+        cores.insert(softCore[soft]);
+    } else if (boundMapping.find(conflict[i]) != boundMapping.end())
+      cores.insert(boundMapping[conflict[i]]);
+  }
+  assert(softs.size() + cores.size() > 0);
+
+  if (softs.size() == 0 && cores.size() == 1) {
+    int c = *cores.begin();
+    coreLB[c] = coreMid[c] + 1;
+  } else {
+    int id = coreLits.size();
+    coreLits.push();
+    coreWeight.push(0);
+    coreLB.push(0);
+    coreUB.push(0);
+    coreMid.push(0);
+    coreEncoder.push(NULL);
+    coreEncoded.push(0);
+
+    uint64_t increase = UINT64_MAX;
+    for (int i = 0; i < softs.size(); i++) {
+      uint64_t weight = maxsat_formula->getSoftClause(softs[i]).weight;
+      coreLits[id].push(getRelaxationLit(softs[i]));
+      coreWeight[id] += weight;
+      softCore[softs[i]] = id;
+      if (unsatSoft[softs[i]])
+        coreUB[id] += weight;
+      if (weight < increase)
+        increase = weight;
+    }
+
+    for (std::set<int>::iterator it = cores.begin(); it != cores.end(); ++it) {
+      int c = *it;
+      for (int j = 0; j < coreLits[c].size(); j++) {
+        coreLits[id].push(coreLits[c][j]);
+        softCore[coreMapping[coreLits[c][j]]] = id;
+      }
+      coreWeight[id] += coreWeight[c];
+      coreLB[id] += coreLB[c];
+      coreUB[id] += coreUB[c];
+      if (coreMid[c] - coreLB[c] + 1 < increase)
+        increase = coreMid[c] - coreLB[c] + 1;
+
+      coreLits[c].clear(true);
+      if (coreEncoder[c] != NULL) {
+        delete coreEncoder[c];
+        coreEncoder[c] = NULL;
+      }
+    }
+    coreLB[id] += increase;
+
+    if (verbosity > 0)
+      printf("c Core %d : %d soft clauses (%d cores merged)\n", id,
+             coreLits[id].size(), (int)cores.size());
+  }
+
+  lbCost = 0;
+  for (int c = 0; c < coreLits.size(); c++) {
+    if (coreLits[c].size() == 0)
+      continue;
+    assert(coreLB[c] <= coreUB[c]);
+    lbCost += coreLB[c];
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  updateUpperBounds : (currentModel : vec<lbool>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Sets the upper bound of each core to the sum of the weights of its
+  |    soft clauses that are unsatisfied by 'currentModel'.
+  |
+  |  Pre-conditions:
+  |    * 'currentModel' satisfies the assumptions of the last SAT call.
+  |
+  |  Post-conditions:
+  |    * 'unsatSoft' holds the soft clauses unsatisfied by 'currentModel'.
+  |
+  |________________________________________________________________________________________________@*/
+void BCD::updateUpperBounds(vec<lbool> &currentModel) {
+  vec<int> falsified;
+  cost_evaluator.falsified(maxsat_formula, currentModel, falsified);
+
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    unsatSoft[i] = false;
+  for (int c = 0; c < coreUB.size(); c++)
+    coreUB[c] = 0;
+  for (int i = 0; i < falsified.size(); i++) {
+    unsatSoft[falsified[i]] = true;
+    // Soft clauses below the current level are not assumed.
+    if (softCore[falsified[i]] != -1)
+      coreUB[softCore[falsified[i]]] +=
+          maxsat_formula->getSoftClause(falsified[i]).weight;
+  }
+
+  for (int c = 0; c < coreLits.size(); c++)
+    assert(coreLits[c].size() == 0 || coreUB[c] <= coreMid[c] ||
+           coreMid[c] >= coreWeight[c]);
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  weightLevels : (levels : vec<uint64_t>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Computes the decreasing weight levels used to stratify the soft
+  |    clauses, with the diversity heuristic of PartMSU3. The last level is
+  |    always 1.
+  |
+  |________________________________________________________________________________________________@*/
+void BCD::weightLevels(vec<uint64_t> &levels) {
+  std::map<uint64_t, int> nbWeights;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    nbWeights[maxsat_formula->getSoftClause(i).weight]++;
+
+  float alpha = 1.25;
+  int nbClauses = 0;
+  int nbDistinct = 0;
+  for (std::map<uint64_t, int>::reverse_iterator it = nbWeights.rbegin();
+       it != nbWeights.rend(); ++it) {
+    nbClauses += it->second;
+    nbDistinct++;
+    if ((float)nbClauses / nbDistinct > alpha)
+      levels.push(it->first);
+  }
+
+  if (levels.size() == 0 || levels.last() > 1)
+    levels.push(1);
+}
+
+/************************************************************************************************
+ //
+ // Other protected methods
+ //
+ ************************************************************************************************/
+
+/*_________________________________________________________________________________________________
+  |
+  |  initRelaxation : [void] ->  [void]
+  |
+  |  Description:
+  |
+  |    Initializes the relaxation variables by adding a fresh variable to the
+  |    'relaxationVars' of each soft clause. The same variable is used as the
+  |    assumption of the soft clause.
+  |
+  |________________________________________________________________________________________________@*/
+void BCD::initRelaxation() {
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    Lit l = maxsat_formula->newLiteral();
+    Soft s = getSoftClause(i);
+    s.relaxation_vars.push(l);
+    s.assumption_var = l;
+  }
+}
+
+// Print BCD configuration.
+void BCD::print_BCD_configuration() {
+  printf("c |  Algorithm: %23s                                             "
+         "                      |\n",
+         "BCD");
+}
@@ -0,0 +1,128 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef Alg_BCD_h
+#define Alg_BCD_h
+
+#ifdef SIMP
+#include "simp/SimpSolver.h"
+#else
+#include "core/Solver.h"
+#endif
+
+#include "../Encoder.h"
+#include "../MaxSAT.h"
+#include <map>
+
+namespace openwbo {
+
+//=================================================================================================
+class BCD : public MaxSAT {
+
+public:
+  BCD(int verb = _VERBOSITY_MINIMAL_) {
+    solver = NULL;
+    verbosity = verb;
+  }
+  ~BCD() {
+    for (int i = 0; i < coreEncoder.size(); i++)
+      if (coreEncoder[i] != NULL)
+        delete coreEncoder[i];
+    if (solver != NULL)
+      delete solver;
+  }
+
+  StatusCode search(); // BCD search.
+
+  // Print solver configuration.
+  void printConfiguration() {
+
+    if(!print) return;
+
+    printf("c ==========================================[ Solver Settings "
+           "]============================================\n");
+    printf("c |                                                                "
+           "                                       |\n");
+
+    print_BCD_configuration();
+    if (maxsat_formula->getProblemType() == _WEIGHTED_)
+      print_PB_configuration(_PB_GTE_);
+    else
+      print_Card_configuration(_CARD_TOTALIZER_);
+  }
+
+protected:
+  // Print BCD configuration.
+  void print_BCD_configuration();
+
+  // Rebuild MaxSAT solver
+  //
+  SATBackend *rebuildSolver(); // Rebuild MaxSAT solver.
+
+  StatusCode BCD_search(); // Core-guided binary search.
+
+  // Utils for core management
+  //
+  void initRelaxation(); // Relaxes soft clauses.
+  // Assumes the middle of the bounds of each core.
+  void setAssumptions(vec<Lit> &assumps);
+  void relaxCore(const vec<Lit> &conflict); // Merges the cores of a conflict.
+  void updateUpperBounds(vec<lbool> &currentModel); // Costs of the cores.
+  Lit boundLit(int c, uint64_t mid); // Output that bounds the cost of a core.
+  void weightLevels(vec<uint64_t> &levels); // Weights of the strata.
+
+  SATBackend *solver;  // SAT Solver used as a black box.
+
+  std::map<Lit, int> coreMapping; // Mapping between the assumption literal and
+                                  // the respective soft clause.
+  vec<int> softCore;              // Core of each soft clause (-1 if none).
+  vec<bool> unsatSoft; // True if the soft clause is unsatisfied by the last
+                       // model (or if there is no model).
+
+  // Weighted soft clauses are stratified.
+  vec<uint64_t> levels; // Decreasing weights of the strata.
+  int level;            // Current stratum.
+
+  // Disjoint cores. A core whose soft clauses were merged into another core
+  // has no literals.
+  //
+  vec<vec<Lit>> coreLits;     // Relaxation literals of the soft clauses.
+  vec<uint64_t> coreWeight;   // Sum of the weights of the soft clauses.
+  vec<uint64_t> coreLB;       // Lower bound on the cost of the core.
+  vec<uint64_t> coreUB;       // Cost of the core in the last model.
+  vec<uint64_t> coreMid;      // Bound assumed in the last SAT call.
+  vec<Encoder *> coreEncoder; // Totalizer over 'coreLits' (GTE if weighted,
+                              // NULL if none).
+  vec<uint64_t> coreEncoded;  // Largest bound encoded by 'coreEncoder'.
+  std::map<Lit, int> boundMapping; // Mapping between the output of a
+                                   // totalizer and the respective core.
+};
+} // namespace openwbo
+
+#endif
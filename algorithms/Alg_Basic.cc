@@ -25,7 +25,7 @@ StatusCode Basic::linearsu(){
 
   /* TODO: initialize the SAT solver with the hard and soft clauses. Note you can 
            use/change the buildSATsolver method */
-  Solver* sat_solver = NULL; // replace NULL with the properly initialization
+  SATBackend *sat_solver = NULL; // replace NULL with the properly initialization
 
   uint64_t cost = 0; // this will store the current bound we are exploring
 
@@ -63,9 +63,9 @@ StatusCode Basic::linearsu(){
 
       /* How to extract a core from the SAT solver?
        * This is only useful for the MSU3 algorithm */
-      for (int i = 0; i < sat_solver->conflict.size(); i++) {
-        if (core_mapping.find(sat_solver->conflict[i]) != core_mapping.end()) {
-          /* coreMapping[solver->conflict[i]]: 
+      for (int i = 0; i < sat_solver->conflict().size(); i++) {
+        if (core_mapping.find(sat_solver->conflict()[i]) != core_mapping.end()) {
+          /* coreMapping[solver->conflict()[i]]: 
            * - will contain the index of the soft clause that appears in the core
            * Use this information if you want to explore the unsat core!*/
         }
@@ -99,10 +99,10 @@ StatusCode Basic::linearsu(){
    
 }
 
-Solver* Basic::buildSATSolver() {
+SATBackend *Basic::buildSATSolver() {
 
   // SAT solver is created with no variables or clauses
-  Solver *S = newSATSolver();
+  SATBackend *S = newSATSolver();
 
   /* The maxsat_formula contains all the information about the MaxSAT formula:
    * - hard clauses
@@ -114,8 +114,7 @@ Solver* Basic::buildSATSolver() {
     newSATVariable(S);
 
   // We then traverse the maxsat_formula and add all hard clauses to the SAT solver
-  for (int i = 0; i < maxsat_formula->nHard(); i++)
-    S->addClause(getHardClause(i).clause);
+  addHardClauses(S);
 
   /* Next, we need to traverse the maxsat_formula and add all soft clauses to 
    * the SAT solver (we must also include the relaxation variables)
@@ -123,7 +122,7 @@ Solver* Basic::buildSATSolver() {
   vec<Lit> clause;
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
     clause.clear();
-    Soft &s = getSoftClause(i);
+    Soft s = getSoftClause(i);
     s.clause.copyTo(clause);
     for (int j = 0; j < s.relaxation_vars.size(); j++)
       clause.push(s.relaxation_vars[j]);
@@ -142,7 +141,7 @@ void Basic::relaxFormula() {
    */
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
     Lit l = maxsat_formula->newLiteral();
-    Soft &s = getSoftClause(i);
+    Soft s = getSoftClause(i);
     s.relaxation_vars.push(l);
     s.assumption_var = ~l;
   }
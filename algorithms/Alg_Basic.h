@@ -30,7 +30,7 @@ protected:
 
   StatusCode linearsu();
 
-  Solver *buildSATSolver(); // Rebuild MaxSAT solver.
+  SATBackend *buildSATSolver(); // Rebuild MaxSAT solver.
   void relaxFormula(); // Relaxes soft clauses.
 
 };
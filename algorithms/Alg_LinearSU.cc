@@ -68,27 +68,29 @@ StatusCode LinearSU::bmoSearch() {
   vec<vec<Lit>> functions;
   vec<int> weights;
 
-  solver = rebuildBMO(functions, weights, currentWeight);
+  solver = updateBMO(functions, weights, currentWeight);
 
   uint64_t localCost = 0;
   ubCost = 0;
 
   for (;;) {
 
-    vec<Lit> dummy;
+    // The bound on the current function only holds under '~levelGate'.
+    vec<Lit> assumptions;
+    assumptions.push(~levelGate);
     // Do not use preprocessing for linear search algorithm.
     // NOTE: When preprocessing is enabled the SAT solver simplifies the
     // relaxation variables which leads to incorrect results.
-    res = searchSATSolver(solver, dummy);
+    res = searchSATSolver(solver, assumptions);
 
     if (res == l_True) {
       nbSatisfiable++;
 
-      uint64_t newCost = computeCostModel(solver->model, currentWeight);
+      uint64_t newCost = computeCostModel(solver->model(), currentWeight);
       if (currentWeight == minWeight) {
         // If current weight is the same as the minimum weight, then we are in
         // the last lexicographical function.
-        saveModel(solver->model);
+        saveModel(solver->model());
         savePhase(solver);
         printBound(newCost + lbCost + off_set);
         ubCost = newCost + lbCost;
@@ -117,8 +119,7 @@ StatusCode LinearSU::bmoSearch() {
           currentWeight = orderWeights[posWeight];
           localCost = 0;
 
-          delete solver;
-          solver = rebuildBMO(functions, weights, currentWeight);
+          solver = updateBMO(functions, weights, currentWeight);
 
           if (verbosity > 0)
             printf("c LB : %-12" PRIu64 "\n", lbCost);
@@ -126,7 +127,7 @@ StatusCode LinearSU::bmoSearch() {
 
           // Optimization of the current lexicographical function.
           if (localCost == 0)
-            encoder.encodeCardinality(solver, objFunction,
+            encoder.encodeCardinality(solver, levelFunction,
                                       newCost / currentWeight - 1);
           else
             encoder.updateCardinality(solver, newCost / currentWeight - 1);
@@ -164,8 +165,7 @@ StatusCode LinearSU::bmoSearch() {
         currentWeight = orderWeights[posWeight];
         localCost = 0;
 
-        delete solver;
-        solver = rebuildBMO(functions, weights, currentWeight);
+        solver = updateBMO(functions, weights, currentWeight);
 
         if (verbosity > 0)
           printf("c LB : %-12" PRIu64 "\n", lbCost);
@@ -199,7 +199,7 @@ StatusCode LinearSU::normalSearch() {
   lbool res = l_True;
 
   initRelaxation();
-  solver = rebuildSolver();
+  solver = updateSolver();
 
   while (res == l_True) {
 
@@ -211,16 +211,22 @@ StatusCode LinearSU::normalSearch() {
 
     if (res == l_True) {
       nbSatisfiable++;
-      uint64_t newCost = computeCostModel(solver->model);
-      saveModel(solver->model);
-      savePhase(solver);
-      if (maxsat_formula->getFormat() == _FORMAT_PB_) {
-        // optimization problem
-        if (maxsat_formula->getObjFunction() != NULL) {
+      uint64_t newCost = computeCostModel(solver->model());
+      if (model.size() != 0 && ubCost <= newCost) {
+        // A better model was imported from the local search. The search
+        // continues below its cost.
+        newCost = ubCost;
+      } else {
+        saveModel(solver->model());
+        savePhase(solver);
+        if (maxsat_formula->getFormat() == _FORMAT_PB_) {
+          // optimization problem
+          if (maxsat_formula->getObjFunction() != NULL) {
+            printBound(newCost + off_set);
+          }
+        } else
           printBound(newCost + off_set);
-        }
-      } else
-        printBound(newCost + off_set);
+      }
 
       if (newCost == 0) {
         // If there is a model with value 0 then it is an optimal model
@@ -297,107 +303,79 @@ StatusCode LinearSU::search() {
 
 /************************************************************************************************
  //
- // Rebuild MaxSAT solver
+ // Update MaxSAT solver
  //
  ************************************************************************************************/
 
 /*_________________________________________________________________________________________________
   |
-  |  rebuildSolver : (minWeight : int)  ->  [Solver *]
+  |  updateSolver : (minWeight : int)  ->  [SATBackend *]
   |
   |  Description:
   |
-  |    Rebuilds a SAT solver with the current MaxSAT formula.
+  |    Updates the SAT solver of the session with the current MaxSAT formula.
+  |    The solver is only created by the first call; later calls add the
+  |    clauses that it does not have yet.
   |    If a weight is specified, then it only considers soft clauses with weight
-  |    smaller than the specified weight.
+  |    greater than or equal to the specified weight.
   |    NOTE: a weight is specified in the 'bmo' approach.
   |
   |________________________________________________________________________________________________@*/
-Solver *LinearSU::rebuildSolver(uint64_t min_weight) {
-
-  vec<bool> seen;
-  seen.growTo(maxsat_formula->nVars(), false);
-
-  Solver *S = newSATSolver();
+SATBackend *LinearSU::updateSolver(uint64_t min_weight) {
 
-  reserveSATVariables(S, maxsat_formula->nVars());
-
-  for (int i = 0; i < maxsat_formula->nVars(); i++)
-    newSATVariable(S);
-
-  for (int i = 0; i < maxsat_formula->nHard(); i++)
-    S->addClause(maxsat_formula->getHardClause(i).clause);
-
-  for (int i = 0; i < maxsat_formula->nPB(); i++) {
-    Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
-
-    // Make sure the PB is on the form <=
-    // if (maxsat_formula->getPBConstraint(i)->_sign)
-    //  maxsat_formula->getPBConstraint(i)->changeSign();
-    assert(maxsat_formula->getPBConstraint(i)->_sign);
-
-    enc->encodePB(S, maxsat_formula->getPBConstraint(i)->_lits,
-                  maxsat_formula->getPBConstraint(i)->_coeffs,
-                  maxsat_formula->getPBConstraint(i)->_rhs);
-
-    delete enc;
+  if (!session.isActive()) {
+    session.start(newSATSolver());
+    reserveSATVariables(session.getSolver(), maxsat_formula->nVars());
   }
 
-  for (int i = 0; i < maxsat_formula->nCard(); i++) {
-    Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
+  session.loadHard(maxsat_formula);
 
-    if (maxsat_formula->getCardinalityConstraint(i)->_rhs == 1) {
-      enc->encodeAMO(S, maxsat_formula->getCardinalityConstraint(i)->_lits);
-    } else {
-
-      enc->encodeCardinality(S,
-                             maxsat_formula->getCardinalityConstraint(i)->_lits,
-                             maxsat_formula->getCardinalityConstraint(i)->_rhs);
-    }
-
-    delete enc;
-  }
-
-  vec<Lit> clause;
+  // Soft clauses are never retired by the linear search, hence they are
+  // loaded without assumption variables.
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-    if (maxsat_formula->getSoftClause(i).weight < min_weight)
+    if (maxsat_formula->getSoftClause(i).weight < min_weight ||
+        session.isLoaded(i))
       continue;
 
-    clause.clear();
-    maxsat_formula->getSoftClause(i).clause.copyTo(clause);
-
-    for (int j = 0; j < maxsat_formula->getSoftClause(i).relaxation_vars.size();
-         j++) {
-      clause.push(maxsat_formula->getSoftClause(i).relaxation_vars[j]);
-    }
-
-    S->addClause(clause);
+    session.loadSoft(maxsat_formula, i, false);
   }
 
-  return S;
+  return session.getSolver();
 }
 
 /*_________________________________________________________________________________________________
   |
-  |  rebuildBMO : (functions : int)  ->  [Solver *]
+  |  updateBMO : (functions : int)  ->  [SATBackend *]
   |
   |  Description:
   |
-  |    Rebuilds a SAT solver with the current MaxSAT formula.
-  |    Only considers soft clauses with the weight of the current
-  |    lexicographical optimization weight ('currentWeight')
-  |    For each function already computed in the BMO algorithm it encodes the
-  |    respective cardinality constraint.
+  |    Moves the SAT solver to the lexicographical function of weight
+  |    'currentWeight'. The bound of the function that has just been optimized
+  |    is disabled by asserting 'levelGate' and replaced by the cardinality
+  |    constraint of its optimum value. The soft clauses of the new function
+  |    are then loaded.
+  |
+  |    The bound of the new function is encoded over gated copies of its
+  |    relaxation variables ('levelFunction'), (~r v levelGate v t), and is
+  |    only active when assuming '~levelGate'. This way, an unsatisfiable call
+  |    does not leave the solver unsatisfiable for the next function.
+  |
+  |  Pre-conditions:
+  |    * Only the last function of 'functions' has not been encoded yet.
   |
   |________________________________________________________________________________________________@*/
-Solver *LinearSU::rebuildBMO(vec<vec<Lit>> &functions, vec<int> &rhs,
-                             uint64_t currentWeight) {
+SATBackend *LinearSU::updateBMO(vec<vec<Lit>> &functions, vec<int> &rhs,
+                            uint64_t currentWeight) {
 
   assert(functions.size() == rhs.size());
 
-  Solver *S = rebuildSolver(currentWeight);
+  SATBackend *S = updateSolver(currentWeight);
+
+  if (functions.size() > 0) {
+    assert(levelGate != NSPACE::lit_Undef);
+    S->addClause(levelGate);
+    encoder.encodeCardinality(S, functions.last(), rhs.last());
+  }
 
   objFunction.clear();
   coeffs.clear();
@@ -408,8 +386,16 @@ Solver *LinearSU::rebuildBMO(vec<vec<Lit>> &functions, vec<int> &rhs,
     }
   }
 
-  for (int i = 0; i < functions.size(); i++)
-    encoder.encodeCardinality(S, functions[i], rhs[i]);
+  levelGate = mkLit(S->nVars(), false);
+  newSATVariable(S);
+
+  levelFunction.clear();
+  for (int i = 0; i < objFunction.size(); i++) {
+    Lit t = mkLit(S->nVars(), false);
+    newSATVariable(S);
+    S->addClause(~objFunction[i], levelGate, t);
+    levelFunction.push(t);
+  }
 
   return S;
 }
@@ -474,14 +460,14 @@ void LinearSU::print_LinearSU_configuration() {
 }
 
  // save polarity from last model 
- void LinearSU::savePhase(Solver * solver) {
+ void LinearSU::savePhase(SATBackend * solver) {
   
-  assert (solver->model.size() > 0);
-  assert (solver->model.size() >= maxsat_formula->nInitialVars());
+  assert (solver->model().size() > 0);
+  assert (solver->model().size() >= maxsat_formula->nInitialVars());
 
   // save the polarity of the original variables
   for (int i = 0; i < maxsat_formula->nInitialVars(); i++){
-    solver->setPolarity(i, solver->model[i] == l_False);
+    solver->phase(mkLit(i, solver->model()[i] == l_False));
   }
 
   // save the polarity of the relaxation variables
@@ -489,8 +475,8 @@ void LinearSU::print_LinearSU_configuration() {
     assert (maxsat_formula->getSoftClause(i).relaxation_vars.size() == 1);
     maxsat_formula->getSoftClause(i).relaxation_vars[0];
     int v = var(maxsat_formula->getSoftClause(i).relaxation_vars[0]);
-    assert (v < solver->model.size());
-    solver->setPolarity(v, solver->model[v] == l_False);
+    assert (v < solver->model().size());
+    solver->phase(mkLit(v, solver->model()[v] == l_False));
   }
 
  }
\ No newline at end of file
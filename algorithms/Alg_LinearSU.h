@@ -51,7 +51,7 @@ class LinearSU : public MaxSAT {
 public:
   LinearSU(int verb = _VERBOSITY_MINIMAL_, bool bmo = true,
            int enc = _CARD_MTOTALIZER_, int pb = _PB_SWC_)
-      : solver(NULL), is_bmo(false) {
+      : solver(NULL), levelGate(NSPACE::lit_Undef), is_bmo(false) {
     pb_encoding = pb;
     verbosity = verb;
     bmoMode = bmo;
@@ -61,9 +61,6 @@ public:
   }
 
   ~LinearSU() {
-    if (solver != NULL)
-      delete solver;
-
     objFunction.clear();
     coeffs.clear();
   }
@@ -89,12 +86,12 @@ public:
   }
 
 protected:
-  // Rebuild MaxSAT solver
+  // Update MaxSAT solver
   //
-  // Rebuild MaxSAT solver with BMO algorithm.
-  Solver *rebuildBMO(vec<vec<Lit>> &functions, vec<int> &weights,
-                     uint64_t currentWeight);
-  Solver *rebuildSolver(uint64_t min_weight = 1); // Rebuild MaxSAT solver.
+  // Update MaxSAT solver with BMO algorithm.
+  SATBackend *updateBMO(vec<vec<Lit>> &functions, vec<int> &weights,
+                    uint64_t currentWeight);
+  SATBackend *updateSolver(uint64_t min_weight = 1); // Update MaxSAT solver.
 
   // Linear search algorithms.
   //
@@ -111,9 +108,9 @@ protected:
   void print_LinearSU_configuration();
 
   // savePhase
-  void savePhase(Solver * solver);
+  void savePhase(SATBackend * solver);
 
-  Solver *solver;  // SAT Solver used as a black box.
+  SATBackend *solver;  // SAT Solver used as a black box (owned by 'session').
   Encoder encoder; // Interface for the encoder of constraints to CNF.
   int encoding;    // Encoding for cardinality constraints.
   int pb_encoding;
@@ -126,6 +123,12 @@ protected:
   vec<uint64_t> coeffs; // Coefficients of the literals that are used in the
                         // constraint that excludes models.
 
+  // BMO
+  //
+  Lit levelGate;          // Disables the bound of the current function when
+                          // asserted.
+  vec<Lit> levelFunction; // Gated copies of the literals of 'objFunction'.
+
   bool is_bmo; // Stores if the formula is BMO or not.
 };
 } // namespace openwbo
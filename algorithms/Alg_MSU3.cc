@@ -58,10 +58,10 @@ using namespace openwbo;
   |________________________________________________________________________________________________@*/
 StatusCode MSU3::MSU3_iterative() {
 
-  if (encoding != _CARD_TOTALIZER_) {
+  if (encoding != _CARD_TOTALIZER_ && encoding != _CARD_NATIVE_) {
     if(print) {
       printf("Error: Currently algorithm MSU3 with iterative encoding only "
-             "supports the totalizer encoding.\n");
+             "supports the totalizer and native encodings.\n");
       printf("s UNKNOWN\n");
     }
     throw MaxSATException(__FILE__, __LINE__, "MSU3 only supports totalizer");
@@ -86,8 +86,8 @@ StatusCode MSU3::MSU3_iterative() {
     res = searchSATSolver(solver, assumptions);
     if (res == l_True) {
       nbSatisfiable++;
-      uint64_t newCost = computeCostModel(solver->model);
-      saveModel(solver->model);
+      uint64_t newCost = computeCostModel(solver->model());
+      saveModel(solver->model());
       printBound(newCost);
 
       ubCost = newCost;
@@ -121,20 +121,21 @@ StatusCode MSU3::MSU3_iterative() {
         return _OPTIMUM_;
       }
 
-      sumSizeCores += solver->conflict.size();
+      core_minimizer.reduce(solver);
+      sumSizeCores += solver->conflict().size();
 
-      if (solver->conflict.size() == 0) {
+      if (solver->conflict().size() == 0) {
         printAnswer(_UNSATISFIABLE_);
         return _UNSATISFIABLE_;
       }
 
       joinObjFunction.clear();
-      for (int i = 0; i < solver->conflict.size(); i++) {
-        if (coreMapping.find(solver->conflict[i]) != coreMapping.end()) {
-          assert(!activeSoft[coreMapping[solver->conflict[i]]]);
-          activeSoft[coreMapping[solver->conflict[i]]] = true;
+      for (int i = 0; i < solver->conflict().size(); i++) {
+        if (coreMapping.find(solver->conflict()[i]) != coreMapping.end()) {
+          assert(!activeSoft[coreMapping[solver->conflict()[i]]]);
+          activeSoft[coreMapping[solver->conflict()[i]]] = true;
           joinObjFunction.push(
-              getRelaxationLit(coreMapping[solver->conflict[i]]));
+              getRelaxationLit(coreMapping[solver->conflict()[i]]));
         }
       }
 
@@ -189,7 +190,7 @@ StatusCode MSU3::search() {
   }
 
   if (incremental_strategy == _INCREMENTAL_ITERATIVE_) {
-    if (encoding != _CARD_TOTALIZER_) {
+    if (encoding != _CARD_TOTALIZER_ && encoding != _CARD_NATIVE_) {
       if(print) {
         printf("Error: Currently iterative encoding in PartMSU3 only "
              "supports the Totalizer encoding.\n");
@@ -212,29 +213,28 @@ StatusCode MSU3::search() {
 
 /*_________________________________________________________________________________________________
   |
-  |  rebuildSolver : [void]  ->  [Solver *]
+  |  rebuildSolver : [void]  ->  [SATBackend *]
   |
   |  Description:
   |
   |    Rebuilds a SAT solver with the current MaxSAT formula.
   |
   |________________________________________________________________________________________________@*/
-Solver *MSU3::rebuildSolver() {
+SATBackend *MSU3::rebuildSolver() {
 
-  Solver *S = newSATSolver();
+  SATBackend *S = newSATSolver();
 
   reserveSATVariables(S, maxsat_formula->nVars());
 
   for (int i = 0; i < maxsat_formula->nVars(); i++)
     newSATVariable(S);
 
-  for (int i = 0; i < maxsat_formula->nHard(); i++)
-    S->addClause(getHardClause(i).clause);
+  addHardClauses(S);
 
   vec<Lit> clause;
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
     clause.clear();
-    Soft &s = getSoftClause(i);
+    Soft s = getSoftClause(i);
     s.clause.copyTo(clause);
     for (int j = 0; j < s.relaxation_vars.size(); j++)
       clause.push(s.relaxation_vars[j]);
@@ -302,7 +302,7 @@ Solver *MSU3::rebuildSolver() {
 void MSU3::initRelaxation() {
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
     Lit l = maxsat_formula->newLiteral();
-    Soft &s = getSoftClause(i);
+    Soft s = getSoftClause(i);
     s.relaxation_vars.push(l);
     s.assumption_var = l;
     objFunction.push(l);
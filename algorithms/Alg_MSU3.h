@@ -46,11 +46,11 @@ namespace openwbo {
 class MSU3 : public MaxSAT {
 
 public:
-  MSU3(int verb = _VERBOSITY_MINIMAL_) {
+  MSU3(int verb = _VERBOSITY_MINIMAL_, int enc = _CARD_TOTALIZER_) {
     solver = NULL;
     verbosity = verb;
     incremental_strategy = _INCREMENTAL_ITERATIVE_;
-    encoding = _CARD_TOTALIZER_;
+    encoding = enc;
     encoder.setCardEncoding(encoding);
   }
   ~MSU3() {
@@ -71,7 +71,7 @@ public:
            "                                       |\n");
 
     print_MSU3_configuration();
-    print_Card_configuration(_CARD_TOTALIZER_);
+    print_Card_configuration(encoding);
   }
 
 protected:
@@ -80,7 +80,7 @@ protected:
 
   // Rebuild MaxSAT solver
   //
-  Solver *rebuildSolver(); // Rebuild MaxSAT solver.
+  SATBackend *rebuildSolver(); // Rebuild MaxSAT solver.
 
   StatusCode MSU3_none();      // Non-incremental MSU3.
   StatusCode MSU3_blocking();  // Incremental Blocking MSU3.
@@ -90,7 +90,7 @@ protected:
   // Other
   void initRelaxation(); // Relaxes soft clauses.
 
-  Solver *solver;  // SAT Solver used as a black box.
+  SATBackend *solver;  // SAT Solver used as a black box.
   Encoder encoder; // Interface for the encoder of constraints to CNF.
 
   // Controls the incremental strategy used by MSU3 algorithms.
@@ -123,8 +123,8 @@ StatusCode OLL::unweighted() {
     res = searchSATSolver(solver, assumptions);
     if (res == l_True) {
       nbSatisfiable++;
-      uint64_t newCost = computeCostModel(solver->model);
-      saveModel(solver->model);
+      uint64_t newCost = computeCostModel(solver->model());
+      saveModel(solver->model());
       if (maxsat_formula->getFormat() == _FORMAT_PB_) {
         // optimization problem
         if (maxsat_formula->getObjFunction() != NULL) {
@@ -175,18 +175,19 @@ StatusCode OLL::unweighted() {
         return _OPTIMUM_;
       }
 
-      sumSizeCores += solver->conflict.size();
+      core_minimizer.reduce(solver);
+      sumSizeCores += solver->conflict().size();
 
       vec<Lit> soft_relax;
       vec<Lit> cardinality_relax;
 
-      for (int i = 0; i < solver->conflict.size(); i++) {
-        Lit p = solver->conflict[i];
+      for (int i = 0; i < solver->conflict().size(); i++) {
+        Lit p = solver->conflict()[i];
         if (coreMapping.find(p) != coreMapping.end()) {
           assert(!activeSoft[coreMapping[p]]);
-          activeSoft[coreMapping[solver->conflict[i]]] = true;
+          activeSoft[coreMapping[solver->conflict()[i]]] = true;
           assert(p ==
-                 maxsat_formula->getSoftClause(coreMapping[solver->conflict[i]])
+                 maxsat_formula->getSoftClause(coreMapping[solver->conflict()[i]])
                      .relaxation_vars[0]);
           soft_relax.push(p);
         }
@@ -200,7 +201,7 @@ StatusCode OLL::unweighted() {
 
           // this is a soft cardinality -- bound must be increased
           std::pair<std::pair<int, int>, int> soft_id =
-              boundMapping[solver->conflict[i]];
+              boundMapping[solver->conflict()[i]];
           // increase the bound
           assert(soft_id.first.first < soft_cardinality.size());
           assert(soft_cardinality[soft_id.first.first]->hasCardEncoding());
@@ -313,6 +314,10 @@ StatusCode OLL::weighted() {
   std::set<Lit> cardinality_assumptions;
   vec<Encoder *> soft_cardinality;
 
+  // Cores of the current stratum that are not encoded yet (see 'setWCE').
+  vec<vec<Lit>> pending_cores;
+  vec<uint64_t> pending_weights;
+
   min_weight = maxsat_formula->getMaximumWeight();
   // printf("current weight %d\n",maxsat_formula->getMaximumWeight());
 
@@ -321,9 +326,9 @@ StatusCode OLL::weighted() {
     res = searchSATSolver(solver, assumptions);
     if (res == l_True) {
       nbSatisfiable++;
-      uint64_t newCost = computeCostModel(solver->model);
-      if (newCost < ubCost || nbSatisfiable == 1) {
-        saveModel(solver->model);
+      uint64_t newCost = computeCostModel(solver->model());
+      if (model.size() == 0 || newCost < ubCost) {
+        saveModel(solver->model());
         if (maxsat_formula->getFormat() == _FORMAT_PB_) {
           // optimization problem
           if (maxsat_formula->getObjFunction() != NULL) {
@@ -334,14 +339,31 @@ StatusCode OLL::weighted() {
         ubCost = newCost;
       }
 
+      if (pending_cores.size() > 0) {
+        // The delayed cores are encoded and the stratum is solved again.
+        for (int i = 0; i < pending_cores.size(); i++)
+          encodeCore(pending_cores[i], pending_weights[i], soft_cardinality,
+                     cardinality_assumptions);
+        pending_cores.clear();
+        pending_weights.clear();
+
+        if (lbCost == ubCost) {
+          if (verbosity > 0)
+            printf("c LB = UB\n");
+          printAnswer(_OPTIMUM_);
+          return _OPTIMUM_;
+        }
+
+        resetAssumptions(assumptions, cardinality_assumptions);
+        continue;
+      }
+
       if (nbSatisfiable == 1) {
         min_weight =
             findNextWeightDiversity(min_weight, cardinality_assumptions);
         // printf("current weight %d\n",min_weight);
 
-        for (int i = 0; i < maxsat_formula->nSoft(); i++)
-          if (maxsat_formula->getSoftClause(i).weight >= min_weight)
-            assumptions.push(~maxsat_formula->getSoftClause(i).assumption_var);
+        resetAssumptions(assumptions, cardinality_assumptions);
       } else {
         // compute min weight in soft
         int not_considered = 0;
@@ -367,31 +389,7 @@ StatusCode OLL::weighted() {
 
           // printf("currentWeight %d\n",currentWeight);
 
-          // reset the assumptions
-          assumptions.clear();
-          int active_soft = 0;
-          for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-            if (!activeSoft[i] &&
-                maxsat_formula->getSoftClause(i).weight >= min_weight) {
-              assumptions.push(
-                  ~maxsat_formula->getSoftClause(i).assumption_var);
-              // printf("s assumption
-              // %d\n",var(softClauses[i].assumptionVar)+1);
-            } else
-              active_soft++;
-          }
-
-          // printf("assumptions %d\n",assumptions.size());
-          for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
-               it != cardinality_assumptions.end(); ++it) {
-            assert(boundMapping.find(*it) != boundMapping.end());
-            std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-                boundMapping[*it];
-            if (soft_id.second >= min_weight)
-              assumptions.push(~(*it));
-            // printf("c assumption %d\n",var(*it)+1);
-          }
-
+          resetAssumptions(assumptions, cardinality_assumptions);
         } else {
           assert(lbCost == newCost);
           printAnswer(_OPTIMUM_);
@@ -401,23 +399,24 @@ StatusCode OLL::weighted() {
     }
 
     if (res == l_False) {
+      core_minimizer.reduce(solver);
 
       // reduce the weighted to the unweighted case
       uint64_t min_core = UINT64_MAX;
-      for (int i = 0; i < solver->conflict.size(); i++) {
-        Lit p = solver->conflict[i];
+      for (int i = 0; i < solver->conflict().size(); i++) {
+        Lit p = solver->conflict()[i];
         if (coreMapping.find(p) != coreMapping.end()) {
           assert(!activeSoft[coreMapping[p]]);
-          if (maxsat_formula->getSoftClause(coreMapping[solver->conflict[i]])
+          if (maxsat_formula->getSoftClause(coreMapping[solver->conflict()[i]])
                   .weight < min_core)
             min_core =
-                maxsat_formula->getSoftClause(coreMapping[solver->conflict[i]])
+                maxsat_formula->getSoftClause(coreMapping[solver->conflict()[i]])
                     .weight;
         }
 
         if (boundMapping.find(p) != boundMapping.end()) {
           std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-              boundMapping[solver->conflict[i]];
+              boundMapping[solver->conflict()[i]];
           if (soft_id.second < min_core)
             min_core = soft_id.second;
         }
@@ -443,13 +442,13 @@ StatusCode OLL::weighted() {
         return _OPTIMUM_;
       }
 
-      sumSizeCores += solver->conflict.size();
+      sumSizeCores += solver->conflict().size();
 
       vec<Lit> soft_relax;
       vec<Lit> cardinality_relax;
 
-      for (int i = 0; i < solver->conflict.size(); i++) {
-        Lit p = solver->conflict[i];
+      for (int i = 0; i < solver->conflict().size(); i++) {
+        Lit p = solver->conflict()[i];
         if (coreMapping.find(p) != coreMapping.end()) {
           if (maxsat_formula->getSoftClause(coreMapping[p]).weight > min_core) {
             // printf("SPLIT THE CLAUSE\n");
@@ -510,7 +509,7 @@ StatusCode OLL::weighted() {
           } else {
             // printf("NOT SPLITTING\n");
             assert(
-                maxsat_formula->getSoftClause(coreMapping[solver->conflict[i]])
+                maxsat_formula->getSoftClause(coreMapping[solver->conflict()[i]])
                     .weight == min_core);
             soft_relax.push(p);
             // printf("ASSERT %d\n",var(p)+1);
@@ -528,7 +527,7 @@ StatusCode OLL::weighted() {
 
           // this is a soft cardinality -- bound must be increased
           std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-              boundMapping[solver->conflict[i]];
+              boundMapping[solver->conflict()[i]];
           // increase the bound
           assert(soft_id.first.first < soft_cardinality.size());
           assert(soft_cardinality[soft_id.first.first]->hasCardEncoding());
@@ -696,64 +695,195 @@ StatusCode OLL::weighted() {
         for (int i = 0; i < cardinality_relax.size(); i++)
           relax_harden.push(cardinality_relax[i]);
 
-        /*
-        for (int i = 0; i < nSoft(); i++){
-          printf("soft %d, w: %d, r:
-        %d\n",i,softClauses[i].weight,var(softClauses[i].relaxationVars[0])+1);
-          for (int j = 0; j < softClauses[i].clause.size(); j++){
-            printf("%d ",var(softClauses[i].clause[j])+1);
-          }
-          printf("\n");
+        if (wce) {
+          // The relaxation literals of the core are left unconstrained until
+          // the assumptions are satisfiable.
+          pending_cores.push();
+          relax_harden.copyTo(pending_cores.last());
+          pending_weights.push(min_core);
+        } else
+          encodeCore(relax_harden, min_core, soft_cardinality,
+                     cardinality_assumptions);
+
+        if (lbCost == ubCost) {
+          if (verbosity > 0)
+            printf("c LB = UB\n");
+          printAnswer(_OPTIMUM_);
+          return _OPTIMUM_;
         }
+      }
 
-        for (int i = 0; i < relax_harden.size(); i++)
-          printf("+1 x%d ",var(relax_harden[i])+1);
-        printf(" <= 1\n");
-        */
-        Encoder *e = new Encoder();
-        e->setIncremental(_INCREMENTAL_ITERATIVE_);
-        e->buildCardinality(solver, relax_harden, 1);
-        soft_cardinality.push(e);
-        assert(e->outputs().size() > 1);
+      resetAssumptions(assumptions, cardinality_assumptions);
+    }
+  }
+}
 
-        // printf("outputs %d\n",e->outputs().size());
-        Lit out = e->outputs()[1];
-        boundMapping[out] = std::make_pair(
-            std::make_pair(soft_cardinality.size() - 1, 1), min_core);
-        cardinality_assumptions.insert(out);
-      }
+// Assumes the soft clauses and the cardinality outputs with weight at least
+// 'min_weight' that are not relaxed or hardened.
+void OLL::resetAssumptions(vec<Lit> &assumptions,
+                           std::set<Lit> &cardinality_assumptions) {
+  hardenSoftLiterals(cardinality_assumptions);
 
-      // reset the assumptions
-      assumptions.clear();
-      int active_soft = 0;
-      for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-        if (!activeSoft[i] &&
-            maxsat_formula->getSoftClause(i).weight >= min_weight) {
-          assumptions.push(~maxsat_formula->getSoftClause(i).assumption_var);
-          // printf("s assumption %d\n",var(softClauses[i].assumptionVar)+1);
-        } else
-          active_soft++;
-      }
+  assumptions.clear();
+  int active_soft = 0;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    if (!activeSoft[i] &&
+        maxsat_formula->getSoftClause(i).weight >= min_weight) {
+      assumptions.push(~maxsat_formula->getSoftClause(i).assumption_var);
+    } else
+      active_soft++;
+  }
 
-      // printf("assumptions %d\n",assumptions.size());
-      for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
-           it != cardinality_assumptions.end(); ++it) {
-        assert(boundMapping.find(*it) != boundMapping.end());
-        std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-            boundMapping[*it];
-        if (soft_id.second >= min_weight)
-          assumptions.push(~(*it));
-        // printf("c assumption %d\n",var(*it)+1);
-      }
+  for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
+       it != cardinality_assumptions.end(); ++it) {
+    assert(boundMapping.find(*it) != boundMapping.end());
+    std::pair<std::pair<int, uint64_t>, uint64_t> soft_id = boundMapping[*it];
+    if (soft_id.second >= min_weight)
+      assumptions.push(~(*it));
+  }
 
-      // printf("card assumptions %d\n",assumptions.size());
+  if (verbosity > 0) {
+    printf("c Relaxed soft clauses %d / %d\n", active_soft,
+           maxsat_formula->nSoft());
+  }
+}
 
-      if (verbosity > 0) {
-        printf("c Relaxed soft clauses %d / %d\n", active_soft,
-               maxsat_formula->nSoft());
-      }
+/*_________________________________________________________________________________________________
+  |
+  |  hardenSoftLiterals : (cardinality_assumptions : std::set<Lit>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Hardens the soft literals whose weight is larger than the gap between
+  |    the upper and the lower bound. Falsifying one of them costs at least
+  |    'lbCost' plus its weight, so no solution that violates it improves on
+  |    the best model. The soft clauses and the cardinality outputs are
+  |    asserted as unit clauses and are no longer assumed.
+  |
+  |  Post-conditions:
+  |    * 'activeSoft' is updated for the hardened soft clauses.
+  |    * The hardened outputs are removed from 'cardinality_assumptions'.
+  |    * If a literal was hardened, learnt clauses are no longer exported to
+  |      the other portfolio threads.
+  |
+  |________________________________________________________________________________________________@*/
+void OLL::hardenSoftLiterals(std::set<Lit> &cardinality_assumptions) {
+  if (model.size() == 0 || lbCost >= ubCost)
+    return;
+
+  uint64_t gap = ubCost - lbCost;
+  int hardened = 0;
+
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    if (!activeSoft[i] && maxsat_formula->getSoftClause(i).weight > gap) {
+      stopClauseExport();
+      solver->addClause(~maxsat_formula->getSoftClause(i).assumption_var);
+      activeSoft[i] = true;
+      hardened++;
     }
   }
+
+  for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
+       it != cardinality_assumptions.end();) {
+    assert(boundMapping.find(*it) != boundMapping.end());
+    if (boundMapping[*it].second > gap) {
+      stopClauseExport();
+      solver->addClause(~(*it));
+      it = cardinality_assumptions.erase(it);
+      hardened++;
+    } else
+      ++it;
+  }
+
+  if (verbosity > 0 && hardened > 0)
+    printf("c Hardened %d soft literals (UB - LB : %" PRIu64 ")\n", hardened,
+           gap);
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  encodeCore : (relax : vec<Lit>&) (weight : uint64_t)
+  |               (soft_cardinality : vec<Encoder *>&)
+  |               (cardinality_assumptions : std::set<Lit>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Builds a totalizer over the relaxation literals of a core. One of the
+  |    literals is already paid for in the lower bound, so the output that
+  |    states that at least two of them are true becomes a new soft literal
+  |    of weight 'weight'. With 'exhaust', the bound starts at the highest
+  |    value that the SAT solver proves to be necessary.
+  |
+  |  Post-conditions:
+  |    * The totalizer is added to 'soft_cardinality' and its output is added
+  |      to 'cardinality_assumptions' and 'boundMapping', unless the bound
+  |      covers all the literals.
+  |    * 'lbCost' is updated by the exhaustion.
+  |
+  |________________________________________________________________________________________________@*/
+void OLL::encodeCore(vec<Lit> &relax, uint64_t weight,
+                     vec<Encoder *> &soft_cardinality,
+                     std::set<Lit> &cardinality_assumptions) {
+  Encoder *e = new Encoder();
+  e->setIncremental(_INCREMENTAL_ITERATIVE_);
+  e->buildCardinality(solver, relax, 1);
+  soft_cardinality.push(e);
+  assert(e->outputs().size() > 1);
+
+  uint64_t bound = 1;
+  if (exhaust)
+    bound = exhaustCore(e, bound, weight);
+
+  if (bound < (unsigned)e->outputs().size()) {
+    Lit out = e->outputs()[bound];
+    boundMapping[out] =
+        std::make_pair(std::make_pair(soft_cardinality.size() - 1, bound),
+                       weight);
+    cardinality_assumptions.insert(out);
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  exhaustCore : (e : Encoder *) (bound : uint64_t) (weight : uint64_t)
+  |                ->  [uint64_t]
+  |
+  |  Description:
+  |
+  |    Core exhaustion. While the SAT solver proves that more than 'bound'
+  |    literals of 'e' must be true (assuming only that output), the bound is
+  |    raised and 'weight' is added to the lower bound. Each raise replaces
+  |    a core that the search would otherwise find later.
+  |
+  |  Post-conditions:
+  |    * Returns the new bound.
+  |    * 'lbCost' and 'nbCores' are updated.
+  |
+  |________________________________________________________________________________________________@*/
+uint64_t OLL::exhaustCore(Encoder *e, uint64_t bound, uint64_t weight) {
+  vec<Lit> assumptions;
+  vec<Lit> joinObjFunction;
+  vec<Lit> encodingAssumptions;
+
+  while (bound < (unsigned)e->outputs().size() && lbCost < ubCost) {
+    assumptions.clear();
+    assumptions.push(~e->outputs()[bound]);
+    if (searchSATSolver(solver, assumptions) != l_False)
+      break;
+
+    nbCores++;
+    lbCost += weight;
+    if (verbosity > 0)
+      printf("c LB : %-12" PRIu64 " (exhaustion)\n", lbCost);
+
+    joinObjFunction.clear();
+    encodingAssumptions.clear();
+    e->incUpdateCardinality(solver, joinObjFunction, e->lits(), bound + 1,
+                            encodingAssumptions);
+    bound++;
+  }
+
+  return bound;
 }
 
 StatusCode OLL::search() {
@@ -785,24 +915,23 @@ StatusCode OLL::search() {
 
 /*_________________________________________________________________________________________________
   |
-  |  rebuildSolver : [void]  ->  [Solver *]
+  |  rebuildSolver : [void]  ->  [SATBackend *]
   |
   |  Description:
   |
   |    Rebuilds a SAT solver with the current MaxSAT formula.
   |
   |________________________________________________________________________________________________@*/
-Solver *OLL::rebuildSolver() {
+SATBackend *OLL::rebuildSolver() {
 
-  Solver *S = newSATSolver();
+  SATBackend *S = newSATSolver();
 
   reserveSATVariables(S, maxsat_formula->nVars());
 
   for (int i = 0; i < maxsat_formula->nVars(); i++)
     newSATVariable(S);
 
-  for (int i = 0; i < maxsat_formula->nHard(); i++)
-    S->addClause(maxsat_formula->getHardClause(i).clause);
+  addHardClauses(S);
 
   // printf("c #PB: %d\n", maxsat_formula->nPB());
   for (int i = 0; i < maxsat_formula->nPB(); i++) {
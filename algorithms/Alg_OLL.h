@@ -52,6 +52,8 @@ public:
     encoding = enc;
     encoder.setCardEncoding(enc);
     min_weight = 1;
+    wce = false;
+    exhaust = false;
   }
   ~OLL() {
     if (solver != NULL)
@@ -60,6 +62,13 @@ public:
 
   StatusCode search();
 
+  // Delays the encoding of the cores of a stratum until the assumptions are
+  // satisfiable (weight-aware core extraction).
+  void setWCE(bool delay) { wce = delay; }
+  // Raises the bound of each new cardinality constraint while it is
+  // unsatisfiable (core exhaustion).
+  void setExhaust(bool raise) { exhaust = raise; }
+
   // Print solver configuration.
   void printConfiguration() {
 
@@ -80,7 +89,7 @@ public:
 protected:
   // Rebuild MaxSAT solver
   //
-  Solver *rebuildSolver(); // Rebuild MaxSAT solver.
+  SATBackend *rebuildSolver(); // Rebuild MaxSAT solver.
 
   // Other
   void initRelaxation(); // Relaxes soft clauses.
@@ -88,7 +97,22 @@ protected:
   StatusCode unweighted();
   StatusCode weighted();
 
-  Solver *solver;  // SAT Solver used as a black box.
+  // Utils for the weighted search
+  //
+  // Encodes a cardinality constraint over the relaxation literals of a core
+  // of weight 'weight'.
+  void encodeCore(vec<Lit> &relax, uint64_t weight,
+                  vec<Encoder *> &soft_cardinality,
+                  std::set<Lit> &cardinality_assumptions);
+  // Returns the highest bound of 'e' above 'bound' that is unsatisfiable.
+  uint64_t exhaustCore(Encoder *e, uint64_t bound, uint64_t weight);
+  // Hardens the soft literals whose weight exceeds the gap between bounds.
+  void hardenSoftLiterals(std::set<Lit> &cardinality_assumptions);
+  // Assumes the soft clauses and cardinality outputs of the current stratum.
+  void resetAssumptions(vec<Lit> &assumptions,
+                        std::set<Lit> &cardinality_assumptions);
+
+  SATBackend *solver;  // SAT Solver used as a black box.
   Encoder encoder; // Interface for the encoder of constraints to CNF.
 
   // Controls the incremental strategy used by MSU3 algorithms.
@@ -120,6 +144,9 @@ protected:
                           std::set<Lit> &cardinality_assumptions);
 
   uint64_t min_weight;
+
+  bool wce;     // Delays the encoding of cores.
+  bool exhaust; // Exhausts new cardinality constraints.
 };
 } // namespace openwbo
 
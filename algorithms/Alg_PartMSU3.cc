@@ -27,6 +27,10 @@
 
 #include "Alg_PartMSU3.h"
 
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
 #include <gmpxx.h>
 #include <iostream>
 
@@ -476,8 +480,7 @@ StatusCode PartMSU3::PartMSU3_sequential() {
   vec<Lit> currentObjFunction;
   vec<Lit> encodingAssumptions;
 
-  Encoder *encoder = new Encoder();
-  encoder->setIncremental(incremental_strategy);
+  Encoder *encoder = new Encoder(incremental_strategy, encoding);
 
   // Initialize partitions
   int part_index = 0;
@@ -485,7 +488,7 @@ StatusCode PartMSU3::PartMSU3_sequential() {
   bool add_unit_parts = false;
   vec<int> unit_parts;
   if (nPartitions() == 0) {
-    split(UNFOLDING_MODE, graph_type);
+    split(community_mode, graph_type);
   }
   printConfiguration();
 
@@ -506,9 +509,9 @@ StatusCode PartMSU3::PartMSU3_sequential() {
     res = searchSATSolver(solver, assumptions);
     if (res == l_True) {
       nbSatisfiable++;
-      uint64_t newCost = computeCostModel(solver->model);
+      uint64_t newCost = computeCostModel(solver->model());
       if (nbSatisfiable == 1 || newCost < ubCost) {
-        saveModel(solver->model);
+        saveModel(solver->model());
         printBound(newCost);
         ubCost = newCost;
       }
@@ -581,20 +584,21 @@ StatusCode PartMSU3::PartMSU3_sequential() {
         return _OPTIMUM_;
       }
 
-      sumSizeCores += solver->conflict.size();
+      core_minimizer.reduce(solver);
+      sumSizeCores += solver->conflict().size();
 
-      if (solver->conflict.size() == 0) {
+      if (solver->conflict().size() == 0) {
         printAnswer(_UNSATISFIABLE_);
         return _UNSATISFIABLE_;
       }
 
       joinObjFunction.clear();
-      for (int i = 0; i < solver->conflict.size(); i++) {
-        if (coreMapping.find(solver->conflict[i]) != coreMapping.end()) {
-          assert(!activeSoft[coreMapping[solver->conflict[i]]]);
-          activeSoft[coreMapping[solver->conflict[i]]] = true;
+      for (int i = 0; i < solver->conflict().size(); i++) {
+        if (coreMapping.find(solver->conflict()[i]) != coreMapping.end()) {
+          assert(!activeSoft[coreMapping[solver->conflict()[i]]]);
+          activeSoft[coreMapping[solver->conflict()[i]]] = true;
           joinObjFunction.push(
-              getRelaxationLit(coreMapping[solver->conflict[i]]));
+              getRelaxationLit(coreMapping[solver->conflict()[i]]));
         }
       }
 
@@ -679,7 +683,7 @@ StatusCode PartMSU3::PartMSU3_binary() {
   std::deque<TreeNode *> guide_tree;
 
   if (nPartitions() == 0) {
-    split(UNFOLDING_MODE, graph_type);
+    split(community_mode, graph_type);
   }
   printConfiguration();
 
@@ -704,9 +708,9 @@ StatusCode PartMSU3::PartMSU3_binary() {
     res = searchSATSolver(solver, assumptions);
     if (res == l_True) {
       nbSatisfiable++;
-      uint64_t newCost = computeCostModel(solver->model);
+      uint64_t newCost = computeCostModel(solver->model());
       if (nbSatisfiable == 1 || newCost < ubCost) {
-        saveModel(solver->model);
+        saveModel(solver->model());
         printBound(newCost);
         ubCost = newCost;
       }
@@ -837,7 +841,7 @@ StatusCode PartMSU3::PartMSU3_binary() {
     }
 
     if (res == l_False) {
-      if (nbSatisfiable == 0 || solver->conflict.size() == 0) {
+      if (nbSatisfiable == 0 || solver->conflict().size() == 0) {
         printAnswer(_UNSATISFIABLE_);
         return _UNSATISFIABLE_;
       }
@@ -856,15 +860,16 @@ StatusCode PartMSU3::PartMSU3_binary() {
         return _OPTIMUM_;
       }
 
-      sumSizeCores += solver->conflict.size();
+      core_minimizer.reduce(solver);
+      sumSizeCores += solver->conflict().size();
 
       joinObjFunction.clear();
-      for (int i = 0; i < solver->conflict.size(); i++) {
-        if (coreMapping.find(solver->conflict[i]) != coreMapping.end()) {
-          assert(!activeSoft[coreMapping[solver->conflict[i]]]);
-          activeSoft[coreMapping[solver->conflict[i]]] = true;
+      for (int i = 0; i < solver->conflict().size(); i++) {
+        if (coreMapping.find(solver->conflict()[i]) != coreMapping.end()) {
+          assert(!activeSoft[coreMapping[solver->conflict()[i]]]);
+          activeSoft[coreMapping[solver->conflict()[i]]] = true;
           joinObjFunction.push(
-              getRelaxationLit(coreMapping[solver->conflict[i]]));
+              getRelaxationLit(coreMapping[solver->conflict()[i]]));
           nrelaxed++;
         }
       }
@@ -916,28 +921,788 @@ StatusCode PartMSU3::PartMSU3_binary() {
   }
 }
 
-StatusCode PartMSU3::search() {
-  if (maxsat_formula->getProblemType() == _WEIGHTED_) {
-    if(print) {
-      printf("Error: Currently algorithm MSU3 does not support weighted MaxSAT "
-             "instances.\n");
-      printf("s UNKNOWN\n");
+/*_________________________________________________________________________________________________
+  |
+  |  solveNode : (node : TreeNode *)  ->  [StatusCode]
+  |
+  |  Description:
+  |
+  |    Runs MSU3 on the soft clauses of the partitions of 'node', using the
+  |    solver, encoder and lower bound of the node. Soft clauses of other
+  |    partitions are not assumed and may be freely falsified. Each core
+  |    increases both the lower bound of the node and the global lower bound,
+  |    since the nodes being solved have disjoint sets of soft clauses.
+  |
+  |  Post-conditions:
+  |    * Returns _OPTIMUM_ when the node is satisfiable with its lower bound.
+  |    * Returns _UNSATISFIABLE_ if the hard clauses are unsatisfiable.
+  |    * Returns _UNKNOWN_ if the search was stopped ('part_stop').
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode PartMSU3::solveNode(TreeNode *node) {
+  SATBackend *S = node->getSolver();
+  Encoder *encoder = node->getEncoder();
+  vec<Lit> &encodingAssumptions = *(node->getEncodingAssumptions());
+  vec<Lit> assumptions;
+  vec<Lit> joinObjFunction;
+  vec<Lit> currentObjFunction;
+
+  for (int i = 0; i < node->getPartitions().size(); ++i) {
+    int comm = node->getPartitions()[i];
+    for (int j = 0; j < nPartitionSoft(comm); ++j) {
+      if (!activeSoft[communitySoft(comm)[j]])
+        assumptions.push(~getAssumptionLit(communitySoft(comm)[j]));
+    }
+  }
+  addVector(assumptions, encodingAssumptions);
+
+  for (;;) {
+    {
+      std::lock_guard<std::mutex> lock(part_mutex);
+      if (part_stop)
+        return _UNKNOWN_;
+      part_busy.insert(S);
+    }
+    lbool res = searchSATSolver(S, assumptions);
+    {
+      std::lock_guard<std::mutex> lock(part_mutex);
+      part_busy.erase(S);
+    }
+
+    if (res == l_Undef)
+      return _UNKNOWN_;
+
+    if (res == l_True) {
+      std::lock_guard<std::mutex> lock(part_mutex);
+      nbSatisfiable++;
+      uint64_t newCost = computeCostModel(S->model());
+      if (model.size() == 0 || newCost < ubCost) {
+        saveModel(S->model());
+        printBound(newCost);
+        ubCost = newCost;
+      }
+      return _OPTIMUM_;
+    }
+
+    if (S->conflict().size() == 0)
+      return _UNSATISFIABLE_;
+
+    node->incrementLowerBound();
+    {
+      std::lock_guard<std::mutex> lock(part_mutex);
+      lbCost++;
+      nbCores++;
+      sumSizeCores += S->conflict().size();
+      if (verbosity > 0)
+        printf("c LB : %-12" PRIu64 "\n", lbCost);
+
+      if (lbCost == ubCost) {
+        if (verbosity > 0)
+          printf("c LB = UB\n");
+        part_stop = true;
+        for (std::set<SATBackend *>::iterator it = part_busy.begin();
+             it != part_busy.end(); ++it)
+          (*it)->terminate();
+        return _UNKNOWN_;
+      }
+    }
+
+    // Soft clauses of other nodes are never assumed, so the core only contains
+    // soft clauses of this node.
+    joinObjFunction.clear();
+    for (int i = 0; i < S->conflict().size(); i++) {
+      std::map<Lit, int>::iterator it = coreMapping.find(S->conflict()[i]);
+      if (it != coreMapping.end()) {
+        assert(!activeSoft[it->second]);
+        activeSoft[it->second] = true;
+        joinObjFunction.push(getRelaxationLit(it->second));
+      }
+    }
+
+    currentObjFunction.clear();
+    assumptions.clear();
+    for (int i = 0; i < node->getPartitions().size(); ++i) {
+      int comm = node->getPartitions()[i];
+      for (int j = 0; j < nPartitionSoft(comm); ++j) {
+        int soft_index = communitySoft(comm)[j];
+        if (activeSoft[soft_index]) {
+          currentObjFunction.push(getRelaxationLit(soft_index));
+        } else {
+          assumptions.push(~getAssumptionLit(soft_index));
+        }
+      }
+    }
+
+    if (!encoder->hasCardEncoding()) {
+      if (node->getLowerBound() != currentObjFunction.size()) {
+        encoder->buildCardinality(S, currentObjFunction,
+                                  node->getLowerBound());
+        encoder->incUpdateCardinality(S, currentObjFunction,
+                                      node->getLowerBound(),
+                                      encodingAssumptions);
+      }
+    } else {
+      // Incremental construction of the encoding.
+      if (joinObjFunction.size() > 0)
+        encoder->joinEncoding(S, joinObjFunction, node->getLowerBound());
+
+      // The right-hand side is constrained using assumptions.
+      encodingAssumptions.clear();
+      encoder->incUpdateCardinality(S, currentObjFunction,
+                                    node->getLowerBound(),
+                                    encodingAssumptions);
+    }
+    addVector(assumptions, encodingAssumptions);
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  mergeNodes : (parent : TreeNode *) (left : TreeNode *) (right : TreeNode *)
+  |               ->  [void]
+  |
+  |  Description:
+  |
+  |    Merges two solved children into their parent. The parent keeps the
+  |    solver of the child with the largest lower bound (and its learnt
+  |    clauses), imports the short learnt clauses, activities and phases of
+  |    the other solver, starts from the sum of the lower bounds of the
+  |    children and bounds all the soft clauses relaxed in the cores of both
+  |    children with a new cardinality constraint.
+  |
+  |________________________________________________________________________________________________@*/
+void PartMSU3::mergeNodes(TreeNode *parent, TreeNode *left, TreeNode *right) {
+  TreeNode *keep = left;
+  TreeNode *drop = right;
+  if (drop->getLowerBound() > keep->getLowerBound())
+    std::swap(keep, drop);
+
+  SATBackend *S = keep->getSolver();
+  parent->setSolver(S);
+  parent->incrementLowerBound(left->getLowerBound() + right->getLowerBound());
+  parent->setEncoder(new Encoder(incremental_strategy, encoding));
+  parent->setEncodingAssumptions(new vec<Lit>());
+
+  transferSearchState(drop->getSolver(), S);
+  delete drop->getSolver();
+  delete left->getEncoder();
+  delete left->getEncodingAssumptions();
+  delete right->getEncoder();
+  delete right->getEncodingAssumptions();
+  delete left;
+  delete right;
+
+  vec<Lit> currentObjFunction;
+  for (int i = 0; i < parent->getPartitions().size(); ++i) {
+    int comm = parent->getPartitions()[i];
+    for (int j = 0; j < nPartitionSoft(comm); ++j) {
+      if (activeSoft[communitySoft(comm)[j]])
+        currentObjFunction.push(getRelaxationLit(communitySoft(comm)[j]));
     }
-    throw MaxSATException(__FILE__, __LINE__, "MSU3 does not support weighted");
+  }
+
+  int64_t lb = parent->getLowerBound();
+  if (lb > 0 && lb != currentObjFunction.size()) {
+    parent->getEncoder()->buildCardinality(S, currentObjFunction, lb);
+    parent->getEncoder()->incUpdateCardinality(
+        S, currentObjFunction, lb, *(parent->getEncodingAssumptions()));
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  PartMSU3_parallel : [void]  ->  [StatusCode]
+  |
+  |  Description:
+  |
+  |    Parallel version of 'PartMSU3_binary'. Leaves and disjoint subtrees of
+  |    the guide tree are independent until they are merged, so each node is
+  |    solved by 'solveNode' with its own solver and encoder on a pool of
+  |    'n_threads' threads. When both children of a node are solved they are
+  |    merged with 'mergeNodes' and the parent becomes ready. The leaves are
+  |    scheduled in depth-first order so that siblings are solved close in
+  |    time. The search ends when the root is solved or when the global lower
+  |    bound meets the upper bound.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode PartMSU3::PartMSU3_parallel() {
+  std::deque<TreeNode *> guide_tree;
+
+  if (nPartitions() == 0) {
+    split(community_mode, graph_type);
+  }
+  printConfiguration();
+  computeGuideTree(guide_tree);
+
+  // Children of each node and leaves in depth-first order.
+  std::map<TreeNode *, std::vector<TreeNode *>> children;
+  std::vector<TreeNode *> roots;
+  std::set<TreeNode *> visited;
+  for (size_t i = 0; i < guide_tree.size(); i++) {
+    TreeNode *node = guide_tree[i];
+    while (visited.insert(node).second) {
+      if (!node->hasParent()) {
+        roots.push_back(node);
+        break;
+      }
+      children[node->getParent()].push_back(node);
+      node = node->getParent();
+    }
+  }
+
+  // Merging always ends in a single root, whose model is then optimal.
+  assert(roots.size() == 1);
+
+  std::deque<TreeNode *> ready;
+  std::vector<TreeNode *> stack(roots.rbegin(), roots.rend());
+  while (!stack.empty()) {
+    TreeNode *node = stack.back();
+    stack.pop_back();
+    if (children.find(node) == children.end())
+      ready.push_back(node);
+    else
+      stack.insert(stack.end(), children[node].rbegin(),
+                   children[node].rend());
+  }
+
+  std::map<TreeNode *, TreeNode *> solved; // first solved child of a node
+
+  // Inner nodes that have not been reached by the merging yet.
+  std::set<TreeNode *> pending;
+  for (std::map<TreeNode *, std::vector<TreeNode *>>::iterator it =
+           children.begin();
+       it != children.end(); ++it)
+    pending.insert(it->first);
+
+  auto release = [&](TreeNode *node) {
+    delete node->getSolver();
+    delete node->getEncoder();
+    delete node->getEncodingAssumptions();
+    delete node;
+  };
+
+  // Frees the nodes left when the search stops before the root is solved.
+  auto releaseRemaining = [&]() {
+    for (size_t i = 0; i < ready.size(); i++)
+      release(ready[i]);
+    for (std::map<TreeNode *, TreeNode *>::iterator it = solved.begin();
+         it != solved.end(); ++it)
+      release(it->second);
+    for (std::set<TreeNode *>::iterator it = pending.begin();
+         it != pending.end(); ++it)
+      release(*it);
+  };
+
+  initRelaxation();
+  activeSoft.growTo(maxsat_formula->nSoft(), false);
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    coreMapping[getAssumptionLit(i)] = i;
+
+  // The first leaf checks the hard clauses and provides an upper bound.
+  ready.front()->setSolver(rebuildSolver());
+  lbool res = searchSATSolver(ready.front()->getSolver());
+  if (res == l_False) {
+    releaseRemaining();
+    printAnswer(_UNSATISFIABLE_);
+    return _UNSATISFIABLE_;
+  }
+  nbSatisfiable++;
+  ubCost = computeCostModel(ready.front()->getSolver()->model());
+  saveModel(ready.front()->getSolver()->model());
+  printBound(ubCost);
+
+  std::condition_variable cv;
+  int remaining_roots = roots.size();
+  bool unsat = false;
+  part_stop = (lbCost == ubCost);
+
+  auto worker = [&]() {
+    for (;;) {
+      TreeNode *node;
+      {
+        std::unique_lock<std::mutex> lock(part_mutex);
+        cv.wait(lock, [&] {
+          return !ready.empty() || part_stop || remaining_roots == 0;
+        });
+        if (part_stop || remaining_roots == 0)
+          return;
+
+        node = ready.front();
+        ready.pop_front();
+        if (node->getSolver() == NULL)
+          node->setSolver(rebuildSolver());
+        if (node->getEncoder() == NULL) {
+          node->setEncoder(new Encoder(incremental_strategy, encoding));
+          node->setEncodingAssumptions(new vec<Lit>());
+        }
+      }
+
+      StatusCode status = solveNode(node);
+
+      TreeNode *parent = NULL, *sibling = NULL;
+      {
+        std::lock_guard<std::mutex> lock(part_mutex);
+        // Any other outcome stops the search, since the parent of the node
+        // can no longer be solved.
+        if (status != _OPTIMUM_) {
+          if (status == _UNSATISFIABLE_)
+            unsat = true;
+          if (!part_stop) {
+            part_stop = true;
+            for (std::set<SATBackend *>::iterator it = part_busy.begin();
+                 it != part_busy.end(); ++it)
+              (*it)->terminate();
+          }
+          release(node);
+          cv.notify_all();
+          return;
+        }
+
+        if (!node->hasParent()) {
+          release(node);
+          remaining_roots--;
+          cv.notify_all();
+          continue;
+        }
+
+        parent = node->getParent();
+        if (solved.find(parent) == solved.end() &&
+            children[parent].size() > 1) {
+          solved[parent] = node; // wait for the sibling
+          continue;
+        }
+        if (solved.find(parent) != solved.end()) {
+          sibling = solved[parent];
+          solved.erase(parent);
+        }
+      }
+
+      if (sibling == NULL) {
+        // Node with a single child.
+        parent->setSolver(node->getSolver());
+        parent->setEncoder(node->getEncoder());
+        parent->setEncodingAssumptions(node->getEncodingAssumptions());
+        parent->incrementLowerBound(node->getLowerBound());
+        delete node;
+      } else
+        mergeNodes(parent, sibling, node);
+
+      {
+        std::lock_guard<std::mutex> lock(part_mutex);
+        pending.erase(parent);
+        ready.push_front(parent);
+        cv.notify_all();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < n_threads; i++)
+    threads.push_back(std::thread(worker));
+  for (size_t i = 0; i < threads.size(); i++)
+    threads[i].join();
+
+  releaseRemaining();
+
+  if (unsat) {
+    printAnswer(_UNSATISFIABLE_);
+    return _UNSATISFIABLE_;
+  }
+
+  // The search was stopped before the bounds met (e.g. the SAT solver was
+  // interrupted).
+  if (lbCost != ubCost && remaining_roots != 0) {
+    printAnswer(_UNKNOWN_);
     return _UNKNOWN_;
   }
 
+  printAnswer(_OPTIMUM_);
+  return _OPTIMUM_;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  orderGuideTreeLeaves : (leaves : deque<TreeNode *>&)
+  |                         (out_leaves : vec<TreeNode *>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Orders the leaves of the guide tree by a depth-first traversal from the
+  |    root(s), so that leaves that are merged early by the binary strategy
+  |    are consecutive in 'out_leaves'.
+  |
+  |________________________________________________________________________________________________@*/
+void PartMSU3::orderGuideTreeLeaves(deque<TreeNode *> &leaves,
+                                    vec<TreeNode *> &out_leaves) {
+  std::map<TreeNode *, std::vector<TreeNode *>> children;
+  std::vector<TreeNode *> roots;
+
+  for (size_t i = 0; i < leaves.size(); i++) {
+    TreeNode *node = leaves[i];
+    for (;;) {
+      if (!node->hasParent()) {
+        roots.push_back(node);
+        break;
+      }
+      TreeNode *parent = node->getParent();
+      bool visited = children.find(parent) != children.end();
+      children[parent].push_back(node);
+      if (visited)
+        break;
+      node = parent;
+    }
+  }
+
+  std::vector<TreeNode *> stack(roots.rbegin(), roots.rend());
+  while (!stack.empty()) {
+    TreeNode *node = stack.back();
+    stack.pop_back();
+    std::map<TreeNode *, std::vector<TreeNode *>>::iterator it =
+        children.find(node);
+    if (it == children.end()) {
+      out_leaves.push(node);
+      continue;
+    }
+    for (size_t i = it->second.size(); i > 0; i--)
+      stack.push_back(it->second[i - 1]);
+    delete node; // Inner nodes are not used by the weighted algorithm.
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  relaxWeightedCore : (core : vec<Lit>&) (min_core : uint64_t)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Relaxes a core as in OLL. Soft clauses and totalizer outputs with a
+  |    weight larger than 'min_core' are split, the bound of the totalizers in
+  |    the core is increased, and a new totalizer is built over the relaxed
+  |    literals whose second output is assumed to be false.
+  |
+  |________________________________________________________________________________________________@*/
+void PartMSU3::relaxWeightedCore(vec<Lit> &core, uint64_t min_core) {
+  vec<Lit> soft_relax;
+  vec<Lit> cardinality_relax;
+  vec<Lit> joinObjFunction;
+  vec<Lit> encodingAssumptions;
+
+  for (int i = 0; i < core.size(); i++) {
+    Lit p = core[i];
+
+    if (coreMapping.find(p) != coreMapping.end()) {
+      int indexSoft = coreMapping[p];
+      assert(!activeSoft[indexSoft]);
+
+      if (maxsat_formula->getSoftClause(indexSoft).weight > min_core) {
+        // Split the soft clause: the part with weight 'min_core' is relaxed.
+        maxsat_formula->getSoftClause(indexSoft).weight -= min_core;
+
+        vec<Lit> clause;
+        vec<Lit> vars;
+        maxsat_formula->getSoftClause(indexSoft).clause.copyTo(clause);
+
+        // The totalizers created variables in the solver only.
+        while (maxsat_formula->nVars() < solver->nVars())
+          maxsat_formula->newLiteral();
+        Lit l = maxsat_formula->newLiteral();
+        vars.push(l);
+
+        maxsat_formula->addSoftClause(min_core, clause, vars);
+        maxsat_formula->getSoftClause(maxsat_formula->nSoft() - 1)
+            .assumption_var = l;
+        coreMapping[l] = maxsat_formula->nSoft() - 1;
+        activeSoft.push(true);
+
+        newSATVariable(solver);
+        clause.push(l);
+        solver->addClause(clause);
+
+        soft_relax.push(l);
+      } else {
+        soft_relax.push(p);
+        activeSoft[indexSoft] = true;
+      }
+    }
+
+    if (boundMapping.find(p) != boundMapping.end()) {
+      std::pair<std::pair<int, uint64_t>, uint64_t> soft_id = boundMapping[p];
+      int id = soft_id.first.first;
+      uint64_t bound = soft_id.first.second;
+
+      if (soft_id.second == min_core) {
+        core_assumptions.erase(p);
+        cardinality_relax.push(p);
+      } else {
+        // Split the output: a copy of the totalizer takes weight 'min_core'.
+        Encoder *e = new Encoder();
+        e->setIncremental(_INCREMENTAL_ITERATIVE_);
+        e->buildCardinality(solver, core_cardinality[id]->lits(), bound);
+        assert((uint64_t)e->outputs().size() > bound);
+        core_cardinality.push(e);
+
+        Lit out = e->outputs()[bound];
+        boundMapping[out] = std::make_pair(
+            std::make_pair(core_cardinality.size() - 1, bound), min_core);
+        cardinality_relax.push(out);
+
+        boundMapping[p] =
+            std::make_pair(std::make_pair(id, bound), soft_id.second - min_core);
+        id = core_cardinality.size() - 1;
+      }
+
+      // At least 'bound' literals are true: assume the next output is false.
+      joinObjFunction.clear();
+      encodingAssumptions.clear();
+      core_cardinality[id]->incUpdateCardinality(
+          solver, joinObjFunction, core_cardinality[id]->lits(), bound + 1,
+          encodingAssumptions);
+      if (bound + 1 < (uint64_t)core_cardinality[id]->outputs().size()) {
+        Lit out = core_cardinality[id]->outputs()[bound + 1];
+        boundMapping[out] =
+            std::make_pair(std::make_pair(id, bound + 1), min_core);
+        core_assumptions.insert(out);
+      }
+    }
+  }
+
+  assert(soft_relax.size() + cardinality_relax.size() > 0);
+
+  if (soft_relax.size() == 1 && cardinality_relax.size() == 0) {
+    // Unit core
+    solver->addClause(soft_relax[0]);
+  }
+
+  if (soft_relax.size() + cardinality_relax.size() > 1) {
+    vec<Lit> relax_harden;
+    soft_relax.copyTo(relax_harden);
+    for (int i = 0; i < cardinality_relax.size(); i++)
+      relax_harden.push(cardinality_relax[i]);
+
+    Encoder *e = new Encoder();
+    e->setIncremental(_INCREMENTAL_ITERATIVE_);
+    e->buildCardinality(solver, relax_harden, 1);
+    assert(e->outputs().size() > 1);
+    core_cardinality.push(e);
+
+    Lit out = e->outputs()[1];
+    boundMapping[out] =
+        std::make_pair(std::make_pair(core_cardinality.size() - 1, 1), min_core);
+    core_assumptions.insert(out);
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  weightLevels : (levels : vec<uint64_t>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Computes the weights used to stratify the soft clauses, in decreasing
+  |    order. As in the diversity heuristic of OLL, a weight is a level if the
+  |    soft clauses with at least that weight have, on average, more than
+  |    1.25 clauses per distinct weight. The last level is always 1, since
+  |    splitting soft clauses may create weights below the initial ones.
+  |
+  |________________________________________________________________________________________________@*/
+void PartMSU3::weightLevels(vec<uint64_t> &levels) {
+  std::map<uint64_t, int> nbWeights;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    nbWeights[maxsat_formula->getSoftClause(i).weight]++;
+
+  float alpha = 1.25;
+  int nbClauses = 0;
+  int nbDistinct = 0;
+  for (std::map<uint64_t, int>::reverse_iterator it = nbWeights.rbegin();
+       it != nbWeights.rend(); ++it) {
+    nbClauses += it->second;
+    nbDistinct++;
+    if ((float)nbClauses / nbDistinct > alpha)
+      levels.push(it->first);
+  }
+
+  if (levels.size() == 0 || levels.last() > 1)
+    levels.push(1);
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  PartMSU3_weighted : [void] ->  [StatusCode]
+  |
+  |  Description:
+  |
+  |    Weighted partition-guided algorithm. The cores are relaxed as in OLL
+  |    and the soft clauses are stratified by weight. Within each weight level
+  |    the soft clauses are added to the assumptions one leaf of the guide
+  |    tree at a time, following a depth-first order of the tree, so that the
+  |    cores found first are local to a few communities and the totalizers
+  |    built over them stay small.
+  |
+  |    The lower bound is the sum of the weights of the cores and remains
+  |    valid as more soft clauses are considered. The model of the first
+  |    satisfiable call after all the soft clauses are considered is optimal.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode PartMSU3::PartMSU3_weighted() {
+  lbool res = l_True;
+  vec<Lit> assumptions;
+
+  if (nPartitions() == 0) {
+    split(community_mode, graph_type);
+  }
+  printConfiguration();
+
+  // Soft clauses of each leaf of the guide tree, in depth-first order. The
+  // last stage contains all the soft clauses.
+  vec<vec<int>> stages;
+  if (nPartitions() > 0) {
+    std::deque<TreeNode *> guide_tree;
+    vec<TreeNode *> leaves;
+    computeGuideTree(guide_tree);
+    orderGuideTreeLeaves(guide_tree, leaves);
+    stages.growTo(leaves.size());
+    for (int i = 0; i < leaves.size(); i++) {
+      for (int j = 0; j < leaves[i]->getPartitions().size(); j++) {
+        int comm = leaves[i]->getPartitions()[j];
+        for (int k = 0; k < nPartitionSoft(comm); k++)
+          stages[i].push(communitySoft(comm)[k]);
+      }
+      delete leaves[i];
+    }
+  }
+  stages.push();
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    stages.last().push(i);
+
+  vec<uint64_t> levels;
+  weightLevels(levels);
+
+  // Build solver
+  initRelaxation();
+  solver = rebuildSolver();
+
+  activeSoft.growTo(maxsat_formula->nSoft(), false);
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    coreMapping[getAssumptionLit(i)] = i;
+
+  // The first call only checks the hard clauses.
+  vec<bool> consideredSoft(maxsat_formula->nSoft(), false);
+  int level = 0;
+  int stage = -1;
+
+  for (;;) {
+    res = searchSATSolver(solver, assumptions);
+    if (res == l_True) {
+      nbSatisfiable++;
+      uint64_t newCost = computeCostModel(solver->model());
+      if (model.size() == 0 || newCost < ubCost) {
+        saveModel(solver->model());
+        printBound(newCost + off_set);
+        ubCost = newCost;
+      }
+
+      bool last = level == levels.size() - 1 && stage == stages.size() - 1;
+      if (last || lbCost == ubCost) {
+        assert(lbCost == ubCost || lbCost == newCost);
+        printAnswer(_OPTIMUM_);
+        return _OPTIMUM_;
+      }
+
+      // Move to the next leaf (or weight level) that adds soft clauses.
+      bool added = false;
+      while (!added && !last) {
+        if (++stage == stages.size()) {
+          level++;
+          stage = 0;
+        }
+        for (int i = 0; i < stages[stage].size(); i++) {
+          int soft = stages[stage][i];
+          if (!consideredSoft[soft] &&
+              maxsat_formula->getSoftClause(soft).weight >= levels[level]) {
+            consideredSoft[soft] = true;
+            added = true;
+          }
+        }
+        last = level == levels.size() - 1 && stage == stages.size() - 1;
+      }
+    } else {
+      if (nbSatisfiable == 0) {
+        printAnswer(_UNSATISFIABLE_);
+        return _UNSATISFIABLE_;
+      }
+
+      core_minimizer.reduce(solver);
+      uint64_t min_core = UINT64_MAX;
+      for (int i = 0; i < solver->conflict().size(); i++) {
+        Lit p = solver->conflict()[i];
+        if (coreMapping.find(p) != coreMapping.end())
+          min_core = std::min(
+              min_core, maxsat_formula->getSoftClause(coreMapping[p]).weight);
+        if (boundMapping.find(p) != boundMapping.end())
+          min_core = std::min(min_core, boundMapping[p].second);
+      }
+
+      lbCost += min_core;
+      nbCores++;
+      sumSizeCores += solver->conflict().size();
+      if (verbosity > 0)
+        printf("c LB : %-12" PRIu64 "\n", lbCost);
+
+      if (lbCost == ubCost) {
+        if (verbosity > 0)
+          printf("c LB = UB\n");
+        printAnswer(_OPTIMUM_);
+        return _OPTIMUM_;
+      }
+
+      vec<Lit> core;
+      solver->conflict().copyTo(core);
+      relaxWeightedCore(core, min_core);
+      // Soft clauses created by splits are already relaxed.
+      while (consideredSoft.size() < maxsat_formula->nSoft())
+        consideredSoft.push(true);
+    }
+
+    // Soft clauses whose weight was reduced below the current level by a
+    // split wait for a later level, as in OLL.
+    assumptions.clear();
+    for (int i = 0; i < maxsat_formula->nSoft(); i++)
+      if (consideredSoft[i] && !activeSoft[i] &&
+          maxsat_formula->getSoftClause(i).weight >= levels[level])
+        assumptions.push(~getAssumptionLit(i));
+    for (std::set<Lit>::iterator it = core_assumptions.begin();
+         it != core_assumptions.end(); ++it)
+      if (boundMapping[*it].second >= levels[level])
+        assumptions.push(~(*it));
+  }
+}
+
+StatusCode PartMSU3::search() {
   if (incremental_strategy == _INCREMENTAL_ITERATIVE_) {
-    if (encoding != _CARD_TOTALIZER_) {
+    if (encoding != _CARD_TOTALIZER_ && encoding != _CARD_NATIVE_) {
       if(print) {
         printf("Error: Currently iterative encoding in PartMSU3 only "
-               "supports the Totalizer encoding.\n");
+               "supports the Totalizer and native encodings.\n");
         printf("s UNKNOWN\n");
       }
       throw MaxSATException(__FILE__, __LINE__, "MSU3 only supports totalizer");
       return _UNKNOWN_;
     }
 
+    // The partitioning finds no partition only when unit propagation on the
+    // hard clauses fails, i.e. the hard clauses are unsatisfiable.
+    if (nPartitions() == 0) {
+      split(community_mode, graph_type);
+      if (nPartitions() == 0) {
+        printAnswer(_UNSATISFIABLE_);
+        return _UNSATISFIABLE_;
+      }
+    }
+
+    // Weighted instances use the OLL relaxation guided by the partitions.
+    if (maxsat_formula->getProblemType() == _WEIGHTED_)
+      return PartMSU3_weighted();
+
     switch (merge_strategy) {
     case _PART_SEQUENTIAL_:
       return PartMSU3_sequential();
@@ -946,6 +1711,9 @@ StatusCode PartMSU3::search() {
       return PartMSU3_sequential();
       break;
     case _PART_BINARY_:
+      // Portfolio workers follow a single solver, so they stay sequential.
+      if (n_threads > 1 && portfolio_worker == NULL)
+        return PartMSU3_parallel();
       return PartMSU3_binary();
       break;
     default:
@@ -974,23 +1742,22 @@ StatusCode PartMSU3::search() {
 
 /*_________________________________________________________________________________________________
   |
-  |  rebuildSolver : [void]  ->  [Solver *]
+  |  rebuildSolver : [void]  ->  [SATBackend *]
   |
   |  Description:
   |
   |    Rebuilds a SAT solver with the current MaxSAT formula.
   |
   |________________________________________________________________________________________________@*/
-Solver *PartMSU3::rebuildSolver() {
-  Solver *S = newSATSolver();
+SATBackend *PartMSU3::rebuildSolver() {
+  SATBackend *S = newSATSolver();
 
   reserveSATVariables(S, maxsat_formula->nVars());
 
   for (int i = 0; i < maxsat_formula->nVars(); i++)
     newSATVariable(S);
 
-  for (int i = 0; i < maxsat_formula->nHard(); i++)
-    S->addClause(getHardClause(i).clause);
+  addHardClauses(S);
 
   vec<Lit> clause;
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
@@ -1106,6 +1873,23 @@ void PartMSU3::print_PartMSU3_configuration() {
            "Resolution");
     break;
   }
+  switch (community_mode) {
+  case RAND_MODE:
+    printf("c |  Communities: %21s                                            "
+           "                       |\n",
+           "Random");
+    break;
+  case UNFOLDING_MODE:
+    printf("c |  Communities: %21s                                            "
+           "                       |\n",
+           "Unfolding");
+    break;
+  case LABEL_PROP_MODE:
+    printf("c |  Communities: %21s                                            "
+           "                       |\n",
+           "Label propagation");
+    break;
+  }
 
   printf("c |  Number of partitions: %12d                                      "
          "                             |\n",
@@ -37,8 +37,10 @@
 #include "../Encoder.h"
 #include "../MaxSAT_Partition.h"
 #include <algorithm>
+#include <atomic>
 #include <deque>
 #include <map>
+#include <mutex>
 #include <set>
 
 namespace openwbo {
@@ -53,12 +55,15 @@ protected:
     int64_t lb;
     Encoder *encoder;
     vec<Lit> *encoding_assumptions;
+    SATBackend *solver; // Only used by the parallel binary algorithm.
 
   public:
     inline TreeNode(TreeNode *parent = NULL)
-        : parent(parent), lb(0), encoder(NULL), encoding_assumptions(NULL) {}
+        : parent(parent), lb(0), encoder(NULL), encoding_assumptions(NULL),
+          solver(NULL) {}
     inline TreeNode(vec<int> &parts, TreeNode *parent = NULL)
-        : parent(parent), lb(0), encoder(NULL), encoding_assumptions(NULL) {
+        : parent(parent), lb(0), encoder(NULL), encoding_assumptions(NULL),
+          solver(NULL) {
       parts.copyTo(this->parts);
     }
 
@@ -73,12 +78,14 @@ protected:
     inline void setEncodingAssumptions(vec<Lit> *assumpts) {
       encoding_assumptions = assumpts;
     }
+    inline void setSolver(SATBackend *S) { solver = S; }
 
     inline vec<int> &getPartitions() { return parts; }
     inline TreeNode *getParent() { return parent; }
     inline int64_t getLowerBound() { return lb; }
     inline Encoder *getEncoder() { return encoder; }
     inline vec<Lit> *getEncodingAssumptions() { return encoding_assumptions; }
+    inline SATBackend *getSolver() { return solver; }
 
     inline bool hasParent() { return parent != NULL; }
     inline bool hasEncoder() { return encoder != NULL; }
@@ -96,6 +103,8 @@ public:
     verbosity = verb;
     merge_strategy = merge;
     graph_type = graph;
+    community_mode = UNFOLDING_MODE;
+    n_threads = 1;
     incremental_strategy = _INCREMENTAL_ITERATIVE_;
     encoding = enc;
   }
@@ -103,6 +112,8 @@ public:
     if (this->solver != NULL) {
       delete this->solver;
     }
+    for (int i = 0; i < core_cardinality.size(); i++)
+      delete core_cardinality[i];
   }
 
   StatusCode search();
@@ -121,9 +132,14 @@ public:
     print_Card_configuration(encoding);
   }
 
+  void setCommunityMode(int mode) { community_mode = mode; }
+
+  // Number of threads used to solve the guide tree (binary strategy only).
+  void setThreads(int n) { n_threads = n > 0 ? n : 1; }
+
   void createGraph() {
     if (nPartitions() == 0) {
-      split(UNFOLDING_MODE, graph_type);
+      split(community_mode, graph_type);
     }
   }
 
@@ -135,12 +151,26 @@ protected:
 
   // Rebuild MaxSAT solver
   //
-  Solver *rebuildSolver(); // Rebuild MaxSAT solver.
+  SATBackend *rebuildSolver(); // Rebuild MaxSAT solver.
 
   StatusCode PartMSU3_sequential(); // MSU3 that merges partitions sequentially into a
                               // single partition
   StatusCode PartMSU3_binary(); // MSU3 that uses a binary tree to guide the partition
                           // merging process
+  StatusCode PartMSU3_parallel(); // Solves independent subtrees of the guide
+                                  // tree concurrently
+  StatusCode PartMSU3_weighted(); // OLL that considers the partitions in the
+                                  // order of the guide tree
+
+  // Weighted algorithm
+  void orderGuideTreeLeaves(deque<TreeNode *> &leaves,
+                            vec<TreeNode *> &out_leaves);
+  void relaxWeightedCore(vec<Lit> &core, uint64_t min_core);
+  void weightLevels(vec<uint64_t> &levels);
+
+  // Parallel binary algorithm
+  StatusCode solveNode(TreeNode *node);
+  void mergeNodes(TreeNode *parent, TreeNode *left, TreeNode *right);
 
   // Heuristics
   mpq_class *computeSparsity();
@@ -152,16 +182,22 @@ protected:
   void dumpGuideTree(vec<TreeNode *> &tree);
   void sortPartitions(vec<int> &out_parts);
 
-  Solver *solver; // SAT Solver used as a black box.
+  SATBackend *solver; // SAT Solver used as a black box.
 
   // Controls the type of graph that will be used in the partitioning algorithm
   int graph_type;
+  int community_mode; // Method used to split the formula (see 'splitMode_').
   // Controls the partition merging strategy used by the algorithm
   int merge_strategy;
   // Controls the incremental strategy used by MSU3 algorithms.
   int incremental_strategy;
   // Controls the cardinality encoding used by MSU3 algorithms.
   int encoding;
+  // Number of threads used by the parallel binary algorithm.
+  int n_threads;
+  std::mutex part_mutex;        // Protects bounds, model and statistics.
+  std::atomic<bool> part_stop;  // Set when the search must stop.
+  std::set<SATBackend *> part_busy; // Solvers currently searching.
 
   // Literals to be used in the constraint that excludes models.
   vec<Lit> objFunction;
@@ -173,6 +209,13 @@ protected:
 
   // Soft clauses that are currently in the MaxSAT formula.
   vec<bool> activeSoft;
+
+  // Weighted algorithm: totalizers built over the cores, the outputs of the
+  // totalizers that are assumed to be false, and the totalizer, bound and
+  // weight of each output (lit -> <<ID, bound>, weight>).
+  vec<Encoder *> core_cardinality;
+  std::set<Lit> core_assumptions;
+  std::map<Lit, std::pair<std::pair<int, uint64_t>, uint64_t>> boundMapping;
 };
 
 } // namespace openwbo
@@ -31,20 +31,25 @@ using namespace openwbo;
 
 /************************************************************************************************
  //
- // Rebuild MaxSAT solver
+ // Update MaxSAT solver
  //
  ************************************************************************************************/
 
 /*_________________________________________________________________________________________________
   |
-  |  rebuildWeightSolver : (strategy : int)  ->  [Solver *]
+  |  updateSolver : (minWeight : uint64_t)  ->  [SATBackend *]
   |
-  |   Description:
+  |  Description:
   |
-  |    Rebuilds a SAT solver with the current MaxSAT formula using a
-  |    weight-based strategy.
-  |    Only soft clauses with weight greater or equal to 'currentWeight' are
-  |    considered in the working MaxSAT formula.
+  |    Updates the SAT solver of the session with the current MaxSAT formula.
+  |    Only soft clauses with weight greater or equal to 'minWeight' are added
+  |    to the working MaxSAT formula. Soft clauses are never removed from the
+  |    working formula: a soft clause whose weight was decreased by a core
+  |    remains in it, which keeps the solver incremental and does not affect
+  |    the correctness of the search.
+  |    Soft clauses that were relaxed since they were added are retired and
+  |    added again with a fresh assumption literal. Soft clauses hardened by
+  |    'hardenSoftClauses' are not assumed.
   |
   |   For further details see:
   |     * Ruben Martins, Vasco Manquinho, Inês Lynce: On Partitioning for
@@ -53,221 +58,116 @@ using namespace openwbo;
   |       Improving SAT-Based Weighted MaxSAT Solvers. CP 2012: 86-101
   |
   |   Pre-conditions:
-  |     * Assumes that 'currentWeight' has been previously updated.
-  |     * Assumes that the weight strategy is either '_WEIGHT_NORMAL_' or
-  |       '_WEIGHT_DIVERSIFY_'.
+  |     * Assumes that 'initAssumptions' has been called.
   |
   |   Post-conditions:
   |     * 'nbCurrentSoft' is updated to the number of soft clauses in the
   |        working MaxSAT formula.
+  |     * 'assumptions' and 'coreMapping' are updated with the assumption
+  |        literals of the soft clauses.
   |
   |________________________________________________________________________________________________@*/
-Solver *WBO::rebuildWeightSolver(int strategy) {
-
-  assert(strategy == _WEIGHT_NORMAL_ || strategy == _WEIGHT_DIVERSIFY_);
-
-  Solver *S = newSATSolver();
-
-  reserveSATVariables(S, maxsat_formula->nVars());
-
-  for (int i = 0; i < maxsat_formula->nVars(); i++)
-    newSATVariable(S);
-
-  for (int i = 0; i < maxsat_formula->nHard(); i++)
-    S->addClause(maxsat_formula->getHardClause(i).clause);
+SATBackend *WBO::updateSolver(uint64_t minWeight) {
 
   if (symmetryStrategy)
     symmetryBreaking();
 
-  vec<Lit> clause;
-  nbCurrentSoft = 0;
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-    if (maxsat_formula->getSoftClause(i).weight >=
-        maxsat_formula->getMaximumWeight()) {
-      nbCurrentSoft++;
-      clause.clear();
-      maxsat_formula->getSoftClause(i).clause.copyTo(clause);
-      for (int j = 0;
-           j < maxsat_formula->getSoftClause(i).relaxation_vars.size(); j++)
-        clause.push(maxsat_formula->getSoftClause(i).relaxation_vars[j]);
-
-      clause.push(maxsat_formula->getSoftClause(i).assumption_var);
-      S->addClause(clause);
+    if (session.isOutdated(maxsat_formula, i)) {
+      session.retireSoft(i);
+      Lit l = maxsat_formula->newLiteral();
+      maxsat_formula->getSoftClause(i).assumption_var = l;
+      coreMapping[l] = i;
     }
   }
 
-  // printf("c #PB: %d\n", maxsat_formula->nPB());
-  for (int i = 0; i < maxsat_formula->nPB(); i++) {
-    Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
-
-    // Make sure the PB is on the form <=
-    if (!maxsat_formula->getPBConstraint(i)->_sign)
-      maxsat_formula->getPBConstraint(i)->changeSign();
-
-    enc->encodePB(S, maxsat_formula->getPBConstraint(i)->_lits,
-                  maxsat_formula->getPBConstraint(i)->_coeffs,
-                  maxsat_formula->getPBConstraint(i)->_rhs);
-
-    // maxsat_formula->getPBConstraint(i)->print();
+  SATBackend *S = updateHardSolver();
+  hardenSoftClauses();
 
-    delete enc;
+  assumptions.clear();
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    if (i < hardenedSoft.size() && hardenedSoft[i])
+      continue;
+    if (!session.isLoaded(i) &&
+        maxsat_formula->getSoftClause(i).weight >= minWeight)
+      session.loadSoft(maxsat_formula, i);
+    assumptions.push(~maxsat_formula->getSoftClause(i).assumption_var);
   }
+  nbCurrentSoft = session.nLoadedSoft();
 
-  // printf("c #Card: %d\n", maxsat_formula->nCard());
-  for (int i = 0; i < maxsat_formula->nCard(); i++) {
-    Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
-
-    if (maxsat_formula->getCardinalityConstraint(i)->_rhs == 1) {
-      enc->encodeAMO(S, maxsat_formula->getCardinalityConstraint(i)->_lits);
-    } else {
-      enc->encodeCardinality(S,
-                             maxsat_formula->getCardinalityConstraint(i)->_lits,
-                             maxsat_formula->getCardinalityConstraint(i)->_rhs);
-    }
-
-    delete enc;
-  }
   return S;
 }
 
 /*_________________________________________________________________________________________________
   |
-  |  rebuildSolver : [void]  ->  [Solver *]
+  |  updateHardSolver : [void]  ->  [SATBackend *]
   |
   |  Description:
   |
-  |    Rebuilds a SAT solver with the current MaxSAT formula using the original
-  |    WBO strategy.
-  |    All soft clauses are considered in the working formula.
-  |
-  |  Pre-conditions:
-  |    * Assumes that the weight strategy is '_WEIGHT_NONE_'.
+  |    Starts the SAT solver of the session if needed and adds the hard
+  |    clauses of the MaxSAT formula that it does not have yet. The first call
+  |    is used for testing if the MaxSAT formula is unsatisfiable.
   |
   |________________________________________________________________________________________________@*/
-Solver *WBO::rebuildSolver() {
-
-  assert(weightStrategy == _WEIGHT_NONE_);
-
-  Solver *S = newSATSolver();
-
-  reserveSATVariables(S, maxsat_formula->nVars());
-
-  for (int i = 0; i < maxsat_formula->nVars(); i++)
-    newSATVariable(S);
-
-  for (int i = 0; i < maxsat_formula->nHard(); i++)
-    S->addClause(maxsat_formula->getHardClause(i).clause);
-
-  if (symmetryStrategy)
-    symmetryBreaking();
-
-  vec<Lit> clause;
-  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-    clause.clear();
-    maxsat_formula->getSoftClause(i).clause.copyTo(clause);
-    for (int j = 0; j < maxsat_formula->getSoftClause(i).relaxation_vars.size();
-         j++)
-      clause.push(maxsat_formula->getSoftClause(i).relaxation_vars[j]);
-    clause.push(maxsat_formula->getSoftClause(i).assumption_var);
-
-    S->addClause(clause);
-  }
-
-  // printf("c #PB: %d\n", maxsat_formula->nPB());
-  for (int i = 0; i < maxsat_formula->nPB(); i++) {
-    Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
-
-    // Make sure the PB is on the form <=
-    if (!maxsat_formula->getPBConstraint(i)->_sign)
-      maxsat_formula->getPBConstraint(i)->changeSign();
-
-    enc->encodePB(S, maxsat_formula->getPBConstraint(i)->_lits,
-                  maxsat_formula->getPBConstraint(i)->_coeffs,
-                  maxsat_formula->getPBConstraint(i)->_rhs);
+SATBackend *WBO::updateHardSolver() {
 
-    // maxsat_formula->getPBConstraint(i)->print();
-
-    delete enc;
+  if (!session.isActive()) {
+    session.start(newSATSolver());
+    reserveSATVariables(session.getSolver(), maxsat_formula->nVars());
   }
 
-  // printf("c #Card: %d\n", maxsat_formula->nCard());
-  for (int i = 0; i < maxsat_formula->nCard(); i++) {
-    Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
-
-    if (maxsat_formula->getCardinalityConstraint(i)->_rhs == 1) {
-      enc->encodeAMO(S, maxsat_formula->getCardinalityConstraint(i)->_lits);
-    } else {
-      enc->encodeCardinality(S,
-                             maxsat_formula->getCardinalityConstraint(i)->_lits,
-                             maxsat_formula->getCardinalityConstraint(i)->_rhs);
-    }
-
-    delete enc;
-  }
-  return S;
+  session.loadHard(maxsat_formula);
+  return session.getSolver();
 }
 
 /*_________________________________________________________________________________________________
   |
-  |  rebuildHardSolver : [void]  ->  [Solver *]
+  |  hardenSoftClauses : [void]  ->  [void]
   |
   |  Description:
   |
-  |    Rebuilds a SAT solver with the hard clauses of the MaxSAT formula.
-  |    Used for testing if the MaxSAT formula is unsatisfiable.
+  |    Hardens the soft clauses whose weight is larger than the gap between
+  |    the upper and the lower bound. Since the relaxation of the cores
+  |    preserves the cost of the formula up to 'lbCost', a solution that
+  |    violates one of them cannot improve on the best model. Loaded soft
+  |    clauses are hardened by asserting the negation of their assumption
+  |    literal and the remaining ones are loaded without it.
+  |
+  |  Pre-conditions:
+  |    * Assumes that the soft clauses that were relaxed since they were
+  |      loaded have been retired.
+  |
+  |  Post-conditions:
+  |    * 'hardenedSoft' is updated.
+  |    * If a clause was hardened, learnt clauses are no longer exported to
+  |      the other portfolio threads.
   |
   |________________________________________________________________________________________________@*/
-Solver *WBO::rebuildHardSolver() {
-
-  Solver *S = newSATSolver();
+void WBO::hardenSoftClauses() {
+  if (model.size() == 0 || lbCost >= ubCost)
+    return;
 
-  reserveSATVariables(S, maxsat_formula->nVars());
+  uint64_t gap = ubCost - lbCost;
+  int hardened = 0;
 
-  for (int i = 0; i < maxsat_formula->nVars(); i++)
-    newSATVariable(S);
-
-  for (int i = 0; i < maxsat_formula->nHard(); i++)
-    S->addClause(maxsat_formula->getHardClause(i).clause);
-
-  // printf("c #PB: %d\n", maxsat_formula->nPB());
-  for (int i = 0; i < maxsat_formula->nPB(); i++) {
-    Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
-
-    // Make sure the PB is on the form <=
-    if (!maxsat_formula->getPBConstraint(i)->_sign)
-      maxsat_formula->getPBConstraint(i)->changeSign();
-
-    enc->encodePB(S, maxsat_formula->getPBConstraint(i)->_lits,
-                  maxsat_formula->getPBConstraint(i)->_coeffs,
-                  maxsat_formula->getPBConstraint(i)->_rhs);
-
-    // maxsat_formula->getPBConstraint(i)->print();
-
-    delete enc;
-  }
-
-  // printf("c #Card: %d\n", maxsat_formula->nCard());
-  for (int i = 0; i < maxsat_formula->nCard(); i++) {
-    Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
-
-    if (maxsat_formula->getCardinalityConstraint(i)->_rhs == 1) {
-      enc->encodeAMO(S, maxsat_formula->getCardinalityConstraint(i)->_lits);
-    } else {
-      enc->encodeCardinality(S,
-                             maxsat_formula->getCardinalityConstraint(i)->_lits,
-                             maxsat_formula->getCardinalityConstraint(i)->_rhs);
-    }
-
-    delete enc;
+  hardenedSoft.growTo(maxsat_formula->nSoft(), false);
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    if (hardenedSoft[i] || maxsat_formula->getSoftClause(i).weight <= gap)
+      continue;
+
+    stopClauseExport();
+    if (session.isLoaded(i))
+      session.getSolver()->addClause(
+          ~maxsat_formula->getSoftClause(i).assumption_var);
+    else
+      session.loadSoft(maxsat_formula, i, false);
+    hardenedSoft[i] = true;
+    hardened++;
   }
 
-  return S;
+  if (verbosity > 0 && hardened > 0)
+    printf("c Hardened %d soft clauses (UB - LB : %" PRIu64 ")\n", hardened,
+           gap);
 }
 
 /*_________________________________________________________________________________________________
@@ -795,7 +695,7 @@ void WBO::symmetryBreaking() {
   |
   |  Post-conditions:
   |   * If the hard clauses are satisfiable then 'ubCost' is updated to the cost
-  |     of the model.
+  |     of the model if it improves it.
   |   * If the working formula is satisfiable, then 'nbSatisfiable' is increased
   |     by 1. Otherwise, 'nbCores' is increased by 1.
   |
@@ -804,7 +704,7 @@ StatusCode WBO::unsatSearch() {
 
   assert(assumptions.size() == 0);
 
-  solver = rebuildHardSolver();
+  solver = updateHardSolver();
   lbool res = searchSATSolver(solver, assumptions);
 
   if (res == l_False) {
@@ -813,15 +713,15 @@ StatusCode WBO::unsatSearch() {
     return _UNSATISFIABLE_;
   } else if (res == l_True) {
     nbSatisfiable++;
-    uint64_t cost = computeCostModel(solver->model);
-    assert(cost <= ubCost);
-    ubCost = cost;
-    saveModel(solver->model);
-    printBound(ubCost);
+    uint64_t cost = computeCostModel(solver->model());
+    // 'ubCost' may already come from a model of the local search.
+    if (model.size() == 0 || cost < ubCost) {
+      ubCost = cost;
+      saveModel(solver->model());
+      printBound(ubCost);
+    }
   }
 
-  delete solver;
-  solver = NULL;
   return _SATISFIABLE_;
 }
 
@@ -859,7 +759,7 @@ StatusCode WBO::weightSearch() {
 
   initAssumptions(assumptions);
   updateCurrentWeight(weightStrategy);
-  solver = rebuildWeightSolver(weightStrategy);
+  solver = updateSolver(maxsat_formula->getMaximumWeight());
 
   for (;;) {
 
@@ -867,36 +767,36 @@ StatusCode WBO::weightSearch() {
 
     if (res == l_False) {
       nbCores++;
-      assert(solver->conflict.size() > 0);
-      uint64_t coreCost = computeCostCore(solver->conflict);
+      assert(solver->conflict().size() > 0);
+      core_minimizer.reduce(solver);
+      uint64_t coreCost = computeCostCore(solver->conflict());
       lbCost += coreCost;
       if (verbosity > 0)
         printf("c LB : %-12" PRIu64 " CS : %-12d W  : %-12" PRIu64 "\n", lbCost,
-               solver->conflict.size(), coreCost);
-      relaxCore(solver->conflict, coreCost, assumptions);
-      delete solver;
-      solver = rebuildWeightSolver(weightStrategy);
+               solver->conflict().size(), coreCost);
+      relaxCore(solver->conflict(), coreCost, assumptions);
+      solver = updateSolver(maxsat_formula->getMaximumWeight());
     }
 
     if (res == l_True) {
       nbSatisfiable++;
       if (nbCurrentSoft == maxsat_formula->nSoft()) {
-        assert(computeCostModel(solver->model) == lbCost);
+        assert(computeCostModel(solver->model()) == lbCost);
         if (lbCost == ubCost && verbosity > 0)
           printf("c LB = UB\n");
         if (lbCost < ubCost) {
           ubCost = lbCost;
-          saveModel(solver->model);
+          saveModel(solver->model());
           printBound(lbCost);
         }
         printAnswer(_OPTIMUM_);
         return _OPTIMUM_;
       } else {
         updateCurrentWeight(weightStrategy);
-        uint64_t cost = computeCostModel(solver->model);
+        uint64_t cost = computeCostModel(solver->model());
         if (cost < ubCost) {
           ubCost = cost;
-          saveModel(solver->model);
+          saveModel(solver->model());
           printBound(ubCost);
         }
 
@@ -907,8 +807,7 @@ StatusCode WBO::weightSearch() {
           return _OPTIMUM_;
         }
 
-        delete solver;
-        solver = rebuildWeightSolver(weightStrategy);
+        solver = updateSolver(maxsat_formula->getMaximumWeight());
       }
     }
   }
@@ -938,7 +837,7 @@ StatusCode WBO::normalSearch() {
   unsatSearch();
 
   initAssumptions(assumptions);
-  solver = rebuildSolver();
+  solver = updateSolver();
 
   for (;;) {
 
@@ -946,12 +845,13 @@ StatusCode WBO::normalSearch() {
 
     if (res == l_False) {
       nbCores++;
-      assert(solver->conflict.size() > 0);
-      uint64_t coreCost = computeCostCore(solver->conflict);
+      assert(solver->conflict().size() > 0);
+      core_minimizer.reduce(solver);
+      uint64_t coreCost = computeCostCore(solver->conflict());
       lbCost += coreCost;
       if (verbosity > 0)
         printf("c LB : %-12" PRIu64 " CS : %-12d W  : %-12" PRIu64 "\n", lbCost,
-               solver->conflict.size(), coreCost);
+               solver->conflict().size(), coreCost);
 
       if (lbCost == ubCost) {
         if (verbosity > 0)
@@ -960,17 +860,16 @@ StatusCode WBO::normalSearch() {
         return _OPTIMUM_;
       }
 
-      relaxCore(solver->conflict, coreCost, assumptions);
-      delete solver;
-      solver = rebuildSolver();
+      relaxCore(solver->conflict(), coreCost, assumptions);
+      solver = updateSolver();
     }
 
     if (res == l_True) {
       nbSatisfiable++;
-      ubCost = computeCostModel(solver->model);
+      ubCost = computeCostModel(solver->model());
       assert(lbCost == ubCost);
       printBound(lbCost);
-      saveModel(solver->model);
+      saveModel(solver->model());
       printAnswer(_OPTIMUM_);
       return _OPTIMUM_;
     }
@@ -60,20 +60,18 @@ public:
     symmetryBreakingLimit = limit;
   }
 
-  ~WBO() {
-    if (solver != NULL)
-      delete solver;
-  }
+  ~WBO() {}
 
   StatusCode search(); // WBO search.
 
 protected:
-  // Rebuild MaxSAT solver
+  // Update MaxSAT solver
   //
-  // Rebuild MaxSAT solver with weight-based strategy.
-  Solver *rebuildWeightSolver(int strategy);
-  Solver *rebuildSolver();     // Rebuild MaxSAT solver.
-  Solver *rebuildHardSolver(); // Rebuild MaxSAT solver with only hard clauses.
+  // Update MaxSAT solver with the soft clauses of weight at least 'minWeight'.
+  SATBackend *updateSolver(uint64_t minWeight = 0);
+  SATBackend *updateHardSolver(); // Update MaxSAT solver with the hard clauses.
+  // Hardens the soft clauses whose weight exceeds the gap between bounds.
+  void hardenSoftClauses();
   void updateCurrentWeight(int strategy); // Updates 'currentWeight'.
   uint64_t
   findNextWeight(uint64_t weight); // Finds the next weight for 'currentWeight'.
@@ -106,7 +104,7 @@ protected:
   void initAssumptions(vec<Lit> &assumps);
 
   // SAT solver
-  Solver *solver;  // SAT solver used as a black box.
+  SATBackend *solver;  // SAT solver used as a black box (owned by 'session').
   Encoder encoder; // Interface for the encoder of constraints to CNF.
 
   // Variables used  in 'weightSearch'
@@ -121,6 +119,7 @@ protected:
                                   // of the soft clause.
   vec<Lit> assumptions; // Stores the assumptions to be used in the extraction
                         // of the core.
+  vec<bool> hardenedSoft; // Soft clauses that are no longer assumed.
 
   // Symmetry breaking
   //
@@ -32,7 +32,7 @@
 
 using namespace openwbo;
 
-void Adder::FA_extra ( Solver *S, Lit xc, Lit xs, Lit a, Lit b, Lit c )
+void Adder::FA_extra ( SATBackend *S, Lit xc, Lit xs, Lit a, Lit b, Lit c )
 {
   
   clause.clear();
@@ -46,7 +46,7 @@ void Adder::FA_extra ( Solver *S, Lit xc, Lit xs, Lit a, Lit b, Lit c )
 }
 
 
-Lit Adder::FA_carry ( Solver *S, Lit a, Lit b, Lit c ) {
+Lit Adder::FA_carry ( SATBackend *S, Lit a, Lit b, Lit c ) {
   
   Lit x = mkLit(S->newVar(), false);
 
@@ -61,7 +61,7 @@ Lit Adder::FA_carry ( Solver *S, Lit a, Lit b, Lit c ) {
   return x;
 }
 
-Lit Adder::FA_sum ( Solver *S, Lit a, Lit b, Lit c )
+Lit Adder::FA_sum ( SATBackend *S, Lit a, Lit b, Lit c )
 {
     Lit x = mkLit(S->newVar(), false);
 
@@ -78,7 +78,7 @@ Lit Adder::FA_sum ( Solver *S, Lit a, Lit b, Lit c )
     return x;
 }
 
-Lit Adder::HA_carry ( Solver *S, Lit a, Lit b) // a AND b
+Lit Adder::HA_carry ( SATBackend *S, Lit a, Lit b) // a AND b
 {  
   Lit x = mkLit(S->newVar(), false);
 
@@ -89,7 +89,7 @@ Lit Adder::HA_carry ( Solver *S, Lit a, Lit b) // a AND b
   return x;
 }
 
-Lit Adder::HA_sum ( Solver *S, Lit a, Lit b ) // a XOR b
+Lit Adder::HA_sum ( SATBackend *S, Lit a, Lit b ) // a XOR b
 {
   Lit x = mkLit(S->newVar(), false);
 
@@ -103,7 +103,7 @@ Lit Adder::HA_sum ( Solver *S, Lit a, Lit b ) // a XOR b
 }
 
 
-void Adder::adderTree (Solver *S, std::vector< std::queue< Lit > > & buckets, vec< Lit >& result ) {
+void Adder::adderTree (SATBackend *S, std::vector< std::queue< Lit > > & buckets, vec< Lit >& result ) {
   Lit x,y,z;
   Lit u = lit_Undef;
 
@@ -149,7 +149,7 @@ void Adder::adderTree (Solver *S, std::vector< std::queue< Lit > > & buckets, ve
   // Generates clauses for “xs <= ys”, assuming ys has only constant signals (0 or 1).
 // xs and ys must have the same size
 
-void Adder::lessThanOrEqual (Solver *S, vec< Lit > & xs, std::vector< uint64_t > & ys) {
+void Adder::lessThanOrEqual (SATBackend *S, vec< Lit > & xs, std::vector< uint64_t > & ys) {
   assert ( xs.size() == ys.size() );
   vec<Lit> clause;
   bool skip;
@@ -195,7 +195,7 @@ void Adder::lessThanOrEqual (Solver *S, vec< Lit > & xs, std::vector< uint64_t >
 
 }
 
-void Adder::lessThanOrEqualInc (Solver *S, vec< Lit > & xs, std::vector< uint64_t > & ys, vec<Lit>& assumptions) {
+void Adder::lessThanOrEqualInc (SATBackend *S, vec< Lit > & xs, std::vector< uint64_t > & ys, vec<Lit>& assumptions) {
   assert ( xs.size() == ys.size() );
   vec<Lit> clause;
   bool skip;
@@ -262,7 +262,7 @@ void Adder::numToBits ( std::vector<uint64_t> & bits, uint64_t n, uint64_t numbe
   reverse ( bits.begin(), bits.end() );
 }
 
-void Adder::encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs){
+void Adder::encode(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs){
 
     _output.clear();
 
@@ -288,7 +288,7 @@ void Adder::encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rh
     hasEncoding = true;
 }
 
-void Adder::encodeInc(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs, vec<Lit> &assumptions){
+void Adder::encodeInc(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs, vec<Lit> &assumptions){
     _output.clear();
 
     uint64_t nb = ld64(rhs); // number of bits
@@ -313,14 +313,14 @@ void Adder::encodeInc(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t
 
 }
 
-void Adder::updateInc(Solver *S, uint64_t rhs, vec<Lit>& assumptions){
+void Adder::updateInc(SATBackend *S, uint64_t rhs, vec<Lit>& assumptions){
       
       std::vector<uint64_t> kBits;
       numToBits (kBits, _buckets.size(), rhs );
       lessThanOrEqualInc (S, _output, kBits, assumptions);
 }
 
-void Adder::update(Solver *S, uint64_t rhs){
+void Adder::update(SATBackend *S, uint64_t rhs){
       
       std::vector<uint64_t> kBits;
       numToBits (kBits, _buckets.size(), rhs );
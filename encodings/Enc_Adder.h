@@ -52,16 +52,16 @@ public:
   ~Adder() {}
 
   // Encode constraint.
-  void encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs);
+  void encode(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs);
 
   // Update constraint.
-  void update(Solver *S, uint64_t rhs);
+  void update(SATBackend *S, uint64_t rhs);
 
   // Returns true if the encoding was built, otherwise returns false;
   bool hasCreatedEncoding() { return hasEncoding; }
 
-  void encodeInc(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs, vec<Lit> &assumptions);
-  void updateInc(Solver *S, uint64_t rhs, vec<Lit>& assumptions);
+  void encodeInc(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs, vec<Lit> &assumptions);
+  void updateInc(SATBackend *S, uint64_t rhs, vec<Lit>& assumptions);
 
 
 protected:
@@ -70,17 +70,17 @@ protected:
   vec<Lit> clause;
   std::vector<std::queue<Lit> > _buckets;
 
-  void FA_extra ( Solver *S, Lit xc, Lit xs, Lit a, Lit b, Lit c );
-  Lit FA_carry ( Solver *S, Lit a, Lit b, Lit c );
-  Lit FA_sum ( Solver *S, Lit a, Lit b, Lit c );
-  Lit HA_carry ( Solver *S, Lit a, Lit b);
-  Lit HA_sum ( Solver *S, Lit a, Lit b );
-  void adderTree (Solver *S, std::vector< std::queue< Lit > > & buckets, vec< Lit >& result );
-  void lessThanOrEqual (Solver *S, vec< Lit > & xs, std::vector< uint64_t > & ys);
+  void FA_extra ( SATBackend *S, Lit xc, Lit xs, Lit a, Lit b, Lit c );
+  Lit FA_carry ( SATBackend *S, Lit a, Lit b, Lit c );
+  Lit FA_sum ( SATBackend *S, Lit a, Lit b, Lit c );
+  Lit HA_carry ( SATBackend *S, Lit a, Lit b);
+  Lit HA_sum ( SATBackend *S, Lit a, Lit b );
+  void adderTree (SATBackend *S, std::vector< std::queue< Lit > > & buckets, vec< Lit >& result );
+  void lessThanOrEqual (SATBackend *S, vec< Lit > & xs, std::vector< uint64_t > & ys);
   void numToBits ( std::vector<uint64_t> & bits, uint64_t n, uint64_t number );
   uint64_t ld64(const uint64_t x);
 
-  void lessThanOrEqualInc (Solver *S, vec< Lit > & xs, std::vector< uint64_t > & ys, vec<Lit>& assumptions);
+  void lessThanOrEqualInc (SATBackend *S, vec< Lit > & xs, std::vector< uint64_t > & ys, vec<Lit>& assumptions);
 
 
 	#define wbsplit(half,wL,wR, ws,bs, wsL,bsL, wsR,bsR) \
@@ -99,21 +99,21 @@ protected:
   }
 
 	void genWarnersFull(Lit& a, Lit& b, Lit& c, Lit& carry, Lit& sum, int comp,
-		       Solver* S, vec<Lit>& lits);
+		       SATBackend *S, vec<Lit>& lits);
 
 	void genWarnersHalf(Lit& a, Lit& b, Lit& carry, Lit& sum, int comp,
-		       Solver* S, vec<Lit>& lits);
+		       SATBackend *S, vec<Lit>& lits);
 
 	void genWarners(vec<uint64_t>& weights, vec<Lit>& blockings,
 		uint64_t max, int k,
-		int comp, Solver* S, const Lit zero,
+		int comp, SATBackend *S, const Lit zero,
 		vec<Lit>& lits, vec<Lit>& linkingVar);
 
 	void genWarners0(vec<uint64_t>& weights, vec<Lit>& blockings,
-		 uint64_t max,uint64_t k, int comp, Solver *S,
+		 uint64_t max,uint64_t k, int comp, SATBackend *S,
 		  vec<Lit>& lits, vec<Lit>& linkingVar);
 
-	void lessthan(vec<Lit>& linking, uint64_t k, vec<uint64_t>& cc, Solver* S, vec<Lit>& lits);
+	void lessthan(vec<Lit>& linking, uint64_t k, vec<uint64_t>& cc, SATBackend *S, vec<Lit>& lits);
 
 	vec<uint64_t> cc;
 	vec<Lit> linkingVar;
@@ -128,7 +128,7 @@ protected:
 }
 
 // koshi 20140121
-void wbFilter(uint64_t UB, Solver* S,vec<Lit>& lits,
+void wbFilter(uint64_t UB, SATBackend *S,vec<Lit>& lits,
 	      vec<uint64_t>& weights, vec<Lit>& blockings,
 	      vec<uint64_t>& sweights, vec<Lit>& sblockings) {
   sweights.clear(); sblockings.clear();
@@ -31,7 +31,7 @@ using namespace openwbo;
 
 /*_________________________________________________________________________________________________
   |
-  |  encode : (S : Solver *) (lits : vec<Lit>&) (rhs : int64_t) ->  [void]
+  |  encode : (S : SATBackend *) (lits : vec<Lit>&) (rhs : int64_t) ->  [void]
   |
   |  Description:
   |
@@ -55,7 +55,7 @@ using namespace openwbo;
   |    * 'S' is updated with the clauses that encode the cardinality constraint.
   |
   |________________________________________________________________________________________________@*/
-void CNetworks::encode(Solver *S, vec<Lit> &lits, int64_t rhs) {
+void CNetworks::encode(SATBackend *S, vec<Lit> &lits, int64_t rhs) {
 
   assert(rhs >= 0);
   assert(lits.size() > 0);
@@ -107,7 +107,7 @@ void CNetworks::encode(Solver *S, vec<Lit> &lits, int64_t rhs) {
 
 /*_________________________________________________________________________________________________
   |
-  |  update : (S : Solver *) (rhs : int64_t) ->  [void]
+  |  update : (S : SATBackend *) (rhs : int64_t) ->  [void]
   |
   |  Description:
   |
@@ -132,7 +132,7 @@ void CNetworks::encode(Solver *S, vec<Lit> &lits, int64_t rhs) {
   |    * 'current_cardinality_rhs' is updated.
   |
   |________________________________________________________________________________________________@*/
-void CNetworks::update(Solver *S, int64_t rhs) {
+void CNetworks::update(SATBackend *S, int64_t rhs) {
 
   assert(current_cardinality_rhs != -1);
   assert(cardinality_outlits.size() != 0 && rhs < cardinality_outlits.size());
@@ -149,7 +149,7 @@ void CNetworks::update(Solver *S, int64_t rhs) {
 //
 ************************************************************************************************/
 
-void CNetworks::CN_hmerge(Solver *S, vec<Lit> &a_s, vec<Lit> &b_s,
+void CNetworks::CN_hmerge(SATBackend *S, vec<Lit> &a_s, vec<Lit> &b_s,
                           vec<Lit> &c_s) {
 
   assert(a_s.size() == b_s.size());
@@ -212,7 +212,7 @@ void CNetworks::CN_hmerge(Solver *S, vec<Lit> &a_s, vec<Lit> &b_s,
   }
 }
 
-void CNetworks::CN_hsort(Solver *S, vec<Lit> &a_s, vec<Lit> &c_s) {
+void CNetworks::CN_hsort(SATBackend *S, vec<Lit> &a_s, vec<Lit> &c_s) {
   assert(a_s.size() == c_s.size());
 
   if (a_s.size() == 2) {
@@ -246,7 +246,7 @@ void CNetworks::CN_hsort(Solver *S, vec<Lit> &a_s, vec<Lit> &c_s) {
   }
 }
 
-void CNetworks::CN_smerge(Solver *S, vec<Lit> &a_s, vec<Lit> &b_s,
+void CNetworks::CN_smerge(SATBackend *S, vec<Lit> &a_s, vec<Lit> &b_s,
                           vec<Lit> &c_s) {
 
   assert(a_s.size() == b_s.size());
@@ -307,7 +307,7 @@ void CNetworks::CN_smerge(Solver *S, vec<Lit> &a_s, vec<Lit> &b_s,
   }
 }
 
-void CNetworks::CN_encode(Solver *S, vec<Lit> &a_s, vec<Lit> &c_s,
+void CNetworks::CN_encode(SATBackend *S, vec<Lit> &a_s, vec<Lit> &c_s,
                           int64_t rhs) {
   assert(a_s.size() % rhs == 0);
   assert(c_s.size() == rhs);
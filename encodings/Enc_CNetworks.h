@@ -41,18 +41,18 @@ public:
   }
   ~CNetworks() {}
 
-  void encode(Solver *S, vec<Lit> &lits, int64_t rhs);
-  void update(Solver *S, int64_t rhs);
+  void encode(SATBackend *S, vec<Lit> &lits, int64_t rhs);
+  void update(SATBackend *S, int64_t rhs);
 
   bool hasCreatedEncoding() { return hasEncoding; }
 
 protected:
   // Auxiliary methods for the cardinality network encoding:
   //
-  void CN_hmerge(Solver *S, vec<Lit> &a_s, vec<Lit> &b_s, vec<Lit> &c_s);
-  void CN_hsort(Solver *S, vec<Lit> &a_s, vec<Lit> &c_s);
-  void CN_smerge(Solver *S, vec<Lit> &a_s, vec<Lit> &b_s, vec<Lit> &c_s);
-  void CN_encode(Solver *S, vec<Lit> &a_s, vec<Lit> &c_s, int64_t rhs);
+  void CN_hmerge(SATBackend *S, vec<Lit> &a_s, vec<Lit> &b_s, vec<Lit> &c_s);
+  void CN_hsort(SATBackend *S, vec<Lit> &a_s, vec<Lit> &c_s);
+  void CN_smerge(SATBackend *S, vec<Lit> &a_s, vec<Lit> &b_s, vec<Lit> &c_s);
+  void CN_encode(SATBackend *S, vec<Lit> &a_s, vec<Lit> &c_s, int64_t rhs);
 
   // Stores the current value of the rhs of the cardinality constraint.
   int64_t current_cardinality_rhs;
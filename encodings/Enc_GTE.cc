@@ -36,14 +36,14 @@ struct less_than_wlitt {
   }
 };
 
-Lit GTE::getNewLit(Solver *S) {
+Lit GTE::getNewLit(SATBackend *S) {
   Lit p = mkLit(S->nVars(), false);
   newSATVariable(S);
   nb_variables++;
   return p;
 }
 
-Lit GTE::get_var(Solver *S, wlit_mapt &oliterals, uint64_t weight) {
+Lit GTE::get_var(SATBackend *S, wlit_mapt &oliterals, uint64_t weight) {
   wlit_mapt::iterator it = oliterals.find(weight);
   if (it == oliterals.end()) {
     Lit v = getNewLit(S);
@@ -52,7 +52,7 @@ Lit GTE::get_var(Solver *S, wlit_mapt &oliterals, uint64_t weight) {
   return oliterals[weight];
 }
 
-bool GTE::encodeLeq(uint64_t k, Solver *S, const weightedlitst &iliterals,
+bool GTE::encodeLeq(uint64_t k, SATBackend *S, const weightedlitst &iliterals,
                     wlit_mapt &oliterals) {
 
   if (iliterals.size() == 0 || k == 0)
@@ -165,7 +165,7 @@ bool GTE::encodeLeq(uint64_t k, Solver *S, const weightedlitst &iliterals,
   return true;
 }
 
-void GTE::encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+void GTE::encode(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
                  uint64_t rhs) {
   // FIXME: do not change coeffs in this method. Make coeffs const.
 
@@ -255,7 +255,7 @@ void GTE::encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
   hasEncoding = true;
 }
 
-void GTE::update(Solver *S, uint64_t rhs) {
+void GTE::update(SATBackend *S, uint64_t rhs) {
 
   assert(hasEncoding);
   for (wlit_mapt::reverse_iterator rit = pb_oliterals.rbegin();
@@ -273,10 +273,58 @@ void GTE::update(Solver *S, uint64_t rhs) {
   current_pb_rhs = rhs;
 }
 
+void GTE::encodeOutputs(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+                        uint64_t max) {
+  if (max >= UINT64_MAX - 1) {
+    printf("c Overflow in the Encoding\n");
+    printf("s UNKNOWN\n");
+    exit(_ERROR_);
+  }
+
+  hasEncoding = false;
+  nb_variables = 0;
+  nb_clauses = 0;
+  pb_oliterals.clear();
+
+  weightedlitst iliterals;
+  for (int i = 0; i < lits.size(); i++) {
+    if (coeffs[i] == 0)
+      continue;
+    wlitt wl;
+    wl.lit = lits[i];
+    wl.weight = coeffs[i];
+    iliterals.push_back(wl);
+  }
+  less_than_wlitt lt_wlit;
+  std::sort(iliterals.begin(), iliterals.end(), lt_wlit);
+  encodeLeq(max + 1, S, iliterals, pb_oliterals);
+
+  // Each output implies the outputs of the smaller sums, so the sum is at
+  // most 'k' if the output returned by 'outputAbove(k)' is false.
+  Lit smaller = lit_Undef;
+  for (wlit_mapt::iterator it = pb_oliterals.begin(); it != pb_oliterals.end();
+       it++) {
+    if (smaller != lit_Undef) {
+      addBinaryClause(S, ~it->second, smaller);
+      nb_clauses++;
+    }
+    smaller = it->second;
+  }
+
+  current_pb_rhs = max;
+  hasEncoding = true;
+}
+
+Lit GTE::outputAbove(uint64_t k) {
+  assert(hasEncoding);
+  wlit_mapt::iterator it = pb_oliterals.upper_bound(k);
+  return it == pb_oliterals.end() ? lit_Undef : it->second;
+}
+
 // TODO: refactor the code to reduce duplication for the predict methods
 
 // predict number of variables and clauses that this encode will generate
-Lit GTE::get_var_predict(Solver *S, wlit_mapt &oliterals, uint64_t weight) {
+Lit GTE::get_var_predict(SATBackend *S, wlit_mapt &oliterals, uint64_t weight) {
   wlit_mapt::iterator it = oliterals.find(weight);
   if (it == oliterals.end()) {
     Lit v = mkLit(nb_current_variables, false);
@@ -286,7 +334,7 @@ Lit GTE::get_var_predict(Solver *S, wlit_mapt &oliterals, uint64_t weight) {
   return oliterals[weight];
 }
 
-bool GTE::predictEncodeLeq(uint64_t k, Solver *S, const weightedlitst &iliterals,
+bool GTE::predictEncodeLeq(uint64_t k, SATBackend *S, const weightedlitst &iliterals,
                     wlit_mapt &oliterals) {
 
 
@@ -393,7 +441,7 @@ bool GTE::predictEncodeLeq(uint64_t k, Solver *S, const weightedlitst &iliterals
   return true;
 }
 
-int GTE::predict(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+int GTE::predict(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
                  uint64_t rhs) {
 
   vec<Lit> simp_lits;
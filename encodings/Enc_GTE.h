@@ -73,27 +73,38 @@ public:
   ~GTE() {}
 
   // Encode constraint.
-  void encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs);
+  void encode(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+              uint64_t rhs);
 
   // Update constraint.
-  void update(Solver *S, uint64_t rhs);
+  void update(SATBackend *S, uint64_t rhs);
+
+  // Encode the outputs of 'sum(coeffs * lits)' without bounding it. The sums
+  // larger than 'max' share one output.
+  void encodeOutputs(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+                     uint64_t max);
+
+  // Returns the output that is true if the sum encoded by 'encodeOutputs' is
+  // larger than 'k', or lit_Undef if the sum cannot be larger than 'k'.
+  Lit outputAbove(uint64_t k);
 
   // Returns true if the encoding was built, otherwise returns false;
   bool hasCreatedEncoding() { return hasEncoding; }
 
   // Predicts the number of auxiliary clauses for the GTE encoding
-  int predict(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs);
+  int predict(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+              uint64_t rhs);
 
 protected:
   void printLit(Lit l) { printf("%s%d\n", sign(l) ? "-" : "", var(l) + 1); }
 
-  bool encodeLeq(uint64_t k, Solver *S, const weightedlitst &iliterals,
+  bool encodeLeq(uint64_t k, SATBackend *S, const weightedlitst &iliterals,
                  wlit_mapt &oliterals);
-  Lit getNewLit(Solver *S);
-  Lit get_var(Solver *S, wlit_mapt &oliterals, uint64_t weight);
-  bool predictEncodeLeq(uint64_t k, Solver *S, const weightedlitst &iliterals,
-                        wlit_mapt &oliterals);
-  Lit get_var_predict(Solver *S, wlit_mapt &oliterals, uint64_t weight);
+  Lit getNewLit(SATBackend *S);
+  Lit get_var(SATBackend *S, wlit_mapt &oliterals, uint64_t weight);
+  bool predictEncodeLeq(uint64_t k, SATBackend *S,
+                        const weightedlitst &iliterals, wlit_mapt &oliterals);
+  Lit get_var_predict(SATBackend *S, wlit_mapt &oliterals, uint64_t weight);
 
   vec<Lit> pb_outlits; // Stores the outputs of the pseudo-Boolean constraint
                        // encoding for incremental solving.
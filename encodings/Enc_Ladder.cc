@@ -31,7 +31,7 @@ using namespace openwbo;
 
 /*_________________________________________________________________________________________________
   |
-  |  encode : (S : Solver *) (lits : vec<Lit>&)  ->  [void]
+  |  encode : (S : SATBackend *) (lits : vec<Lit>&)  ->  [void]
   |
   |  Description:
   |
@@ -52,7 +52,7 @@ using namespace openwbo;
   |    * 'S' is updated with the clauses that encode the AMO constraint.
   |
   |________________________________________________________________________________________________@*/
-void Ladder::encode(Solver *S, vec<Lit> &lits) {
+void Ladder::encode(SATBackend *S, vec<Lit> &lits) {
 
   assert(lits.size() != 0);
 
@@ -45,7 +45,7 @@ public:
   Ladder() {}
   ~Ladder() {}
 
-  void encode(Solver *S, vec<Lit> &lits);
+  void encode(SATBackend *S, vec<Lit> &lits);
 };
 } // namespace openwbo
 
@@ -31,7 +31,7 @@ using namespace openwbo;
 
 /*_________________________________________________________________________________________________
   |
-  |  encode : (S : Solver *) (lits : vec<Lit>&) (rhs : int64_t) ->  [void]
+  |  encode : (S : SATBackend *) (lits : vec<Lit>&) (rhs : int64_t) ->  [void]
   |
   |  Description:
   |
@@ -53,7 +53,7 @@ using namespace openwbo;
   |    * 'S' is updated with the clauses that encode the cardinality constraint.
   |
   |________________________________________________________________________________________________@*/
-void MTotalizer::encode(Solver *S, vec<Lit> &lits, int64_t rhs) {
+void MTotalizer::encode(SATBackend *S, vec<Lit> &lits, int64_t rhs) {
   assert(lits.size() > 0);
   hasEncoding = false;
 
@@ -110,7 +110,7 @@ void MTotalizer::encode(Solver *S, vec<Lit> &lits, int64_t rhs) {
 
 /*_________________________________________________________________________________________________
   |
-  |  update : (S : Solver *) (rhs : int64_t) ->  [void]
+  |  update : (S : SATBackend *) (rhs : int64_t) ->  [void]
   |
   |  Description:
   |
@@ -136,7 +136,7 @@ void MTotalizer::encode(Solver *S, vec<Lit> &lits, int64_t rhs) {
   |    * 'current_cardinality_rhs' is updated.
   |
   |________________________________________________________________________________________________@*/
-void MTotalizer::update(Solver *S, int64_t rhs) {
+void MTotalizer::update(SATBackend *S, int64_t rhs) {
   assert(current_cardinality_rhs != -1);
   assert(hasEncoding);
   encode_output(S, rhs);
@@ -149,7 +149,7 @@ void MTotalizer::update(Solver *S, int64_t rhs) {
 //
 ************************************************************************************************/
 
-void MTotalizer::encode_output(Solver *S, int64_t rhs) {
+void MTotalizer::encode_output(SATBackend *S, int64_t rhs) {
 
   assert(hasEncoding);
   assert(cardinality_upoutlits.size() != 0 ||
@@ -181,7 +181,7 @@ void MTotalizer::encode_output(Solver *S, int64_t rhs) {
   }
 }
 
-void MTotalizer::toCNF(Solver *S, int mod, vec<Lit> &ublits, vec<Lit> &lwlits,
+void MTotalizer::toCNF(SATBackend *S, int mod, vec<Lit> &ublits, vec<Lit> &lwlits,
                        int64_t rhs) {
 
   vec<Lit> lupper;
@@ -256,7 +256,7 @@ void MTotalizer::toCNF(Solver *S, int mod, vec<Lit> &ublits, vec<Lit> &lwlits,
     toCNF(S, mod, rupper, rlower, right * mod + (rhs - split) - right * mod);
 }
 
-void MTotalizer::adder(Solver *S, int mod, vec<Lit> &upper, vec<Lit> &lower,
+void MTotalizer::adder(SATBackend *S, int mod, vec<Lit> &upper, vec<Lit> &lower,
                        vec<Lit> &lupper, vec<Lit> &llower, vec<Lit> &rupper,
                        vec<Lit> &rlower) {
 
@@ -49,8 +49,8 @@ public:
   }
   ~MTotalizer() {}
 
-  void encode(Solver *S, vec<Lit> &lits, int64_t rhs);
-  void update(Solver *S, int64_t rhs);
+  void encode(SATBackend *S, vec<Lit> &lits, int64_t rhs);
+  void update(SATBackend *S, int64_t rhs);
   void setModulo(int m) { modulo = m; }
 
   int getModulo() { return modulo; }
@@ -59,12 +59,12 @@ public:
 protected:
   // Auxiliary methods for the cardinality encoding:
   //
-  void toCNF(Solver *S, int mod, vec<Lit> &ublits, vec<Lit> &lwlits,
+  void toCNF(SATBackend *S, int mod, vec<Lit> &ublits, vec<Lit> &lwlits,
              int64_t rhs);
-  void adder(Solver *S, int mod, vec<Lit> &upper, vec<Lit> &lower,
+  void adder(SATBackend *S, int mod, vec<Lit> &upper, vec<Lit> &lower,
              vec<Lit> &lupper, vec<Lit> &llower, vec<Lit> &rupper,
              vec<Lit> &rlower);
-  void encode_output(Solver *S, int64_t rhs);
+  void encode_output(SATBackend *S, int64_t rhs);
 
   Lit h0;     // Temporary literal for the construction of the encoding.
   int modulo; // Stores the modulo value for the encoding.
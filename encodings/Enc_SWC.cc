@@ -31,7 +31,7 @@ using namespace openwbo;
 
 /*_________________________________________________________________________________________________
   |
-  |  encode : (S : Solver *) (lits : vec<Lit>&) (rhs : int64_t) ->  [void]
+  |  encode : (S : SATBackend *) (lits : vec<Lit>&) (rhs : int64_t) ->  [void]
   |
   |  Description:
   |
@@ -52,7 +52,7 @@ using namespace openwbo;
   |      constraint.
   |
   |________________________________________________________________________________________________@*/
-void SWC::encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+void SWC::encode(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
                  uint64_t rhs) {
   // FIXME: do not change coeffs in this method. Make coeffs const.
 
@@ -157,7 +157,7 @@ void SWC::encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
 
 /*_________________________________________________________________________________________________
   |
-  |  encode : (S : Solver *) (lits : vec<Lit>&) (rhs : int64_t)
+  |  encode : (S : SATBackend *) (lits : vec<Lit>&) (rhs : int64_t)
   |           (assumptions: vec<Lit>&) (size: int) ->  [void]
   |
   |  Description:
@@ -177,7 +177,7 @@ void SWC::encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
   |    * 'assumptions' is updated with a new set of assumptions.
   |
   |________________________________________________________________________________________________@*/
-void SWC::encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs,
+void SWC::encode(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs,
                  vec<Lit> &assumptions, int size) {
 
   // If the rhs is larger than INT32_MAX is not feasible to encode this
@@ -312,7 +312,7 @@ void SWC::encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs,
 
 /*_________________________________________________________________________________________________
   |
-  |  update : (S : Solver *) (rhs : int64_t) ->  [void]
+  |  update : (S : SATBackend *) (rhs : int64_t) ->  [void]
   |
   |  Description:
   |
@@ -330,7 +330,7 @@ void SWC::encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs,
   |      pseudo-Boolean encoding.
   |
   |________________________________________________________________________________________________@*/
-void SWC::update(Solver *S, uint64_t rhs) {
+void SWC::update(SATBackend *S, uint64_t rhs) {
   if (rhs >= INT32_MAX) {
     printf("c Overflow in the Encoding\n");
     printf("s UNKNOWN\n");
@@ -346,7 +346,7 @@ void SWC::update(Solver *S, uint64_t rhs) {
 
 /*_________________________________________________________________________________________________
   |
-  |  update : (S : Solver *) (rhs : int64_t) ( ) ->  [void]
+  |  update : (S : SATBackend *) (rhs : int64_t) ( ) ->  [void]
   |
   |  Description:
   |
@@ -365,7 +365,7 @@ void SWC::update(Solver *S, uint64_t rhs) {
   |    * 'assumptions' is updated with a new set of assumptions.
   |
   |________________________________________________________________________________________________@*/
-void SWC::update(Solver *S, uint64_t rhs, vec<Lit> &assumptions) {
+void SWC::update(SATBackend *S, uint64_t rhs, vec<Lit> &assumptions) {
   if (rhs >= INT32_MAX) {
     printf("c Overflow in the Encoding\n");
     printf("s UNKNOWN\n");
@@ -442,7 +442,7 @@ void SWC::update(Solver *S, uint64_t rhs, vec<Lit> &assumptions) {
 
 /*_________________________________________________________________________________________________
   |
-  |  join : (S : Solver *) (lits : vec<Lit>&)
+  |  join : (S : SATBackend *) (lits : vec<Lit>&)
   |         (coeffs : vec<Lit>&) (assumptions: vec<Lit>&) ->  [void]
   |
   |  Description:
@@ -462,7 +462,7 @@ void SWC::update(Solver *S, uint64_t rhs, vec<Lit> &assumptions) {
   |    * 'assumptions' is updated.
   |
   |________________________________________________________________________________________________@*/
-void SWC::join(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+void SWC::join(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
                vec<Lit> &assumptions) {
 
   assert(current_lit_blocking != lit_Undef);
@@ -52,15 +52,15 @@ public:
   ~SWC() {}
 
   // Encode constraint.
-  void encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs);
-  void encode(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs,
+  void encode(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs);
+  void encode(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs, uint64_t rhs,
               vec<Lit> &assumptions, int size);
   // Update constraint.
-  void update(Solver *S, uint64_t rhs);
-  void update(Solver *S, uint64_t rhs, vec<Lit> &assumptions);
+  void update(SATBackend *S, uint64_t rhs);
+  void update(SATBackend *S, uint64_t rhs, vec<Lit> &assumptions);
 
   // Update assumptions.
-  void updateAssumptions(Solver *S, vec<Lit> &assumptions) {
+  void updateAssumptions(SATBackend *S, vec<Lit> &assumptions) {
     assumptions.push(~current_lit_blocking);
 
     for (int i = 0; i < unit_lits.size(); i++)
@@ -68,7 +68,7 @@ public:
   }
 
   // Join encodings.
-  void join(Solver *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
+  void join(SATBackend *S, vec<Lit> &lits, vec<uint64_t> &coeffs,
             vec<Lit> &assumptions);
 
   // Returns true if the encoding was built, otherwise returns false;
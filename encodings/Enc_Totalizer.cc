@@ -29,49 +29,109 @@
 
 using namespace openwbo;
 
-void Totalizer::incremental(Solver *S, int64_t rhs) {
+/*_________________________________________________________________________________________________
+  |
+  |  newOutput : (S : SATBackend *) (index : int)  ->  [Lit]
+  |
+  |  Description:
+  |
+  |    Creates the output literal at position 'index' of a new node. With the
+  |    iterative strategy only the outputs up to the current rhs are needed and
+  |    the remaining ones are left as 'lit_Undef' until the bound is increased.
+  |
+  |________________________________________________________________________________________________@*/
+Lit Totalizer::newOutput(SATBackend *S, int index) {
+  if (isLazy() && index > current_cardinality_rhs)
+    return lit_Undef;
 
-  for (int z = 0; z < totalizerIterative_rhs.size(); z++) {
+  Lit p = mkLit(S->nVars(), false);
+  newSATVariable(S);
+  return p;
+}
 
-    // We only need to count the sums up to k.
-    for (int i = 0; i <= totalizerIterative_left[z].size(); i++) {
-      for (int j = 0; j <= totalizerIterative_right[z].size(); j++) {
-
-        if (i == 0 && j == 0) {
-          continue;
-        }
-
-        if (i + j > rhs + 1 || i + j <= totalizerIterative_rhs[z] + 1) {
-          continue;
-        }
-
-        if (i == 0) {
-          addBinaryClause(S, ~(totalizerIterative_right[z])[j - 1],
-                          (totalizerIterative_output[z])[j - 1], blocking);
-          n_clauses++;
-        } else if (j == 0) {
-          addBinaryClause(S, ~(totalizerIterative_left[z])[i - 1],
-                          (totalizerIterative_output[z])[i - 1], blocking);
-          n_clauses++;
-        } else {
-          addTernaryClause(S, ~(totalizerIterative_left[z])[i - 1],
-                           ~(totalizerIterative_right[z])[j - 1],
-                           (totalizerIterative_output[z])[i + j - 1], blocking);
-          n_clauses++;
-        }
+// Creates the missing output literals of 'output' that count up to 'rhs' + 1.
+void Totalizer::expand(SATBackend *S, vec<Lit> &output, int64_t rhs) {
+  for (int i = 0; i < output.size() && i <= rhs; i++) {
+    if (output[i] == lit_Undef) {
+      output[i] = mkLit(S->nVars(), false);
+      newSATVariable(S);
+    }
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  encodeNode : (S : SATBackend *) (z : int) (from : int64_t) (rhs : int64_t)
+  |               ->  [void]
+  |
+  |  Description:
+  |
+  |    Adds the clauses of node 'z' that count the sums in ]from + 1, rhs + 1].
+  |    The output literals used by these clauses are created on demand, both
+  |    for the node and for its children. The clauses of the children are added
+  |    when the children are themselves encoded.
+  |
+  |________________________________________________________________________________________________@*/
+void Totalizer::encodeNode(SATBackend *S, int z, int64_t from, int64_t rhs) {
+
+  vec<Lit> &left = leftInputs(z);
+  vec<Lit> &right = rightInputs(z);
+  vec<Lit> &output = totalizerIterative_output[z];
+
+  expand(S, left, rhs);
+  expand(S, right, rhs);
+  expand(S, output, rhs);
+
+  // We only need to count the sums up to k.
+  for (int i = 0; i <= left.size(); i++) {
+    for (int j = 0; j <= right.size(); j++) {
+
+      if (i == 0 && j == 0) {
+        continue;
+      }
+
+      if (i + j > rhs + 1 || i + j <= from + 1) {
+        continue;
+      }
+
+      if (i == 0) {
+        addBinaryClause(S, ~right[j - 1], output[j - 1], blocking);
+        n_clauses++;
+      } else if (j == 0) {
+        addBinaryClause(S, ~left[i - 1], output[i - 1], blocking);
+        n_clauses++;
+      } else {
+        addTernaryClause(S, ~left[i - 1], ~right[j - 1], output[i + j - 1],
+                         blocking);
+        n_clauses++;
       }
     }
+  }
+}
+
+void Totalizer::incremental(SATBackend *S, int64_t rhs) {
+
+  // Children are stored before their parents, so their outputs are already
+  // available when the parent is extended.
+  for (int z = 0; z < totalizerIterative_rhs.size(); z++) {
+    encodeNode(S, z, totalizerIterative_rhs[z], rhs);
     totalizerIterative_rhs[z] = rhs;
   }
+
+  if (totalizerIterative_output.size() > 0)
+    totalizerIterative_output.last().copyTo(cardinality_outlits);
 }
 
-void Totalizer::join(Solver *S, vec<Lit> &lits, int64_t rhs) {
+void Totalizer::join(SATBackend *S, vec<Lit> &lits, int64_t rhs) {
 
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_);
 
   vec<Lit> left_cardinality_outlits;
   cardinality_outlits.copyTo(left_cardinality_outlits);
   int old_cardinality = current_cardinality_rhs;
+  // The outputs of the current encoding are the outputs of the last node.
+  int nodes = totalizerIterative_output.size();
+  int left_node = left_cardinality_outlits.size() > 0 ? nodes - 1 : -1;
 
   if (lits.size() > 1) {
     build(S, lits, rhs < lits.size() ? rhs : lits.size());
@@ -80,32 +140,34 @@ void Totalizer::join(Solver *S, vec<Lit> &lits, int64_t rhs) {
     cardinality_outlits.clear();
     cardinality_outlits.push(lits[0]);
   }
+  int right_node =
+      totalizerIterative_output.size() > nodes ? totalizerIterative_output.size() - 1 : -1;
 
   vec<Lit> right_cardinality_outlits;
   cardinality_outlits.copyTo(right_cardinality_outlits);
   cardinality_outlits.clear();
 
+  current_cardinality_rhs = rhs;
   for (int i = 0;
        i < left_cardinality_outlits.size() + right_cardinality_outlits.size();
        i++) {
-    Lit p = mkLit(S->nVars(), false);
-    newSATVariable(S);
-    n_variables++;
+    Lit p = newOutput(S, i);
+    if (p != lit_Undef)
+      n_variables++;
     cardinality_outlits.push(p);
   }
 
-  current_cardinality_rhs = rhs;
   // TO_adder is using the 'current_cardinality_rhs' value
   adder(S, left_cardinality_outlits, right_cardinality_outlits,
-        cardinality_outlits);
+        cardinality_outlits, left_node, right_node);
   current_cardinality_rhs = old_cardinality;
 
   for (int i = 0; i < lits.size(); i++)
     ilits.push(lits[i]);
 }
 
-void Totalizer::adder(Solver *S, vec<Lit> &left, vec<Lit> &right,
-                      vec<Lit> &output) {
+void Totalizer::adder(SATBackend *S, vec<Lit> &left, vec<Lit> &right,
+                      vec<Lit> &output, int left_node, int right_node) {
   assert(output.size() == left.size() + right.size());
   if (incremental_strategy == _INCREMENTAL_ITERATIVE_) {
     totalizerIterative_left.push();
@@ -121,6 +183,13 @@ void Totalizer::adder(Solver *S, vec<Lit> &left, vec<Lit> &right,
         vec<Lit>();
     output.copyTo(totalizerIterative_output.last());
     totalizerIterative_rhs.push(current_cardinality_rhs);
+    totalizerIterative_lnode.push(left_node);
+    totalizerIterative_rnode.push(right_node);
+
+    encodeNode(S, totalizerIterative_output.size() - 1, -1,
+               current_cardinality_rhs);
+    totalizerIterative_output.last().copyTo(output);
+    return;
   }
 
   // We only need to count the sums up to k.
@@ -147,10 +216,12 @@ void Totalizer::adder(Solver *S, vec<Lit> &left, vec<Lit> &right,
   }
 }
 
-void Totalizer::toCNF(Solver *S, vec<Lit> &lits) {
+void Totalizer::toCNF(SATBackend *S, vec<Lit> &lits) {
 
   vec<Lit> left;
   vec<Lit> right;
+  int left_node = -1;
+  int right_node = -1;
 
   assert(lits.size() > 1);
   int split = floor(lits.size() / 2);
@@ -164,9 +235,7 @@ void Totalizer::toCNF(Solver *S, vec<Lit> &lits) {
         left.push(cardinality_inlits.last());
         cardinality_inlits.pop();
       } else {
-        Lit p = mkLit(S->nVars(), false);
-        newSATVariable(S);
-        left.push(p);
+        left.push(newOutput(S, left.size()));
       }
     } else {
 
@@ -176,21 +245,23 @@ void Totalizer::toCNF(Solver *S, vec<Lit> &lits) {
         right.push(cardinality_inlits.last());
         cardinality_inlits.pop();
       } else {
-        Lit p = mkLit(S->nVars(), false);
-        newSATVariable(S);
-        right.push(p);
+        right.push(newOutput(S, right.size()));
       }
     }
   }
 
-  if (left.size() > 1)
+  if (left.size() > 1) {
     toCNF(S, left);
-  if (right.size() > 1)
+    left_node = totalizerIterative_output.size() - 1;
+  }
+  if (right.size() > 1) {
     toCNF(S, right);
-  adder(S, left, right, lits);
+    right_node = totalizerIterative_output.size() - 1;
+  }
+  adder(S, left, right, lits, left_node, right_node);
 }
 
-void Totalizer::update(Solver *S, int64_t rhs, vec<Lit> &lits,
+void Totalizer::update(SATBackend *S, int64_t rhs, vec<Lit> &lits,
                        vec<Lit> &assumptions) {
 
   assert(hasEncoding);
@@ -226,8 +297,10 @@ void Totalizer::update(Solver *S, int64_t rhs, vec<Lit> &lits,
   case _INCREMENTAL_ITERATIVE_:
     incremental(S, rhs);
     assumptions.clear();
+    // Outputs above 'rhs' are only created when the bound reaches them.
     for (int i = rhs; i < cardinality_outlits.size(); i++)
-      assumptions.push(~cardinality_outlits[i]);
+      if (cardinality_outlits[i] != lit_Undef)
+        assumptions.push(~cardinality_outlits[i]);
     break;
 
   default:
@@ -237,10 +310,11 @@ void Totalizer::update(Solver *S, int64_t rhs, vec<Lit> &lits,
   }
 }
 
-void Totalizer::add(Solver *S, Totalizer &tot, int64_t rhs) {
+void Totalizer::add(SATBackend *S, Totalizer &tot, int64_t rhs) {
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_ &&
          tot.incremental_strategy == _INCREMENTAL_ITERATIVE_);
   int left_idx = totalizerIterative_rhs.size() - 1;
+  int offset = totalizerIterative_rhs.size();
   for (int i = 0; i < tot.totalizerIterative_rhs.size(); ++i) {
     totalizerIterative_left.push();
     new (&totalizerIterative_left[totalizerIterative_left.size() - 1])
@@ -255,6 +329,10 @@ void Totalizer::add(Solver *S, Totalizer &tot, int64_t rhs) {
         vec<Lit>();
     tot.totalizerIterative_output[i].copyTo(totalizerIterative_output.last());
     totalizerIterative_rhs.push(tot.totalizerIterative_rhs[i]);
+    int lnode = tot.totalizerIterative_lnode[i];
+    int rnode = tot.totalizerIterative_rnode[i];
+    totalizerIterative_lnode.push(lnode == -1 ? -1 : lnode + offset);
+    totalizerIterative_rnode.push(rnode == -1 ? -1 : rnode + offset);
   }
   int right_idx = totalizerIterative_rhs.size() - 1;
 
@@ -262,18 +340,15 @@ void Totalizer::add(Solver *S, Totalizer &tot, int64_t rhs) {
   totalizerIterative_output[left_idx].copyTo(left);
   totalizerIterative_output[right_idx].copyTo(right);
   cardinality_outlits.clear();
-  for (int i = 0; i < left.size() + right.size(); ++i) {
-    Lit p = mkLit(S->nVars(), false);
-    newSATVariable(S);
-    cardinality_outlits.push(p);
-  }
   current_cardinality_rhs = rhs;
-  adder(S, left, right, cardinality_outlits);
+  for (int i = 0; i < left.size() + right.size(); ++i)
+    cardinality_outlits.push(newOutput(S, i));
+  adder(S, left, right, cardinality_outlits, left_idx, right_idx);
 }
 
 /*_________________________________________________________________________________________________
   |
-  |  build : (S : Solver *) (lits : vec<Lit>&) (int64_t : rhs)  ->  [void]
+  |  build : (S : SATBackend *) (lits : vec<Lit>&) (int64_t : rhs)  ->  [void]
   |
   |  Description:
   |
@@ -295,7 +370,7 @@ void Totalizer::add(Solver *S, Totalizer &tot, int64_t rhs) {
   |    * hasEncoding is set to 'true'.
   |
   |________________________________________________________________________________________________@*/
-void Totalizer::build(Solver *S, vec<Lit> &lits, int64_t rhs) {
+void Totalizer::build(SATBackend *S, vec<Lit> &lits, int64_t rhs) {
 
   cardinality_outlits.clear();
   hasEncoding = false;
@@ -315,14 +390,11 @@ void Totalizer::build(Solver *S, vec<Lit> &lits, int64_t rhs) {
   if (rhs == lits.size() && !joinMode)
     return;
 
-  for (int i = 0; i < lits.size(); i++) {
-    Lit p = mkLit(S->nVars(), false);
-    newSATVariable(S);
-    cardinality_outlits.push(p);
-  }
+  current_cardinality_rhs = rhs;
+  for (int i = 0; i < lits.size(); i++)
+    cardinality_outlits.push(newOutput(S, i));
 
   lits.copyTo(cardinality_inlits);
-  current_cardinality_rhs = rhs;
 
   // If incremental blocking is enable then all clauses will contain a blocking
   // literal 'b'. Setting this literal to 'true' is the same as deletting these
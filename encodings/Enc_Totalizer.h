@@ -54,21 +54,22 @@ public:
   }
   ~Totalizer() {}
 
-  void build(Solver *S, vec<Lit> &lits, int64_t rhs);
-  void join(Solver *S, vec<Lit> &lits, int64_t rhs);
-  void update(Solver *S, int64_t rhs, vec<Lit> &lits, vec<Lit> &assumptions);
-  void update(Solver *S, int64_t rhs) {
+  void build(SATBackend *S, vec<Lit> &lits, int64_t rhs);
+  void join(SATBackend *S, vec<Lit> &lits, int64_t rhs);
+  void update(SATBackend *S, int64_t rhs, vec<Lit> &lits,
+              vec<Lit> &assumptions);
+  void update(SATBackend *S, int64_t rhs) {
     vec<Lit> lits;
     vec<Lit> assumptions;
     update(S, rhs, lits, assumptions);
   }
-  void add(Solver *S, Totalizer &tot, int64_t rhs);
+  void add(SATBackend *S, Totalizer &tot, int64_t rhs);
 
   bool hasCreatedEncoding() { return hasEncoding; }
   void setIncremental(int incremental) { incremental_strategy = incremental; }
   int getIncremental() { return incremental_strategy; }
 
-  // void enableConstraintBlocker(Solver* S)
+  // void enableConstraintBlocker(SATBackend *S)
   // {
   //   if (incremental_strategy == _INCREMENTAL_BLOCKING_)
   //   {
@@ -99,15 +100,40 @@ public:
   vec<Lit> &outputs() { return cardinality_outlits; }
 
 protected:
-  void encode(Solver *S, vec<Lit> &lits);
-  void adder(Solver *S, vec<Lit> &left, vec<Lit> &right, vec<Lit> &output);
-  void incremental(Solver *S, int64_t rhs);
-  void toCNF(Solver *S, vec<Lit> &lits);
+  void encode(SATBackend *S, vec<Lit> &lits);
+  void adder(SATBackend *S, vec<Lit> &left, vec<Lit> &right, vec<Lit> &output,
+             int left_node = -1, int right_node = -1);
+  void incremental(SATBackend *S, int64_t rhs);
+  void toCNF(SATBackend *S, vec<Lit> &lits);
+
+  // Lazy generation of output literals (iterative strategy only).
+  bool isLazy() { return incremental_strategy == _INCREMENTAL_ITERATIVE_; }
+  Lit newOutput(SATBackend *S, int index);
+  void expand(SATBackend *S, vec<Lit> &output, int64_t rhs);
+  void encodeNode(SATBackend *S, int z, int64_t from, int64_t rhs);
+  vec<Lit> &leftInputs(int z) {
+    return totalizerIterative_lnode[z] == -1
+               ? totalizerIterative_left[z]
+               : totalizerIterative_output[totalizerIterative_lnode[z]];
+  }
+  vec<Lit> &rightInputs(int z) {
+    return totalizerIterative_rnode[z] == -1
+               ? totalizerIterative_right[z]
+               : totalizerIterative_output[totalizerIterative_rnode[z]];
+  }
 
+  // Nodes of the totalizer tree for the iterative strategy. Children are
+  // always stored before their parent and the last node is the root.
+  // A child that is a node of the tree is referenced by its index in
+  // 'totalizerIterative_lnode' / 'totalizerIterative_rnode' (-1 when the
+  // child is a vector of input literals) so that output literals created on
+  // demand are shared between the child and its parent.
   vec<vec<Lit>> totalizerIterative_left;
   vec<vec<Lit>> totalizerIterative_right;
   vec<vec<Lit>> totalizerIterative_output;
   vec<int64_t> totalizerIterative_rhs;
+  vec<int> totalizerIterative_lnode;
+  vec<int> totalizerIterative_rnode;
 
   Lit blocking; // Controls the blocking literal for the incremental blocking.
   bool hasEncoding;
@@ -119,7 +145,10 @@ protected:
   vec<Lit> cardinality_inlits; // Stores the inputs of the cardinality
                                // constraint encoding for the totalizer encoding
   vec<Lit> cardinality_outlits; // Stores the outputs of the cardinality
-                                // constraint encoding for incremental solving
+                                // constraint encoding for incremental solving.
+                                // With the iterative strategy only the outputs
+                                // up to the current rhs are created; the
+                                // remaining ones are 'lit_Undef'.
 
   int incremental_strategy;
   int64_t current_cardinality_rhs;
@@ -30,7 +30,7 @@
 using namespace openwbo;
 
 // Creates an unit clause in the SAT solver
-void Encodings::addUnitClause(Solver *S, Lit a, Lit blocking) {
+void Encodings::addUnitClause(SATBackend *S, Lit a, Lit blocking) {
   assert(clause.size() == 0);
   assert(a != lit_Undef);
   assert(var(a) < S->nVars());
@@ -42,7 +42,7 @@ void Encodings::addUnitClause(Solver *S, Lit a, Lit blocking) {
 }
 
 // Creates a binary clause in the SAT solver
-void Encodings::addBinaryClause(Solver *S, Lit a, Lit b, Lit blocking) {
+void Encodings::addBinaryClause(SATBackend *S, Lit a, Lit b, Lit blocking) {
   assert(clause.size() == 0);
   assert(a != lit_Undef && b != lit_Undef);
   assert(var(a) < S->nVars() && var(b) < S->nVars());
@@ -55,7 +55,7 @@ void Encodings::addBinaryClause(Solver *S, Lit a, Lit b, Lit blocking) {
 }
 
 // Creates a ternary clause in the SAT solver
-void Encodings::addTernaryClause(Solver *S, Lit a, Lit b, Lit c, Lit blocking) {
+void Encodings::addTernaryClause(SATBackend *S, Lit a, Lit b, Lit c, Lit blocking) {
   assert(clause.size() == 0);
   assert(a != lit_Undef && b != lit_Undef && c != lit_Undef);
   assert(var(a) < S->nVars() && var(b) < S->nVars() && var(c) < S->nVars());
@@ -69,7 +69,7 @@ void Encodings::addTernaryClause(Solver *S, Lit a, Lit b, Lit c, Lit blocking) {
 }
 
 // Creates a quaternary clause in the SAT solver
-void Encodings::addQuaternaryClause(Solver *S, Lit a, Lit b, Lit c, Lit d,
+void Encodings::addQuaternaryClause(SATBackend *S, Lit a, Lit b, Lit c, Lit d,
                                     Lit blocking) {
   assert(clause.size() == 0);
   assert(a != lit_Undef && b != lit_Undef && c != lit_Undef && d != lit_Undef);
@@ -28,13 +28,8 @@
 #ifndef Encodings_h
 #define Encodings_h
 
-#ifdef SIMP
-#include "simp/SimpSolver.h"
-#else
-#include "core/Solver.h"
-#endif
-
 #include "../MaxTypes.h"
+#include "../SATBackend.h"
 #include "core/SolverTypes.h"
 
 using NSPACE::vec;
@@ -42,7 +37,6 @@ using NSPACE::Lit;
 using NSPACE::mkLit;
 using NSPACE::lit_Error;
 using NSPACE::lit_Undef;
-using NSPACE::Solver;
 
 namespace openwbo {
 
@@ -56,24 +50,18 @@ public:
   // Auxiliary methods for creating clauses
   //
   // Add a unit clause to a SAT solver
-  void addUnitClause(Solver *S, Lit a, Lit blocking = lit_Undef);
+  void addUnitClause(SATBackend *S, Lit a, Lit blocking = lit_Undef);
   // Add a binary clause to a SAT solver
-  void addBinaryClause(Solver *S, Lit a, Lit b, Lit blocking = lit_Undef);
+  void addBinaryClause(SATBackend *S, Lit a, Lit b, Lit blocking = lit_Undef);
   // Add a ternary clause to a SAT solver
-  void addTernaryClause(Solver *S, Lit a, Lit b, Lit c,
+  void addTernaryClause(SATBackend *S, Lit a, Lit b, Lit c,
                         Lit blocking = lit_Undef);
   // Add a quaternary clause to a SAT solver
-  void addQuaternaryClause(Solver *S, Lit a, Lit b, Lit c, Lit d,
+  void addQuaternaryClause(SATBackend *S, Lit a, Lit b, Lit c, Lit d,
                            Lit blocking = lit_Undef);
 
   // Creates a new variable in the SAT solver
-  void newSATVariable(Solver *S) {
-#ifdef SIMP
-    ((NSPACE::SimpSolver *)S)->newVar();
-#else
-    S->newVar();
-#endif
-  }
+  void newSATVariable(SATBackend *S) { S->newVar(); }
 
 protected:
   vec<Lit> clause; // Temporary clause to be used while building the encodings.
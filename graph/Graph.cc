@@ -29,6 +29,9 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "Graph.h"
 
 using namespace openwbo;
@@ -36,77 +39,124 @@ using namespace openwbo;
 Graph::Graph(int nVert) {
   _nSCC = 0;
   _nVert = nVert;
-  _edges.growTo(_nVert);
-  _weights.growTo(_nVert);
-  _incomingEdges.growTo(_nVert);
-  _totalWeights.growTo(_nVert);
-  _nSelfLoops.growTo(_nVert);
+  _offsets.growTo(_nVert + 1, 0);
+  _incomingEdges.growTo(_nVert, 0);
+  _totalWeights.growTo(_nVert, 0.0);
+  _nSelfLoops.growTo(_nVert, 0.0);
+  _marks.growTo(_nVert, WHITE);
 
   _nMarked = 0;
   _totalWeight = 0.0;
-
-  for (int i = 0; i < _nVert; i++) {
-    _incomingEdges[i] = 0;
-    _totalWeights[i] = 0.0;
-    _nSelfLoops[i] = 0.0;
-  }
 }
 
 Graph::~Graph() {}
 
-void Graph::addEdge(int u, int v, double w) {
-  if (u == v)
-    _nSelfLoops[u] += w;
-
-  _edges[u].push(v);
-  _weights[u].push(w);
-  _incomingEdges[v]++;
-
-  _totalWeights[u] += w;
-  _totalWeight += w;
+GraphBuilder::GraphBuilder(int nVert) {
+  _nVert = nVert;
+  _allocated = false;
+  _offsets.growTo(_nVert + 1, 0);
 }
 
-int Graph::nEdges() {
-  int e = 0;
-  mergeDuplicatedEdges();
-  for (int i = 0; i < _nVert; i++)
-    e += _edges[i].size();
-  return e;
+void GraphBuilder::addEdge(int u, int v, double w) {
+  assert(u >= 0 && u < _nVert && v >= 0 && v < _nVert);
+  if (!_allocated)
+    _offsets[u + 1]++;
+  else {
+    assert(_rowEnd[u] < _offsets[u + 1]);
+    int pos = _rowEnd[u]++;
+    _targets[pos] = v;
+    _weights[pos] = (float)w;
+  }
 }
 
-// Remove duplicated edges. O(V+E)
-
-void Graph::mergeDuplicatedEdges() {
-  // vmm - Vectors on stack?!?! Is this a good idea for large graphs?!?!
-  vec<int> destVertexes;
-  vec<double> w;
-  int n = 0;
-
-  w.growTo(_nVert);
-  destVertexes.growTo(_nVert);
-  for (int i = 0; i < _nVert; i++)
-    w[i] = 0;
-
-  for (int i = 0; i < _nVert; i++) {
-    if (_edges[i].size() > 0) {
-      for (int j = 0; j < _edges[i].size(); j++) {
-        int v = _edges[i][j];
-        if (w[v] == 0)
-          destVertexes[n++] = v; // New destination vertex
-        else
-          _incomingEdges[v]--; // Duplicated edge
-        w[v] += _weights[i][j];
-      }
+// Turns the counts of the first pass into row offsets and sizes the rows.
+void GraphBuilder::allocate() {
+  assert(!_allocated);
+  for (int u = 0; u < _nVert; u++)
+    _offsets[u + 1] += _offsets[u];
+
+  _rowEnd.growTo(_nVert);
+  for (int u = 0; u < _nVert; u++)
+    _rowEnd[u] = _offsets[u];
+  _targets.growTo(_offsets[_nVert]);
+  _weights.growTo(_offsets[_nVert]);
+  _allocated = true;
+}
 
-      for (int j = 0; j < n; j++) {
-        _edges[i][j] = destVertexes[j];
-        _weights[i][j] = w[destVertexes[j]];
-        w[destVertexes[j]] = 0;
+/*_________________________________________________________________________________________________
+  |
+  |  build : [void]  ->  [Graph *]
+  |
+  |  Description:
+  |
+  |    Sorts each row by destination (keeping the order in which duplicated
+  |    edges were added) and merges its duplicated edges in place. The merged
+  |    rows are then copied into exactly sized arrays of the graph, unless
+  |    there were no duplicates, in which case the arrays are moved.
+  |
+  |  Pre-conditions:
+  |    * The second pass added the same edges as the first one.
+  |
+  |________________________________________________________________________________________________@*/
+Graph *GraphBuilder::build() {
+  if (!_allocated)
+    allocate();
+
+  Graph *g = new Graph(_nVert);
+  std::vector<std::pair<int, float>> row;
+
+  int k = 0;
+  for (int u = 0; u < _nVert; u++) {
+    assert(_rowEnd[u] == _offsets[u + 1]);
+    row.clear();
+    for (int i = _offsets[u]; i < _offsets[u + 1]; i++)
+      row.push_back(std::make_pair(_targets[i], _weights[i]));
+    std::stable_sort(row.begin(), row.end(),
+                     [](const std::pair<int, float> &a,
+                        const std::pair<int, float> &b) {
+                       return a.first < b.first;
+                     });
+
+    g->_offsets[u] = k;
+    for (size_t i = 0; i < row.size(); i++) {
+      int v = row[i].first;
+      float w = row[i].second;
+
+      if (k > g->_offsets[u] && _targets[k - 1] == v)
+        _weights[k - 1] += w; // Duplicated edge
+      else {
+        _targets[k] = v;
+        _weights[k] = w;
+        k++;
+        g->_incomingEdges[v]++;
       }
 
-      _edges[i].shrink_(_edges[i].size() - n);
-      _weights[i].shrink_(_weights[i].size() - n);
-      n = 0;
+      if (u == v)
+        g->_nSelfLoops[u] += w;
+      g->_totalWeights[u] += w;
+      g->_totalWeight += w;
+    }
+  }
+  g->_offsets[_nVert] = k;
+
+  if (k == _targets.size()) {
+    _targets.moveTo(g->_targets);
+    _weights.moveTo(g->_weights);
+  } else {
+    g->_targets.growTo(k);
+    g->_weights.growTo(k);
+    if (k > 0) {
+      memcpy(&g->_targets[0], &_targets[0], sizeof(int) * k);
+      memcpy(&g->_weights[0], &_weights[0], sizeof(float) * k);
     }
   }
+
+  _targets.clear(true);
+  _weights.clear(true);
+  _rowEnd.clear(true);
+  for (int u = 0; u <= _nVert; u++)
+    _offsets[u] = 0;
+  _allocated = false;
+
+  return g;
 }
@@ -28,6 +28,7 @@
 #ifndef __GRAPH__
 #define __GRAPH__
 
+#include <assert.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -40,22 +41,49 @@ namespace openwbo {
 
 enum color_ { WHITE, GRAY, BLACK };
 
+/*! Read-only view of the row of a vertex in a compressed sparse row graph. */
+template <class T> class GraphRow {
+public:
+  GraphRow(const T *data, int size) : _data(data), _size(size) {}
+
+  inline int size() const { return _size; }
+  inline const T &operator[](int i) const {
+    assert(i >= 0 && i < _size);
+    return _data[i];
+  }
+
+protected:
+  const T *_data;
+  int _size;
+};
+
+/*! Weighted directed graph in compressed sparse row (CSR) form. The
+ * neighbors of vertex 'u' are '_targets[_offsets[u] .. _offsets[u + 1])' and
+ * the weight of each edge is stored at the same position of '_weights'.
+ * Graphs are created with a GraphBuilder and are not modified afterwards.
+ */
 class Graph {
+  friend class GraphBuilder;
+
 public:
   // Constructor/Destructor:
   //
   Graph(int nVert);
   ~Graph();
 
-  void addEdge(int u, int v, double w = 1.0);
-  int nEdges();
-  void mergeDuplicatedEdges();
+  int nEdges() { return _offsets[_nVert]; }
 
   // Stats
   inline int nVertexes() { return _nVert; }
-  inline vec<int> &vertexEdges(int u) { return _edges[u]; }
-  inline vec<double> &vertexWeights(int u) { return _weights[u]; }
-  inline int nNeighbors(int u) { return _edges[u].size(); }
+  // The edge arrays have no storage in an edgeless graph, so the rows are
+  // taken from the raw pointers instead of '&_targets[0]'.
+  inline GraphRow<int> vertexEdges(int u) {
+    return GraphRow<int>((int *)_targets + _offsets[u], nNeighbors(u));
+  }
+  inline GraphRow<float> vertexWeights(int u) {
+    return GraphRow<float>((float *)_weights + _offsets[u], nNeighbors(u));
+  }
+  inline int nNeighbors(int u) { return _offsets[u + 1] - _offsets[u]; }
   inline int nIncomingEdges(int u) { return _incomingEdges[u]; }
   inline double nSelfLoops(int u) { return _nSelfLoops[u]; }
 
@@ -84,6 +112,7 @@ public:
    */
 
   int connectedComponents();
+  int connectedComponents(vec<int> &component);
 
   // Labels, colors and output
 
@@ -99,8 +128,9 @@ protected:
 
 protected:
   int _nVert;
-  vec<vec<int>> _edges;
-  vec<vec<double>> _weights;
+  vec<int> _offsets;   // start of the row of each vertex (size _nVert + 1)
+  vec<int> _targets;   // destination of each edge
+  vec<float> _weights; // weight of each edge
   vec<double> _totalWeights;
   double _totalWeight;
   vec<int> _incomingEdges;
@@ -120,6 +150,36 @@ protected:
   vec<vec<int>> _sccs;
 };
 
+/*! Two-pass builder of CSR graphs. The caller generates its edges twice with
+ * 'addEdge'. During the first pass the edges are only counted per source
+ * vertex. 'allocate' then sizes the rows with these counts and, during the
+ * second pass, each edge is stored directly in the row of its source.
+ * 'build' merges the duplicated edges of each row (their weights are added).
+ * The rows of the resulting graph are sorted by destination.
+ */
+class GraphBuilder {
+public:
+  GraphBuilder(int nVert);
+  ~GraphBuilder() {}
+
+  // Counts the edge (first pass) or stores it in the row of 'u' (second pass).
+  void addEdge(int u, int v, double w = 1.0);
+
+  // Ends the first pass.
+  void allocate();
+
+  // Builds the graph and resets the builder.
+  Graph *build();
+
+protected:
+  int _nVert;
+  bool _allocated;
+  vec<int> _offsets;   // start of the row of each vertex (size _nVert + 1)
+  vec<int> _rowEnd;    // next free position in the row of each vertex
+  vec<int> _targets;   // destination of each stored edge
+  vec<float> _weights; // weight of each stored edge
+};
+
 } // namespace openwbo
 
 #endif
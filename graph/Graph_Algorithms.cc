@@ -60,9 +60,9 @@ void Graph::DFSVisitIter(int u, vec<int> &reachedVertexes) {
     if (_marks[u] == WHITE) {
       _marks[u] = BLACK;
 
-      for (int i = 0; i < _edges[u].size(); i++) {
-        if (_marks[_edges[u][i]] == WHITE) {
-          l->push(_edges[u][i]);
+      for (int i = 0; i < nNeighbors(u); i++) {
+        if (_marks[_targets[_offsets[u] + i]] == WHITE) {
+          l->push(_targets[_offsets[u] + i]);
         }
       }
       reachedVertexes.push(u);
@@ -77,9 +77,9 @@ void Graph::DFSVisit(int u, vec<int> &reachedVertexes) {
   if (_marks[u] == WHITE) {
     _marks[u] = BLACK;
 
-    for (int i = 0; i < _edges[u].size(); i++) {
-      if (_marks[_edges[u][i]] == WHITE) {
-        DFSVisit(_edges[u][i], reachedVertexes);
+    for (int i = 0; i < nNeighbors(u); i++) {
+      if (_marks[_targets[_offsets[u] + i]] == WHITE) {
+        DFSVisit(_targets[_offsets[u] + i], reachedVertexes);
       }
     }
     reachedVertexes.push(u);
@@ -88,7 +88,7 @@ void Graph::DFSVisit(int u, vec<int> &reachedVertexes) {
 
 void Graph::topologicalSort(vec<int> &vertexes) {
   for (int i = 0; i < _nVert; i++) {
-    if (_marks[i] == WHITE && _edges[i].size()) {
+    if (_marks[i] == WHITE && nNeighbors(i)) {
       DFSVisit(i, vertexes);
     }
   }
@@ -101,7 +101,7 @@ int Graph::connectedComponents() {
   vec<int> vertexes;
 
   for (int i = 0; i < _nVert; i++) {
-    if (_marks[i] == WHITE && _edges[i].size()) {
+    if (_marks[i] == WHITE && nNeighbors(i)) {
       n++;
       DFSVisitIter(i, vertexes);
     }
@@ -109,6 +109,38 @@ int Graph::connectedComponents() {
   return n;
 }
 
+// Labels every vertex with the index of its connected component and returns
+// the number of components. Edges are followed in their stored direction, so
+// the graph must hold both directions of every edge. Vertexes without edges
+// form a component of their own.
+int Graph::connectedComponents(vec<int> &component) {
+  int n = 0;
+  vec<int> stack;
+
+  component.clear();
+  component.growTo(_nVert, -1);
+
+  for (int i = 0; i < _nVert; i++) {
+    if (component[i] != -1)
+      continue;
+
+    component[i] = n;
+    stack.push(i);
+    while (stack.size() > 0) {
+      int u = stack.last();
+      stack.pop();
+      for (int j = _offsets[u]; j < _offsets[u + 1]; j++) {
+        if (component[_targets[j]] == -1) {
+          component[_targets[j]] = n;
+          stack.push(_targets[j]);
+        }
+      }
+    }
+    n++;
+  }
+  return n;
+}
+
 // Strong Connected Components (SCC)
 
 // void Graph::findAllScc() {
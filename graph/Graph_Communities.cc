@@ -33,23 +33,59 @@
 
 #include "mtl/Vec.h"
 
+#include <algorithm>
 #include <map>
+#include <thread>
+#include <vector>
 
 using namespace openwbo;
 
 #define PRECISION 0.000001
 
+// Minimum number of vertexes handled by each thread.
+#define MIN_THREAD_VERTEXES 4096
+
+// Label propagation stops after this number of sweeps, or earlier when less
+// than this fraction of the vertexes changed label in the last sweep.
+#define LABEL_PROP_SWEEPS 20
+#define LABEL_PROP_TOLERANCE 0.001
+
+// Splits [0, n) in contiguous ranges and calls 'f(begin, end, thread)' for each
+// of them, using at most 'threads' threads.
+template <class F> static void parallelFor(int n, int threads, F f) {
+  if (threads > n / MIN_THREAD_VERTEXES)
+    threads = n / MIN_THREAD_VERTEXES;
+
+  if (threads <= 1) {
+    f(0, n, 0);
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  int chunk = (n + threads - 1) / threads;
+  for (int t = 0; t < threads; t++) {
+    int begin = t * chunk;
+    int end = std::min(n, begin + chunk);
+    if (begin < end)
+      workers.push_back(std::thread(f, begin, end, t));
+  }
+  for (size_t t = 0; t < workers.size(); t++)
+    workers[t].join();
+}
+
 Graph_Communities::Graph_Communities() {
   _nCommunities = 0;
   _modularity = 0.0;
   _g = NULL;
+  _nThreads = 1;
 }
 
 Graph_Communities::~Graph_Communities() {}
 
 int Graph_Communities::findCommunities(int mode, Graph *g) {
   // mode indicates the method used to identify communities...
-  // Currentely, just the unfolding method is implemented.
+  // Either the unfolding method or label propagation (LABEL_PROP_MODE).
+  // With more than one thread the multi-threaded unfolding method is used.
 
   // Clear data from previous run
   _g = g;
@@ -61,18 +97,33 @@ int Graph_Communities::findCommunities(int mode, Graph *g) {
 
   resetInternalData();
 
+  if (mode == LABEL_PROP_MODE) {
+    labelPropagation();
+
+    // The communities are collapsed as in the unfolding method so that the
+    // adjacency of the communities is available.
+    _g = _nThreads > 1 ? nextIterationGraphParallel() : nextIterationGraph();
+    for (int i = 0; i < g->nVertexes(); i++)
+      _vertexCommunity[i] = _renumber[_vertexToComm[i]];
+
+    resetInternalData();
+    _modularity = modularity();
+    return _nCommunities;
+  }
+
   bool improvement = true;
   int level = 0;
   Graph *g_old = NULL;
 
   do {
-    improvement = iterate();
+    improvement = _nThreads > 1 ? iterateParallel() : iterate();
     _modularity = modularity();
 
     ++level;
 
-    g_old = _g;                // Save ptr to current graph
-    _g = nextIterationGraph(); // Generate next iteration graph
+    g_old = _g; // Save ptr to current graph
+    // Generate next iteration graph
+    _g = _nThreads > 1 ? nextIterationGraphParallel() : nextIterationGraph();
 
     if (level > 1)
       delete g_old; // Delete previous graph, but never delete the original
@@ -158,8 +209,8 @@ bool Graph_Communities::iterate() {
 }
 
 void Graph_Communities::computeAdjCommunities(int vertex) {
-  vec<int> &edges = _g->vertexEdges(vertex);
-  vec<double> &weights = _g->vertexWeights(vertex);
+  GraphRow<int> edges = _g->vertexEdges(vertex);
+  GraphRow<float> weights = _g->vertexWeights(vertex);
 
   // Reset internal vectors
   for (int i = 0; i < _adjComm.size(); i++) {
@@ -187,7 +238,7 @@ void Graph_Communities::computeAdjCommunities(int vertex) {
   }
 }
 
-Graph *Graph_Communities::nextIterationGraph() {
+void Graph_Communities::renumberCommunities() {
   // Compute the new number of communities
   for (int i = 0; i < _g->nVertexes(); i++)
     _renumber[i] = 0;
@@ -204,9 +255,15 @@ Graph *Graph_Communities::nextIterationGraph() {
   _communities.growTo(_nCommunities);
   for (int i = 0; i < _g->nVertexes(); i++)
     _communities[_renumber[_vertexToComm[i]]].push(i);
+}
 
-  // Compute new weighted graph with colapsed communities
-  Graph *g2 = new Graph(_nCommunities);
+Graph *Graph_Communities::nextIterationGraph() {
+  renumberCommunities();
+
+  vec<vec<int>> edges;
+  vec<vec<double>> weights;
+  edges.growTo(_nCommunities);
+  weights.growTo(_nCommunities);
 
   for (int comm = 0; comm < _nCommunities; comm++) {
     map<int, double> m;
@@ -214,8 +271,8 @@ Graph *Graph_Communities::nextIterationGraph() {
     int comm_size = _communities[comm].size();
 
     for (int u = 0; u < comm_size; u++) {
-      vec<int> &edges = _g->vertexEdges(_communities[comm][u]);
-      vec<double> &weights = _g->vertexWeights(_communities[comm][u]);
+      GraphRow<int> edges = _g->vertexEdges(_communities[comm][u]);
+      GraphRow<float> weights = _g->vertexWeights(_communities[comm][u]);
 
       for (int i = 0; i < edges.size(); i++) {
         int v = edges[i];
@@ -229,13 +286,390 @@ Graph *Graph_Communities::nextIterationGraph() {
       }
     }
 
-    for (it = m.begin(); it != m.end(); it++)
-      g2->addEdge(comm, it->first, it->second);
+    for (it = m.begin(); it != m.end(); it++) {
+      edges[comm].push(it->first);
+      weights[comm].push(it->second);
+    }
+  }
+
+  // Compute new weighted graph with colapsed communities
+  GraphBuilder builder(_nCommunities);
+  for (int pass = 0; pass < 2; pass++) {
+    if (pass == 1)
+      builder.allocate();
+    for (int comm = 0; comm < _nCommunities; comm++)
+      for (int i = 0; i < edges[comm].size(); i++)
+        builder.addEdge(comm, edges[comm][i], weights[comm][i]);
+  }
+
+  return builder.build();
+}
+
+/// Multi-threaded unfolding
+
+/*_________________________________________________________________________________________________
+  |
+  |  colorVertexes : (order : vec<int>&) (classes : vec<int>&)  ->  [int]
+  |
+  |  Description:
+  |
+  |    Greedy distance-1 coloring of the current graph, visiting the vertexes
+  |    in a random order. Vertexes with the same color are not adjacent and
+  |    can therefore be moved to new communities at the same time.
+  |
+  |  Post-conditions:
+  |    * 'order' contains the vertexes sorted by color.
+  |    * The vertexes of color 'c' are in [classes[c], classes[c + 1]).
+  |    * Returns the number of colors.
+  |
+  |________________________________________________________________________________________________@*/
+int Graph_Communities::colorVertexes(vec<int> &order, vec<int> &classes) {
+  int n = _g->nVertexes();
+
+  vec<int> random_order;
+  random_order.growTo(n);
+  for (int i = 0; i < n; i++)
+    random_order[i] = i;
+  for (int i = 0; i < n - 1; i++) {
+    int rand_pos = rand() % (n - i) + i;
+    int tmp = random_order[i];
+    random_order[i] = random_order[rand_pos];
+    random_order[rand_pos] = tmp;
+  }
+
+  vec<int> color;
+  vec<int> forbidden; // forbidden[c] == u if a neighbor of u has color c
+  color.growTo(n, -1);
+  int nColors = 0;
+
+  for (int i = 0; i < n; i++) {
+    int u = random_order[i];
+    GraphRow<int> edges = _g->vertexEdges(u);
+
+    for (int j = 0; j < edges.size(); j++) {
+      int c = color[edges[j]];
+      if (c != -1)
+        forbidden[c] = u;
+    }
+
+    int c = 0;
+    while (c < nColors && forbidden[c] == u)
+      c++;
+    if (c == nColors) {
+      forbidden.push(-1);
+      nColors++;
+    }
+    color[u] = c;
+  }
+
+  // Counting sort of the vertexes by color (random order within a color).
+  classes.clear();
+  classes.growTo(nColors + 1, 0);
+  for (int i = 0; i < n; i++)
+    classes[color[i] + 1]++;
+  for (int c = 0; c < nColors; c++)
+    classes[c + 1] += classes[c];
+
+  vec<int> next;
+  classes.copyTo(next);
+  order.clear();
+  order.growTo(n);
+  for (int i = 0; i < n; i++) {
+    int u = random_order[i];
+    order[next[color[u]]++] = u;
+  }
+
+  return nColors;
+}
+
+// Computes the best community of each vertex in 'vertexes[begin..end)' with
+// respect to the current communities, without changing them. Uses the
+// scratch vectors of 'thread'.
+void Graph_Communities::bestMoves(const vec<int> &vertexes, int begin,
+                                  int end, int thread) {
+  vec<double> &adjWeight = _threadAdjWeight[thread];
+  vec<int> &adjComm = _threadAdjComm[thread];
+
+  for (int k = begin; k < end; k++) {
+    int vertex = vertexes[k];
+    int comm = _vertexToComm[vertex];
+    double degree = _g->weightedDegree(vertex);
+    double factor = degree / _g->totalWeight();
+    GraphRow<int> edges = _g->vertexEdges(vertex);
+    GraphRow<float> weights = _g->vertexWeights(vertex);
+
+    // A negative weight marks a community that is not adjacent.
+    adjComm.clear();
+    adjComm.push(comm);
+    adjWeight[comm] = 0.0;
+    for (int i = 0; i < edges.size(); i++) {
+      int u = edges[i];
+      if (u == vertex)
+        continue;
+
+      int c = _vertexToComm[u];
+      if (adjWeight[c] < 0) {
+        adjWeight[c] = 0.0;
+        adjComm.push(c);
+      }
+      adjWeight[c] += weights[i];
+    }
+
+    // Same choice as 'iterate', with the vertex removed from its community.
+    int best_comm = comm;
+    double best_variation = 0.0;
+    for (int i = 0; i < adjComm.size(); i++) {
+      int c = adjComm[i];
+      double total = c == comm ? _total[c] - degree : _total[c];
+      double variation = adjWeight[c] - total * factor;
+      if (variation > best_variation) {
+        best_comm = c;
+        best_variation = variation;
+      }
+    }
+
+    _bestComm[vertex] = best_comm;
+    _bestWeight[vertex] = adjWeight[best_comm];
+    _oldWeight[vertex] = adjWeight[comm];
+
+    for (int i = 0; i < adjComm.size(); i++)
+      adjWeight[adjComm[i]] = -1.0;
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  iterateParallel : [void]  ->  [bool]
+  |
+  |  Description:
+  |
+  |    Multi-threaded version of 'iterate'. The vertexes are colored so that
+  |    adjacent vertexes have different colors. For each color, the best
+  |    community of every vertex is computed in parallel and the moves are then
+  |    applied. Since the vertexes of a color are not adjacent, the weights
+  |    towards their communities do not change while the moves are applied,
+  |    and only the community totals may be slightly outdated. Sweeps are
+  |    repeated while the modularity improves.
+  |
+  |  Post-conditions:
+  |    * Returns true if some vertex changed community.
+  |
+  |________________________________________________________________________________________________@*/
+bool Graph_Communities::iterateParallel() {
+  double new_mod = modularity();
+  double cur_mod = new_mod;
+  bool better = false;
+  int n = _g->nVertexes();
+
+  vec<int> order;
+  vec<int> classes;
+  int nColors = colorVertexes(order, classes);
+
+  _bestComm.growTo(n);
+  _bestWeight.growTo(n);
+  _oldWeight.growTo(n);
+  initThreadData();
+
+  // Cycle to improve modularity
+  do {
+    cur_mod = new_mod;
+
+    for (int c = 0; c < nColors; c++) {
+      int begin = classes[c];
+      int size = classes[c + 1] - begin;
+
+      parallelFor(size, _nThreads, [&](int b, int e, int t) {
+        bestMoves(order, begin + b, begin + e, t);
+      });
+
+      for (int k = begin; k < begin + size; k++) {
+        int vertex = order[k];
+        int comm = _vertexToComm[vertex];
+        int best_comm = _bestComm[vertex];
+
+        if (best_comm != comm) {
+          remove(vertex, comm, _oldWeight[vertex]);
+          insert(vertex, best_comm, _bestWeight[vertex]);
+          better = true;
+        }
+      }
+    }
+
+    new_mod = modularity();
+
+  } while (new_mod - cur_mod > PRECISION);
+
+  return better;
+}
+
+// Multi-threaded version of 'nextIterationGraph'. The edges of each collapsed
+// community are computed in parallel and then added to the new graph in the
+// same order as the sequential version.
+Graph *Graph_Communities::nextIterationGraphParallel() {
+  renumberCommunities();
+
+  vec<vec<int>> edges;
+  vec<vec<double>> weights;
+  edges.growTo(_nCommunities);
+  weights.growTo(_nCommunities);
+
+  parallelFor(_nCommunities, _nThreads, [&](int begin, int end, int t) {
+    std::vector<double> acc(_nCommunities, -1.0);
+    std::vector<int> adj;
+
+    for (int comm = begin; comm < end; comm++) {
+      adj.clear();
+      for (int u = 0; u < _communities[comm].size(); u++) {
+        GraphRow<int> e = _g->vertexEdges(_communities[comm][u]);
+        GraphRow<float> w = _g->vertexWeights(_communities[comm][u]);
+
+        for (int i = 0; i < e.size(); i++) {
+          int new_id = _renumber[_vertexToComm[e[i]]];
+          if (acc[new_id] < 0) {
+            acc[new_id] = 0.0;
+            adj.push_back(new_id);
+          }
+          acc[new_id] += w[i];
+        }
+      }
+
+      std::sort(adj.begin(), adj.end());
+      for (size_t i = 0; i < adj.size(); i++) {
+        edges[comm].push(adj[i]);
+        weights[comm].push(acc[adj[i]]);
+        acc[adj[i]] = -1.0;
+      }
+    }
+  });
+
+  // Compute new weighted graph with colapsed communities
+  GraphBuilder builder(_nCommunities);
+  for (int pass = 0; pass < 2; pass++) {
+    if (pass == 1)
+      builder.allocate();
+    for (int comm = 0; comm < _nCommunities; comm++)
+      for (int i = 0; i < edges[comm].size(); i++)
+        builder.addEdge(comm, edges[comm][i], weights[comm][i]);
+  }
+
+  return builder.build();
+}
+
+// Allocates the scratch vectors of each thread for the current graph.
+void Graph_Communities::initThreadData() {
+  _threadAdjWeight.clear();
+  _threadAdjComm.clear();
+  _threadAdjWeight.growTo(_nThreads);
+  _threadAdjComm.growTo(_nThreads);
+  for (int t = 0; t < _nThreads; t++)
+    _threadAdjWeight[t].growTo(_g->nVertexes(), -1.0);
+}
+
+/// Label propagation
+
+/*_________________________________________________________________________________________________
+  |
+  |  labelPropagation : [void]  ->  [void]
+  |
+  |  Description:
+  |
+  |    Every vertex starts with its own label and repeatedly takes the label
+  |    with the largest weight among its neighbors. Each sweep costs O(V+E)
+  |    and only a few sweeps are needed, which makes it suitable for graphs
+  |    where the unfolding method is too slow. As in 'iterateParallel', the
+  |    vertexes of a color class are not adjacent and are updated in parallel.
+  |
+  |  For further details see:
+  |    * Usha Nandini Raghavan, Reka Albert, Soundar Kumara: Near linear time
+  |      algorithm to detect community structures in large-scale networks.
+  |      Physical Review E 76, 036106 (2007)
+  |
+  |  Post-conditions:
+  |    * '_vertexToComm' contains the label of each vertex.
+  |
+  |________________________________________________________________________________________________@*/
+void Graph_Communities::labelPropagation() {
+  int n = _g->nVertexes();
+
+  vec<int> order;
+  vec<int> classes;
+  int nColors = colorVertexes(order, classes);
+  initThreadData();
+
+  vec<int> changed(_nThreads, 0);
+  for (int sweep = 0; sweep < LABEL_PROP_SWEEPS; sweep++) {
+    for (int t = 0; t < _nThreads; t++)
+      changed[t] = 0;
+
+    for (int c = 0; c < nColors; c++) {
+      int begin = classes[c];
+      int size = classes[c + 1] - begin;
+
+      parallelFor(size, _nThreads, [&](int b, int e, int t) {
+        changed[t] += propagateLabels(order, begin + b, begin + e, t);
+      });
+    }
+
+    int total = 0;
+    for (int t = 0; t < _nThreads; t++)
+      total += changed[t];
+    if (total <= n * LABEL_PROP_TOLERANCE)
+      break;
   }
+}
+
+// Moves each vertex in 'vertexes[begin..end)' to the heaviest label among its
+// neighbors. Ties keep the current label or take the smallest one. Returns the
+// number of vertexes that changed label.
+int Graph_Communities::propagateLabels(const vec<int> &vertexes, int begin,
+                                       int end, int thread) {
+  vec<double> &adjWeight = _threadAdjWeight[thread];
+  vec<int> &adjComm = _threadAdjComm[thread];
+  int changed = 0;
+
+  for (int k = begin; k < end; k++) {
+    int vertex = vertexes[k];
+    int comm = _vertexToComm[vertex];
+    GraphRow<int> edges = _g->vertexEdges(vertex);
+    GraphRow<float> weights = _g->vertexWeights(vertex);
+
+    adjComm.clear();
+    adjComm.push(comm);
+    adjWeight[comm] = 0.0;
+    for (int i = 0; i < edges.size(); i++) {
+      int u = edges[i];
+      if (u == vertex)
+        continue;
+
+      int c = _vertexToComm[u];
+      if (adjWeight[c] < 0) {
+        adjWeight[c] = 0.0;
+        adjComm.push(c);
+      }
+      adjWeight[c] += weights[i];
+    }
 
-  g2->mergeDuplicatedEdges();
+    int best_comm = comm;
+    double best_weight = adjWeight[comm];
+    for (int i = 1; i < adjComm.size(); i++) {
+      int c = adjComm[i];
+      if (adjWeight[c] > best_weight ||
+          (adjWeight[c] == best_weight && best_comm != comm && c < best_comm)) {
+        best_comm = c;
+        best_weight = adjWeight[c];
+      }
+    }
+
+    for (int i = 0; i < adjComm.size(); i++)
+      adjWeight[adjComm[i]] = -1.0;
+
+    if (best_comm != comm) {
+      _vertexToComm[vertex] = best_comm;
+      changed++;
+    }
+  }
 
-  return g2;
+  return changed;
 }
 
 void Graph_Communities::resetInternalData() {
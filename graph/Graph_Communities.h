@@ -48,13 +48,19 @@ public:
 
   int findCommunities(int mode, Graph *g);
 
+  // Number of threads used by the unfolding method (1 = sequential).
+  void setThreads(int n) { _nThreads = n > 0 ? n : 1; }
+  int getThreads() { return _nThreads; }
+
   // Valid after findCommunities is called.
   inline int nCommunities() { return _nCommunities; }
   inline int vertexCommunity(int u) { return _vertexCommunity[u]; }
   inline double getModularity() { return _modularity; }
 
-  inline const vec<int> &adjCommunities(int c) { return _g->vertexEdges(c); }
-  inline const vec<double> &adjCommunityWeights(int c) {
+  // The community graph only exists after 'findCommunities'.
+  inline bool hasCommunityGraph() { return _g != NULL; }
+  inline GraphRow<int> adjCommunities(int c) { return _g->vertexEdges(c); }
+  inline GraphRow<float> adjCommunityWeights(int c) {
     return _g->vertexWeights(c);
   }
 
@@ -71,7 +77,18 @@ protected:
   void remove(int node, int comm, double dnodecomm);
   void insert(int node, int comm, double dnodecomm);
 
+  // Unfolding method - Multi-threaded
+  bool iterateParallel();
+  Graph *nextIterationGraphParallel();
+  void renumberCommunities();
+  int colorVertexes(vec<int> &order, vec<int> &classes);
+  void bestMoves(const vec<int> &vertexes, int begin, int end, int thread);
+
   // Label propagation method
+  void labelPropagation();
+  int propagateLabels(const vec<int> &vertexes, int begin, int end,
+                      int thread);
+  void initThreadData();
 
 protected:
   int _nCommunities;
@@ -94,6 +111,14 @@ protected:
 
   vec<int> _renumber;
 
+  // Unfolding method - Multi-threaded
+  int _nThreads;
+  vec<int> _bestComm;      // community chosen for each vertex in a sweep
+  vec<double> _bestWeight; // weight of the edges to the chosen community
+  vec<double> _oldWeight;  // weight of the edges to the current community
+  vec<vec<double>> _threadAdjWeight; // per-thread version of '_adjWeight'
+  vec<vec<int>> _threadAdjComm;      // per-thread version of '_adjComm'
+
   // Label propagation method
 };
 
@@ -0,0 +1,73 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef IPASIR_h
+#define IPASIR_h
+
+#include <stdint.h>
+
+namespace openwbo {
+
+/*! Entry points of a SAT solver with the IPASIR interface.
+ *
+ * Literals are non-zero DIMACS integers and variables are created on
+ * demand. 'solve' returns 10 (satisfiable), 20 (unsatisfiable) or 0
+ * (stopped), and 'val' returns 'lit', '-lit' or 0 if the value does not
+ * matter. Any IPASIR solver can be used by filling a table with its
+ * functions.
+ *
+ * 'interrupt', 'limit' and 'phase' are extensions of IPASIR that a solver
+ * may leave NULL: 'interrupt' stops 'solve' from another thread, 'limit'
+ * sets a conflict budget for the next call and 'phase' sets the preferred
+ * polarity of a variable. 'set_terminate' may also be NULL if the solver
+ * provides 'interrupt'. */
+struct IPASIRSolver {
+  const char *(*signature)();
+  void *(*init)();
+  void (*release)(void *solver);
+  void (*add)(void *solver, int32_t lit_or_zero);
+  void (*assume)(void *solver, int32_t lit);
+  int (*solve)(void *solver);
+  int32_t (*val)(void *solver, int32_t lit);
+  int (*failed)(void *solver, int32_t lit);
+  void (*set_terminate)(void *solver, void *data, int (*terminate)(void *data));
+
+  void (*interrupt)(void *solver);
+  void (*limit)(void *solver, int64_t conflicts);
+  void (*phase)(void *solver, int32_t lit);
+};
+
+// Solvers bundled in the solvers directory. Each one is compiled in its own
+// namespace, next to the glucose 4.1 solver used by open-wbo.
+extern const IPASIRSolver ipasir_glucose40;
+extern const IPASIRSolver ipasir_minisat22;
+
+} // namespace openwbo
+
+#endif
@@ -0,0 +1,134 @@
+/*!
+ * \author Ruben Martins - ruben@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * MiniSat,  Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+ *           Copyright (c) 2007-2010, Niklas Sorensson
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef IPASIR_Minisat_h
+#define IPASIR_Minisat_h
+
+#include "IPASIR.h"
+
+#include <stdlib.h>
+
+// IPASIR functions for a solver with the API of minisat 2.2. The types of
+// the solver (Solver, Lit, vec, lbool) are taken from its namespace, which
+// is opened by the file that includes this one.
+namespace {
+
+struct Wrapper {
+  Solver solver;
+  vec<Lit> clause;       // Clause being added.
+  vec<Lit> assumptions;  // Assumptions of the next call.
+  vec<char> failed_lits; // Marks the failed assumptions (by 'toInt').
+};
+
+// Creates the variables of 'lit' that the solver does not have yet.
+Lit import(Wrapper *w, int32_t lit) {
+  int v = abs(lit) - 1;
+  while (v >= w->solver.nVars())
+    w->solver.newVar();
+  return mkLit(v, lit < 0);
+}
+
+void *wrapperInit() { return new Wrapper(); }
+
+void wrapperRelease(void *s) { delete (Wrapper *)s; }
+
+void wrapperAdd(void *s, int32_t lit) {
+  Wrapper *w = (Wrapper *)s;
+  if (lit != 0) {
+    w->clause.push(import(w, lit));
+    return;
+  }
+  // An empty clause makes the solver unsatisfiable, as in IPASIR.
+  w->solver.addClause(w->clause);
+  w->clause.clear();
+}
+
+void wrapperAssume(void *s, int32_t lit) {
+  Wrapper *w = (Wrapper *)s;
+  w->assumptions.push(import(w, lit));
+}
+
+int wrapperSolve(void *s) {
+  Wrapper *w = (Wrapper *)s;
+  for (int i = 0; i < w->solver.conflict.size(); i++)
+    w->failed_lits[toInt(~w->solver.conflict[i])] = 0;
+
+  lbool res = w->solver.solveLimited(w->assumptions);
+  w->solver.budgetOff();
+  w->assumptions.clear();
+
+  if (res == l_False) {
+    w->failed_lits.growTo(2 * w->solver.nVars(), 0);
+    for (int i = 0; i < w->solver.conflict.size(); i++)
+      w->failed_lits[toInt(~w->solver.conflict[i])] = 1;
+    return 20;
+  }
+  return res == l_True ? 10 : 0;
+}
+
+int32_t wrapperVal(void *s, int32_t lit) {
+  Wrapper *w = (Wrapper *)s;
+  int v = abs(lit) - 1;
+  if (v >= w->solver.model.size())
+    return 0;
+  lbool value = w->solver.modelValue(mkLit(v, lit < 0));
+  if (value == l_Undef)
+    return 0;
+  return value == l_True ? lit : -lit;
+}
+
+int wrapperFailed(void *s, int32_t lit) {
+  Wrapper *w = (Wrapper *)s;
+  int p = toInt(mkLit(abs(lit) - 1, lit < 0));
+  return p < w->failed_lits.size() && w->failed_lits[p];
+}
+
+void wrapperInterrupt(void *s) { ((Wrapper *)s)->solver.interrupt(); }
+
+void wrapperLimit(void *s, int64_t conflicts) {
+  ((Wrapper *)s)->solver.setConfBudget(conflicts);
+}
+
+void wrapperPhase(void *s, int32_t lit) {
+  Wrapper *w = (Wrapper *)s;
+  Lit p = import(w, lit);
+  w->solver.setPolarity(var(p), sign(p));
+}
+
+} // namespace
+
+// Table of the functions above, with 'signature' defined by the includer.
+#define IPASIR_MINISAT_TABLE(signature)                                        \
+  {                                                                            \
+    signature, wrapperInit, wrapperRelease, wrapperAdd, wrapperAssume,         \
+        wrapperSolve, wrapperVal, wrapperFailed, NULL, wrapperInterrupt,       \
+        wrapperLimit, wrapperPhase                                             \
+  }
+
+#endif
@@ -149,6 +149,8 @@ public:
     void    setConfBudget(int64_t x);
     void    setPropBudget(int64_t x);
     void    budgetOff();
+    void    getBudget(int64_t& conf, int64_t& prop) const; // Current absolute budgets (-1 means no budget).
+    void    setBudget(int64_t conf, int64_t prop);         // Restores budgets returned by 'getBudget'.
     void    interrupt();          // Trigger a (potentially asynchronous) interruption of the solver.
     void    clearInterrupt();     // Clear interrupt indicator flag.
 
@@ -494,6 +496,8 @@ inline void     Solver::setPropBudget(int64_t x){ propagation_budget = propagati
 inline void     Solver::interrupt(){ asynch_interrupt = true; }
 inline void     Solver::clearInterrupt(){ asynch_interrupt = false; }
 inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; }
+inline void     Solver::getBudget(int64_t& conf, int64_t& prop) const { conf = conflict_budget; prop = propagation_budget; }
+inline void     Solver::setBudget(int64_t conf, int64_t prop){ conflict_budget = conf; propagation_budget = prop; }
 inline bool     Solver::withinBudget() const {
     return !asynch_interrupt &&
            (conflict_budget    < 0 || conflicts < (uint64_t)conflict_budget) &&
@@ -180,6 +180,8 @@ verbosity(0)
 , order_heap(VarOrderLt(activity))
 , progress_estimate(0)
 , remove_satisfied(true)
+, card_conflict(CRef_Undef)
+, n_card(0)
 ,lastLearntClause(CRef_Undef)
 // Resource constraints:
 //
@@ -265,12 +267,14 @@ Solver::Solver(const Solver &s) :
 , order_heap(VarOrderLt(activity))
 , progress_estimate(s.progress_estimate)
 , remove_satisfied(s.remove_satisfied)
+, card_conflict(CRef_Undef)
+, n_card(s.n_card)
 ,lastLearntClause(CRef_Undef)
 // Resource constraints:
 //
 , conflict_budget(s.conflict_budget)
 , propagation_budget(s.propagation_budget)
-, asynch_interrupt(s.asynch_interrupt)
+, asynch_interrupt(s.asynch_interrupt.load())
 , incremental(s.incremental)
 , nbVarsInitialFormula(s.nbVarsInitialFormula)
 , totalTime4Sat(s.totalTime4Sat)
@@ -311,6 +315,24 @@ Solver::Solver(const Solver &s) :
     s.trailQueue.copyTo(trailQueue);
     s.forceUNSAT.copyTo(forceUNSAT);
     s.stats.copyTo(stats);
+
+    // Copy the cardinality constraints.
+    card_lits.growTo(s.card_lits.size());
+    card_true.growTo(s.card_true.size());
+    for(int i = 0; i < s.card_lits.size(); i++) {
+        s.card_lits[i].copyTo(card_lits[i]);
+        s.card_true[i].copyTo(card_true[i]);
+    }
+    s.card_bound.copyTo(card_bound);
+    s.card_guard.copyTo(card_guard);
+    card_occurs.growTo(s.card_occurs.size());
+    card_guarded.growTo(s.card_guarded.size());
+    for(int i = 0; i < s.card_occurs.size(); i++) {
+        s.card_occurs[i].copyTo(card_occurs[i]);
+        s.card_guarded[i].copyTo(card_guarded[i]);
+    }
+    s.card_reason.copyTo(card_reason);
+    s.propagated.copyTo(propagated);
 }
 
 
@@ -387,6 +409,12 @@ Var Solver::newVar(bool sign, bool dvar) {
     polarity.push(sign);
     fixed_polarity.push(false);
     forceUNSAT.push(0);
+    card_occurs.push();
+    card_occurs.push();
+    card_guarded.push();
+    card_guarded.push();
+    card_reason.push(-1);
+    propagated.push(0);
     decision.push();
     trail.capacity(v + 1);
     setDecisionVar(v, dvar);
@@ -462,6 +490,241 @@ bool Solver::addClause_(vec <Lit> &ps) {
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  addAtMost : (ps : const vec<Lit>&) (k : int) (guard : Lit)  ->  [int]
+|  
+|  Description:
+|    Adds the native cardinality constraint 'sum(ps) <= k'. If 'guard' is defined, the constraint
+|    is only enforced when 'guard' is true. Literals are counted by 'propagate' when they become
+|    true; once 'k' of them are true, the other ones are propagated to false.
+|________________________________________________________________________________________________@*/
+int Solver::addAtMost(const vec<Lit> &ps, int k, Lit guard) {
+    assert(decisionLevel() == 0);
+    assert(k >= 0);
+    if(!ok) return -1;
+
+    int c = card_lits.size();
+    card_lits.push();
+    ps.copyTo(card_lits[c]);
+    card_bound.push(k);
+    card_guard.push(guard);
+    card_true.push();
+    n_card++;
+
+    for(int i = 0; i < ps.size(); i++) {
+        card_occurs[toInt(ps[i])].push(c);
+        // Literals that are still in the propagation queue are counted by 'propagate'.
+        if(value(ps[i]) == l_True && propagated[var(ps[i])])
+            card_true[c].push(ps[i]);
+    }
+    if(guard != lit_Undef)
+        card_guarded[toInt(guard)].push(c);
+
+    if(!propagateCard(c) || propagate() != CRef_Undef) {
+        ok = false;
+        return -1;
+    }
+    return c;
+}
+
+
+bool Solver::tightenAtMost(int c, int k) {
+    assert(decisionLevel() == 0);
+    assert(card_bound[c] >= 0 && k >= 0 && k <= card_bound[c]);
+    if(!ok) return false;
+
+    card_bound[c] = k;
+    return ok = (propagateCard(c) && propagate() == CRef_Undef);
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  updateAtMost : (c : int) (ps : const vec<Lit>&) (k : int)  ->  [bool]
+|  
+|  Description:
+|    Turns the guarded constraint 'c' into 'sum(ps) <= k', keeping its guard. Every learnt clause
+|    derived from 'c' contains the negation of the guard, so removing those clauses is enough to
+|    drop what was implied by the old constraint. Fails if the guard is assigned at level 0, since
+|    such an assignment may depend on the old constraint.
+|________________________________________________________________________________________________@*/
+bool Solver::updateAtMost(int c, const vec<Lit> &ps, int k) {
+    assert(decisionLevel() == 0);
+    assert(card_bound[c] >= 0 && k >= 0);
+    Lit guard = card_guard[c];
+    assert(guard != lit_Undef);
+    if(value(guard) != l_Undef)
+        return false;
+
+    for(int i = 0; i < card_lits[c].size(); i++)
+        card_occurs[toInt(card_lits[c][i])].remove(c);
+    ps.copyTo(card_lits[c]);
+    card_bound[c] = k;
+    card_true[c].clear();
+    for(int i = 0; i < ps.size(); i++) {
+        card_occurs[toInt(ps[i])].push(c);
+        if(value(ps[i]) == l_True && propagated[var(ps[i])])
+            card_true[c].push(ps[i]);
+    }
+
+    removeGuarded(learnts, guard);
+    removeGuarded(permanentLearnts, guard);
+    removeGuarded(unaryWatchedClauses, guard);
+    checkGarbage();
+    return true;
+}
+
+
+void Solver::removeGuarded(vec<CRef> &cs, Lit guard) {
+    int i, j;
+    for(i = j = 0; i < cs.size(); i++) {
+        Clause &c = ca[cs[i]];
+        int l = 0;
+        while(l < c.size() && c[l] != ~guard)
+            l++;
+        if(l == c.size())
+            cs[j++] = cs[i];
+        else
+            removeClause(cs[i], c.getOneWatched());
+    }
+    cs.shrink(i - j);
+}
+
+
+void Solver::removeAtMost(int c) {
+    assert(decisionLevel() == 0);
+    assert(card_bound[c] >= 0);
+
+    for(int i = 0; i < card_lits[c].size(); i++)
+        card_occurs[toInt(card_lits[c][i])].remove(c);
+    if(card_guard[c] != lit_Undef)
+        card_guarded[toInt(card_guard[c])].remove(c);
+
+    card_lits[c].clear(true);
+    card_true[c].clear(true);
+    card_bound[c] = -1;
+    n_card--;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  exportLearnts : (out : vec<vec<Lit> >&) (max_lbd : unsigned int) (n : Var)  ->  [void]
+|  
+|  Description:
+|    Copies the units of the top level and the learnt clauses with lbd at most 'max_lbd' that only
+|    contain variables smaller than 'n'. The clauses are implied by the clauses of this solver.
+|________________________________________________________________________________________________@*/
+void Solver::exportLearnts(vec<vec<Lit> >& out, unsigned int max_lbd, Var n) {
+    assert(decisionLevel() == 0);
+
+    for(int i = 0; i < trail.size(); i++) {
+        if(var(trail[i]) < n) {
+            out.push();
+            out.last().push(trail[i]);
+        }
+    }
+
+    for(int k = 0; k < 2; k++) {
+        vec<CRef>& db = k == 0 ? permanentLearnts : learnts;
+        for(int i = 0; i < db.size(); i++) {
+            Clause& c = ca[db[i]];
+            if(c.mark() != 0 || c.lbd() > max_lbd)
+                continue;
+
+            int j = 0;
+            while(j < c.size() && var(c[j]) < n)
+                j++;
+            if(j < c.size())
+                continue;
+
+            out.push();
+            for(j = 0; j < c.size(); j++)
+                out.last().push(c[j]);
+        }
+    }
+}
+
+
+void Solver::exportHeuristic(vec<double>& act, vec<char>& phase, Var n) const {
+    if(n > nVars()) n = nVars();
+
+    double max_act = 0;
+    for(Var v = 0; v < n; v++)
+        if(activity[v] > max_act) max_act = activity[v];
+
+    act.clear();
+    phase.clear();
+    for(Var v = 0; v < n; v++) {
+        act.push(max_act > 0 ? activity[v] / max_act : 0);
+        phase.push(polarity[v]);
+    }
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  importHeuristic : (act : const vec<double>&) (phase : const vec<char>&)  ->  [void]
+|  
+|  Description:
+|    Merges the activities and phases exported by another solver. Activities are compared after
+|    scaling both sides to [0,1]; a variable that was more active in the other solver gets its
+|    scaled activity and its saved phase, unless its polarity was fixed by the user.
+|________________________________________________________________________________________________@*/
+void Solver::importHeuristic(const vec<double>& act, const vec<char>& phase) {
+    assert(decisionLevel() == 0);
+    int n = act.size() < nVars() ? act.size() : nVars();
+
+    double max_act = 0;
+    for(Var v = 0; v < nVars(); v++)
+        if(activity[v] > max_act) max_act = activity[v];
+    // A solver that did not search yet uses the next bump as its scale.
+    double scale = max_act > 0 ? max_act : var_inc;
+
+    for(Var v = 0; v < n; v++) {
+        if(act[v] * scale <= activity[v])
+            continue;
+        activity[v] = act[v] * scale;
+        if(!fixed_polarity[v])
+            polarity[v] = phase[v];
+        if(order_heap.inHeap(v))
+            order_heap.decrease(v);
+    }
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  cardClause : (c : int) (p : Lit)  ->  [CRef]
+|  
+|  Description:
+|    Builds the clause that explains why constraint 'c' implied 'p', or the conflict of 'c' if
+|    'p' is lit_Undef. The clause is not attached and the implied literal (if any) is first.
+|________________________________________________________________________________________________@*/
+CRef Solver::cardClause(int c, Lit p) {
+    card_tmp.clear();
+    if(p != lit_Undef)
+        card_tmp.push(p);
+    if(card_guard[c] != lit_Undef)
+        card_tmp.push(~card_guard[c]);
+
+    // The first 'k' true literals implied 'p', and the first 'k+1' ones are in conflict.
+    int n = p != lit_Undef ? card_bound[c] : card_bound[c] + 1;
+    assert(card_true[c].size() >= n);
+    for(int i = 0; i < n; i++)
+        card_tmp.push(~card_true[c][i]);
+
+    return ca.alloc(card_tmp, false);
+}
+
+
+void Solver::freeCardClause(CRef cr) {
+    ca[cr].mark(1);
+    ca.free(cr);
+}
+
+
 void Solver::attachClause(CRef cr) {
     const Clause &c = ca[cr];
 
@@ -661,6 +924,19 @@ void Solver::cancelUntil(int level) {
     if(decisionLevel() > level) {
         for(int c = trail.size() - 1; c >= trail_lim[level]; c--) {
             Var x = var(trail[c]);
+            if(propagated[x]) {
+                propagated[x] = 0;
+                vec<int> &cs = card_occurs[toInt(trail[c])];
+                for(int i = 0; i < cs.size(); i++) {
+                    assert(card_true[cs[i]].last() == trail[c]);
+                    card_true[cs[i]].pop();
+                }
+            }
+            if(card_reason[x] != -1) {
+                if(vardata[x].reason != CRef_Card)
+                    freeCardClause(vardata[x].reason);
+                card_reason[x] = -1;
+            }
             assigns[x] = l_Undef;
             if(phase_saving > 1 || ((phase_saving == 1) && c > trail_lim.last())) {
                 if (!fixed_polarity[x])
@@ -671,6 +947,11 @@ void Solver::cancelUntil(int level) {
         qhead = trail_lim[level];
         trail.shrink(trail.size() - trail_lim[level]);
         trail_lim.shrink(trail_lim.size() - level);
+
+        if(card_conflict != CRef_Undef) {
+            freeCardClause(card_conflict);
+            card_conflict = CRef_Undef;
+        }
     }
 }
 
@@ -804,7 +1085,7 @@ void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, in
                     if(level(var(q)) >= decisionLevel()) {
                         pathC++;
                         // UPDATEVARACTIVITY trick (see competition'09 companion paper)
-                        if(!isSelector(var(q)) && (reason(var(q)) != CRef_Undef) && ca[reason(var(q))].learnt())
+                        if(!isSelector(var(q)) && (reason(var(q)) != CRef_Undef) && (reason(var(q)) != CRef_Card) && ca[reason(var(q))].learnt())
                             lastDecisionLevel.push(q);
                     } else {
                         if(isSelector(var(q))) {
@@ -821,7 +1102,7 @@ void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, in
         while (!seen[var(trail[index--])]);
         p = trail[index + 1];
         //stats[sumRes]++;
-        confl = reason(var(p));
+        confl = reasonClause(var(p));
         seen[var(p)] = 0;
         pathC--;
 
@@ -852,7 +1133,7 @@ void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, in
             if(reason(x) == CRef_Undef)
                 out_learnt[j++] = out_learnt[i];
             else {
-                Clause &c = ca[reason(var(out_learnt[i]))];
+                Clause &c = ca[reasonClause(var(out_learnt[i]))];
                 // Thanks to Siert Wieringa for this bug fix!
                 for(int k = ((c.size() == 2) ? 0 : 1); k < c.size(); k++)
                     if(!seen[var(c[k])] && level(var(c[k])) > 0) {
@@ -932,7 +1213,7 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels) {
     int top = analyze_toclear.size();
     while(analyze_stack.size() > 0) {
         assert(reason(var(analyze_stack.last())) != CRef_Undef);
-        Clause &c = ca[reason(var(analyze_stack.last()))];
+        Clause &c = ca[reasonClause(var(analyze_stack.last()))];
         analyze_stack.pop(); //
         if(c.size() == 2 && value(c[0]) == l_False) {
             assert(value(c[1]) == l_True);
@@ -988,7 +1269,7 @@ void Solver::analyzeFinal(Lit p, vec <Lit> &out_conflict) {
                 assert(level(x) > 0);
                 out_conflict.push(~trail[i]);
             } else {
-                Clause &c = ca[reason(x)];
+                Clause &c = ca[reasonClause(x)];
                 //                for (int j = 1; j < c.size(); j++) Minisat (glucose 2.0) loop
                 // Bug in case of assumptions due to special data structures for Binary.
                 // Many thanks to Sam Bayless (sbayless@cs.ubc.ca) for discover this bug.
@@ -1042,6 +1323,16 @@ CRef Solver::propagate() {
         Watcher *i, *j, *end;
         num_props++;
 
+        // Native cardinality constraints
+        propagated[var(p)] = 1;
+        if(card_occurs[toInt(p)].size() > 0 || card_guarded[toInt(p)].size() > 0) {
+            confl = propagateCard(p);
+            if(confl != CRef_Undef) {
+                qhead = trail.size();
+                break;
+            }
+        }
+
 
         // First, Propagate binary clauses
         vec <Watcher> &wbin = watchesBin[p];
@@ -1155,6 +1446,63 @@ CRef Solver::propagate() {
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  propagateCard : [Lit]  ->  [Clause*]
+|  
+|  Description:
+|    Counts the true literal 'p' in the cardinality constraints that contain it and propagates
+|    them, as well as the constraints guarded by 'p'. 'p' is counted in every constraint even if a
+|    conflict is found, so that 'cancelUntil' can uncount it. Returns the conflict clause, if any,
+|    otherwise CRef_Undef.
+|________________________________________________________________________________________________@*/
+CRef Solver::propagateCard(Lit p) {
+    int confl = -1;
+
+    vec<int> &cs = card_occurs[toInt(p)];
+    for(int i = 0; i < cs.size(); i++) {
+        card_true[cs[i]].push(p);
+        if(confl == -1 && !propagateCard(cs[i]))
+            confl = cs[i];
+    }
+
+    vec<int> &gs = card_guarded[toInt(p)];
+    for(int i = 0; i < gs.size() && confl == -1; i++)
+        if(!propagateCard(gs[i]))
+            confl = gs[i];
+
+    if(confl == -1)
+        return CRef_Undef;
+
+    // A conflict found at level 0 is never analyzed nor freed by 'cancelUntil'.
+    if(card_conflict != CRef_Undef)
+        freeCardClause(card_conflict);
+    card_conflict = cardClause(confl, lit_Undef);
+    return card_conflict;
+}
+
+
+bool Solver::propagateCard(int c) {
+    Lit guard = card_guard[c];
+    if(guard != lit_Undef && value(guard) != l_True)
+        return true;
+
+    int n = card_true[c].size();
+    if(n < card_bound[c])
+        return true;
+    if(n > card_bound[c])
+        return false;
+
+    vec<Lit> &lits = card_lits[c];
+    for(int i = 0; i < lits.size(); i++)
+        if(value(lits[i]) == l_Undef) {
+            uncheckedEnqueue(~lits[i], CRef_Card);
+            card_reason[var(lits[i])] = c;
+        }
+    return true;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  propagateUnaryWatches : [Lit]  ->  [Clause*]
@@ -1590,7 +1938,8 @@ lbool Solver::search(int nof_conflicts) {
 
         } else {
             // Our dynamic restart, see the SAT09 competition compagnion paper
-            if((luby_restart && nof_conflicts <= conflictC) ||
+            // (an asynchronous interruption also forces a restart)
+            if(asynch_interrupt || (luby_restart && nof_conflicts <= conflictC) ||
                (!luby_restart && (lbdQueue.isvalid() && ((lbdQueue.getavg() * K) > (sumLBD / conflictsRestarts))))) {
                 lbdQueue.fastclear();
                 progress_estimate = progressEstimate();
@@ -1949,10 +2298,16 @@ void Solver::relocAll(ClauseAllocator &to) {
     for(int i = 0; i < trail.size(); i++) {
         Var v = var(trail[i]);
 
-        if(reason(v) != CRef_Undef && (ca[reason(v)].reloced() || locked(ca[reason(v)])))
+        if(reason(v) == CRef_Card)
+            continue;
+        // Reasons built by 'cardClause' are not attached, but are still used.
+        if(reason(v) != CRef_Undef && (card_reason[v] != -1 || ca[reason(v)].reloced() || locked(ca[reason(v)])))
             ca.reloc(vardata[v].reason, to);
     }
 
+    if(card_conflict != CRef_Undef)
+        ca.reloc(card_conflict, to);
+
     // All learnt:
     //
     for(int i = 0; i < learnts.size(); i++)
@@ -59,6 +59,15 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "mtl/Clone.h"
 #include "core/SolverStats.h"
 
+#include <atomic>
+
+// Open-WBO: the solver supports native cardinality constraints ('addAtMost').
+#define NATIVE_CARDINALITY
+// Open-WBO: the search state can be copied between solvers ('exportLearnts').
+#define SEARCH_STATE_TRANSFER
+// Open-WBO: learnt clauses can be exchanged by overriding the 'parallel*' hooks.
+#define CLAUSE_SHARING
+
 
 namespace Glucose {
 // Core stats 
@@ -124,6 +133,27 @@ public:
     bool    addClause (Lit p, Lit q, Lit r);                    // Add a ternary clause to the solver. 
     virtual bool    addClause_(      vec<Lit>& ps);                     // Add a clause to the solver without making superflous internal copy. Will
                                                                 // change the passed vector 'ps'.
+
+    // Native cardinality constraints (Open-WBO). Must be called at decision level 0:
+    //
+    virtual int  addAtMost    (const vec<Lit>& ps, int k, Lit guard = lit_Undef); // Add 'sum(ps) <= k', enforced only when 'guard' is true (always if
+                                                                // undefined). Returns the index of the constraint, or -1 if the solver
+                                                                // is in a conflicting state.
+    virtual bool tightenAtMost(int c, int k);                   // Decrease the bound of constraint 'c' to 'k'.
+    virtual bool updateAtMost (int c, const vec<Lit>& ps, int k); // Replace the literals of guarded constraint 'c' by 'ps' and its bound by
+                                                                // 'k', removing the learnt clauses that depend on it. Returns false
+                                                                // (and does nothing) if its guard is assigned at level 0.
+    virtual void removeAtMost (int c);                          // Remove constraint 'c'.
+    int     nAtMost      ()      const;                         // The current number of cardinality constraints.
+
+    // Search state transfer (Open-WBO). Must be called at decision level 0:
+    //
+    void    exportLearnts  (vec<vec<Lit> >& out, unsigned int max_lbd, Var n); // Add to 'out' the units and the learnt clauses with lbd <= 'max_lbd'
+                                                                // whose variables are smaller than 'n'.
+    void    exportHeuristic(vec<double>& act, vec<char>& phase, Var n) const; // Activities (scaled to [0,1]) and saved phases of the variables
+                                                                // smaller than 'n'.
+    void    importHeuristic(const vec<double>& act, const vec<char>& phase); // Raise the scaled activity of each variable to 'act' and take its
+                                                                // phase from 'phase' when 'act' is higher.
     // Solving:
     //
     bool    simplify     ();                        // Removes already satisfied clauses.
@@ -178,6 +208,8 @@ public:
     void    setConfBudget(int64_t x);
     void    setPropBudget(int64_t x);
     void    budgetOff();
+    void    getBudget(int64_t& conf, int64_t& prop) const; // Current absolute budgets (-1 means no budget).
+    void    setBudget(int64_t conf, int64_t prop);         // Restores budgets returned by 'getBudget'.
     void    interrupt();          // Trigger a (potentially asynchronous) interruption of the solver.
     void    clearInterrupt();     // Clear interrupt indicator flag.
 
@@ -357,6 +389,21 @@ protected:
     // UPDATEVARACTIVITY trick (see competition'09 companion paper)
     vec<Lit> lastDecisionLevel; 
 
+    // Native cardinality constraints (counter based). The reasons of the literals they imply are
+    // only built as clauses when conflict analysis needs them.
+    //
+    vec<vec<Lit> >      card_lits;        // Literals of each at-most-k constraint.
+    vec<int>            card_bound;       // Bound of each constraint (-1 if removed).
+    vec<Lit>            card_guard;       // Guard of each constraint (lit_Undef if always enforced).
+    vec<vec<Lit> >      card_true;        // True literals of each constraint, in the order they were propagated.
+    vec<vec<int> >      card_occurs;      // 'card_occurs[lit]' lists the constraints that contain 'lit'.
+    vec<vec<int> >      card_guarded;     // 'card_guarded[lit]' lists the constraints guarded by 'lit'.
+    vec<int>            card_reason;      // Constraint that implied each variable (-1 if none).
+    vec<char>           propagated;       // Set if the literal of the variable on the trail has been propagated.
+    CRef                card_conflict;    // Conflict clause built from a constraint (freed when backtracking).
+    vec<Lit>            card_tmp;         // Literals of the clauses built by 'cardClause'.
+    int                 n_card;           // Number of constraints that have not been removed.
+
     ClauseAllocator     ca;
 
     int nbclausesbeforereduce;            // To know when it is time to reduce clause database
@@ -386,7 +433,7 @@ protected:
     //
     int64_t             conflict_budget;    // -1 means no budget.
     int64_t             propagation_budget; // -1 means no budget.
-    bool                asynch_interrupt;
+    std::atomic<bool>   asynch_interrupt; // May be set from another thread.
 
     // Variables added for incremental mode
     int incremental; // Use incremental SAT Solver
@@ -405,6 +452,11 @@ protected:
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
     CRef     propagateUnaryWatches(Lit p);                                                  // Perform propagation on unary watches of p, can find only conflicts
+    void     removeGuarded    (vec<CRef>& cs, Lit guard);                              // Remove the clauses of 'cs' that contain '~guard'.
+    CRef     propagateCard    (Lit p);                                                 // Count 'p' in its cardinality constraints and propagate them.
+    bool     propagateCard    (int c);                                                 // Propagate constraint 'c' if its bound is reached. FALSE on conflict.
+    CRef     cardClause       (int c, Lit p);                                          // Build the reason of 'p' (the conflict if lit_Undef) from constraint 'c'.
+    void     freeCardClause   (CRef cr);                                               // Free a clause built by 'cardClause'.
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
     void     analyze          (CRef confl, vec<Lit>& out_learnt, vec<Lit> & selectors, int& out_btlevel,unsigned int &nblevels,unsigned int &szWithoutSelectors);    // (bt = backtrack)
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
@@ -445,6 +497,7 @@ protected:
     int      decisionLevel    ()      const; // Gives the current decisionlevel.
     uint32_t abstractLevel    (Var x) const; // Used to represent an abstraction of sets of decision levels.
     CRef     reason           (Var x) const;
+    CRef     reasonClause     (Var x);               // Like 'reason', but builds the lazy reasons of cardinality constraints.
     int      level            (Var x) const;
     double   progressEstimate ()      const; // DELETE THIS ?? IT'S NOT VERY USEFUL ...
     bool     withinBudget     ()      const;
@@ -470,6 +523,10 @@ protected:
 // Implementation of inline methods:
 
 inline CRef Solver::reason(Var x) const { return vardata[x].reason; }
+inline CRef Solver::reasonClause(Var x) {
+    if (vardata[x].reason == CRef_Card)
+        vardata[x].reason = cardClause(card_reason[x], mkLit(x, value(x) == l_False));
+    return vardata[x].reason; }
 inline int  Solver::level (Var x) const { return vardata[x].level; }
 
 inline void Solver::insertVarOrder(Var x) {
@@ -510,11 +567,11 @@ inline bool     Solver::addClause       (Lit p, Lit q)          { add_tmp.clear(
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
  inline bool     Solver::locked          (const Clause& c) const { 
    if(c.size()>2) 
-     return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c; 
+     return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && reason(var(c[0])) != CRef_Card && ca.lea(reason(var(c[0]))) == &c; 
    return 
-     (value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c)
+     (value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && reason(var(c[0])) != CRef_Card && ca.lea(reason(var(c[0]))) == &c)
      || 
-     (value(c[1]) == l_True && reason(var(c[1])) != CRef_Undef && ca.lea(reason(var(c[1]))) == &c);
+     (value(c[1]) == l_True && reason(var(c[1])) != CRef_Undef && reason(var(c[1])) != CRef_Card && ca.lea(reason(var(c[1]))) == &c);
  }
 inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
 
@@ -526,6 +583,7 @@ inline lbool    Solver::modelValue    (Var x) const   { return model[x]; }
 inline lbool    Solver::modelValue    (Lit p) const   { return model[var(p)] ^ sign(p); }
 inline int      Solver::nAssigns      ()      const   { return trail.size(); }
 inline int      Solver::nClauses      ()      const   { return clauses.size(); }
+inline int      Solver::nAtMost       ()      const   { return n_card; }
 inline int      Solver::nLearnts      ()      const   { return learnts.size(); }
 inline int      Solver::nVars         ()      const   { return vardata.size(); }
 inline int      Solver::nFreeVars     ()         { 
@@ -545,6 +603,8 @@ inline void     Solver::setPropBudget(int64_t x){ propagation_budget = propagati
 inline void     Solver::interrupt(){ asynch_interrupt = true; }
 inline void     Solver::clearInterrupt(){ asynch_interrupt = false; }
 inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; }
+inline void     Solver::getBudget(int64_t& conf, int64_t& prop) const { conf = conflict_budget; prop = propagation_budget; }
+inline void     Solver::setBudget(int64_t conf, int64_t prop){ conflict_budget = conf; propagation_budget = prop; }
 inline bool     Solver::withinBudget() const {
     return !asynch_interrupt &&
            (conflict_budget    < 0 || conflicts < (uint64_t)conflict_budget) &&
@@ -54,6 +54,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <assert.h>
 #include <stdint.h>
 #include <pthread.h>
+#include <vector>
 
 #include "mtl/IntTypes.h"
 #include "mtl/Alg.h"
@@ -277,6 +278,7 @@ public:
 
 
     const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
+    const CRef CRef_Card  = CRef_Undef - 1; // Lazy reason of a native cardinality constraint (Open-WBO).
     class ClauseAllocator : public RegionAllocator<uint32_t>
     {
         static int clauseWord32Size(int size, int extra_size){
@@ -353,11 +355,13 @@ public:
 
 //=================================================================================================
 // OccLists -- a class for maintaining occurence lists with lazy deletion:
+//
+// NOTE: the lists are kept in a 'std::vector', since 'vec' would move them with realloc.
 
 template<class Idx, class Vec, class Deleted>
 class OccLists
 {
-    vec<Vec>  occs;
+    std::vector<Vec> occs;
     vec<char> dirty;
     vec<Idx>  dirties;
     Deleted   deleted;
@@ -365,7 +369,7 @@ class OccLists
  public:
     OccLists(const Deleted& d) : deleted(d) {}
     
-    void  init      (const Idx& idx){ occs.growTo(toInt(idx)+1); dirty.growTo(toInt(idx)+1, 0); }
+    void  init      (const Idx& idx){ if ((int)occs.size() <= toInt(idx)) occs.resize(toInt(idx)+1); dirty.growTo(toInt(idx)+1, 0); }
     // Vec&  operator[](const Idx& idx){ return occs[toInt(idx)]; }
     Vec&  operator[](const Idx& idx){ return occs[toInt(idx)]; }
     Vec&  lookup    (const Idx& idx){ if (dirty[toInt(idx)]) clean(idx); return occs[toInt(idx)]; }
@@ -373,8 +377,8 @@ class OccLists
     void  cleanAll  ();
     void copyTo(OccLists &copy) const {
 	
-	copy.occs.growTo(occs.size());
-	for(int i = 0;i<occs.size();i++)
+	if (copy.occs.size() < occs.size()) copy.occs.resize(occs.size());
+	for(int i = 0;i<(int)occs.size();i++)
 	    occs[i].memCopyTo(copy.occs[i]);
 	dirty.memCopyTo(copy.dirty);
 	dirties.memCopyTo(copy.dirties);
@@ -389,7 +393,8 @@ class OccLists
     }
 
     void  clear(bool free = true){
-        occs   .clear(free);
+        occs   .clear();
+        if (free) occs.shrink_to_fit();
         dirty  .clear(free);
         dirties.clear(free);
     }
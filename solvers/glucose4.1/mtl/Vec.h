@@ -55,6 +55,7 @@ public:
     vec()                       : data(NULL) , sz(0)   , cap(0)    { }
     explicit vec(int size)      : data(NULL) , sz(0)   , cap(0)    { growTo(size); }
     vec(int size, const T& pad) : data(NULL) , sz(0)   , cap(0)    { growTo(size, pad); }
+    vec(vec<T>&& other) noexcept : data(NULL) , sz(0)  , cap(0)    { other.moveTo(*this); } // Lets standard containers hold vectors.
    ~vec()                                                          { clear(true); }
 
     // Pointer to first element: